@@ -15,6 +15,7 @@
 
 #include "format.hpp"
 #include "dataset_info.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -36,6 +37,16 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * CSV and raw ASCII files are parsed by LoadCSV, which parses the lines in
+ * parallel and writes them straight into their final (possibly transposed)
+ * layout; blank lines are skipped, empty fields are read as 0, and lines with
+ * fewer fields than the longest line are padded with zeros.
+ *
+ * mlpack's mappable binary format, denoted by .mbin, is supported too.  Those
+ * files are already stored in mlpack's column-major layout, so they are copied
+ * straight into the matrix and never transposed.  To use the file without
+ * copying it at all, load it into a MappedMatrix instead.
+ *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
@@ -59,6 +70,25 @@ bool Load(const std::string& filename,
           const bool fatal = false,
           const bool transpose = true);
 
+/**
+ * Memory-maps a matrix stored in mlpack's mappable binary format (denoted by
+ * .mbin; see MappedMatrix).  The matrix uses the mapped file as its memory, so
+ * it is neither copied nor transposed, and the data is only read from disk when
+ * it is accessed.  Any previous mapping held by the MappedMatrix is released.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix cannot be mapped.
+ *
+ * @param filename Name of .mbin file to map.
+ * @param matrix MappedMatrix to map the file into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal = false);
+
 /**
  * Loads a matrix from a file, guessing the filetype from the extension and
  * mapping categorical features with a DatasetInfo object.  This will transpose
@@ -81,6 +111,10 @@ bool Load(const std::string& filename,
  * mlpack requires column-major matrices, this should be left at its default
  * value of 'true'.
  *
+ * The file is parsed by LoadCSV.  A dimension is categorical if any of its
+ * fields is not a number (an empty field is not a number); then all of its
+ * fields are mapped, in the order they appear in the file.
+ *
  * The DatasetInfo object passed to this function will be re-created, so any
  * mappings from previous loads will be lost.
  *
@@ -11,6 +11,7 @@
 #include "load_arff.hpp"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/tokenizer.hpp>
 
 namespace mlpack {
 namespace data {
@@ -0,0 +1,181 @@
+/**
+ * @file load_csv.hpp
+ *
+ * Definition of the LoadCSV class, a parallel parser for comma-separated and
+ * whitespace-separated text files.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_info.hpp"
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A parser for delimited text: CSV files, or files whose fields are separated
+ * by spaces and tabs.  The file is memory-mapped and split into line-aligned
+ * chunks, and the chunks are parsed in parallel (with OpenMP), straight into
+ * the final layout of the matrix; so no stream is involved, every number is
+ * parsed without allocating, and the matrix never has to be transposed.
+ *
+ * Each non-blank line of the file is one point (one row of the file), and
+ * lines with fewer fields than the longest line are padded with empty fields.
+ * Fields may be quoted with '"', in which case the separators inside the quotes
+ * are ignored and '\\' escapes the next character.  Whitespace around fields is
+ * ignored.
+ *
+ * Numbers are read with a fast routine that gives the same (correctly rounded)
+ * results as strtod(); "inf", "infinity" and "nan" are accepted, in any case.
+ *
+ * @code
+ * arma::mat dataset;
+ * data::DatasetInfo info;
+ * data::LoadCSV loader("dataset.csv", true);
+ * loader.Load(dataset, info, true);
+ * @endcode
+ */
+class LoadCSV
+{
+ public:
+  /**
+   * Map the given file and find its lines.  A std::runtime_error is thrown if
+   * the file cannot be opened.
+   *
+   * @param filename Name of file to parse.
+   * @param commas If true, fields are separated by commas; otherwise, by any
+   *     amount of spaces and tabs.
+   */
+  LoadCSV(const std::string& filename, const bool commas);
+
+  /**
+   * Find the lines of text that is already in memory (for instance, a chunk of
+   * a stream).  The text is not copied, so it must outlive the LoadCSV object.
+   *
+   * @param text Text to parse.
+   * @param size Length of the text, in bytes.
+   * @param commas If true, fields are separated by commas; otherwise, by any
+   *     amount of spaces and tabs.
+   */
+  LoadCSV(const char* text, const size_t size, const bool commas);
+
+  /**
+   * Parse the file as numeric data.  Empty fields are taken to be 0.  A
+   * std::runtime_error is thrown if any field is not a number.
+   *
+   * @param matrix Matrix to load the file into.
+   * @param transpose If true, each line of the file becomes a column of the
+   *     matrix; otherwise, each line becomes a row.
+   */
+  template<typename eT>
+  void Load(arma::Mat<eT>& matrix, const bool transpose);
+
+  /**
+   * Parse the file, mapping every dimension that holds a field that is not a
+   * number to categorical values with the given DatasetInfo, which is reset to
+   * the dimensionality of the data.  If a dimension is categorical, every one
+   * of its fields (including empty fields and fields that look like numbers) is
+   * mapped, in the order they appear in the file.
+   *
+   * @param matrix Matrix to load the file into.
+   * @param info DatasetInfo to store the type of each dimension and the
+   *     mappings of categorical dimensions in.
+   * @param transpose If true, each line of the file becomes a column of the
+   *     matrix (so each field is a dimension); otherwise, each line becomes a
+   *     row (so each line is a dimension).
+   */
+  template<typename eT>
+  void Load(arma::Mat<eT>& matrix, DatasetInfo& info, const bool transpose);
+
+  //! Get the number of non-blank lines in the file.
+  size_t Lines() const { return lines.size(); }
+  //! Get the number of fields in the longest line of the file.
+  size_t Fields() const { return fields; }
+
+  /**
+   * Parse the number held in the characters [begin, end), which must not
+   * include any surrounding whitespace.  Numbers with at most 19 significant
+   * digits and small exponents are converted exactly, without strtod(); any
+   * other number is handed to strtod(), so the result is always correctly
+   * rounded.
+   *
+   * @param begin First character of the number.
+   * @param end One past the last character of the number.
+   * @param value Double to store the number in.
+   * @return true if the characters are a number.
+   */
+  static bool ParseNumber(const char* begin, const char* end, double& value);
+
+ private:
+  /**
+   * Find the field that starts at the given position of a line, skipping
+   * whitespace around it.
+   *
+   * @param position Position to start at; set to the position of the next
+   *     field.
+   * @param end End of the line.
+   * @param fieldBegin Set to the first character of the field.
+   * @param fieldEnd Set to one past the last character of the field.
+   * @param quoted Set to true if the field was quoted; then [fieldBegin,
+   *     fieldEnd) is the text inside the quotes, which may hold escapes.
+   * @return true if another field follows this one.
+   */
+  bool NextField(const char*& position,
+                 const char* end,
+                 const char*& fieldBegin,
+                 const char*& fieldEnd,
+                 bool& quoted) const;
+
+  //! Get the text of a field, with any escapes of a quoted field resolved.
+  static std::string FieldString(const char* fieldBegin,
+                                 const char* fieldEnd,
+                                 const bool quoted);
+
+  //! Parse the number held in the given field.
+  static bool ParseField(const char* fieldBegin,
+                         const char* fieldEnd,
+                         const bool quoted,
+                         double& value);
+
+  /**
+   * Parse every line of the file in parallel, storing each number in the
+   * matrix, and mark the dimensions that hold a field that is not a number (or
+   * an empty field, if emptyIsZero is false).  The elements for those fields
+   * are set to 0.
+   */
+  template<typename eT>
+  void ParseLines(arma::Mat<eT>& matrix,
+                  const bool transpose,
+                  const bool emptyIsZero,
+                  std::vector<char>& nonNumeric) const;
+
+  //! Find the non-blank lines of the file, in parallel.
+  void FindLines();
+
+  //! Count the fields of each line, in parallel, and keep the largest count.
+  void CountFields();
+
+  //! The memory-mapped file, if a file is parsed.
+  MappedFile file;
+  //! The text to parse.
+  const char* text;
+  //! The length of the text, in bytes.
+  size_t size;
+  //! If true, fields are separated by commas; otherwise, by whitespace.
+  bool commas;
+  //! The offsets of the beginning and end of each non-blank line.
+  std::vector<std::pair<size_t, size_t>> lines;
+  //! The number of fields in the longest line.
+  size_t fields;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_csv_impl.hpp"
+
+#endif
@@ -0,0 +1,564 @@
+/**
+ * @file load_csv_impl.hpp
+ *
+ * Implementation of the LoadCSV class.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! Return whether the character is whitespace that surrounds a field.
+inline bool IsFieldSpace(const char c)
+{
+  return (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f');
+}
+
+//! Return whether the character is a decimal digit.
+inline bool IsDigit(const char c)
+{
+  return (c >= '0' && c <= '9');
+}
+
+//! Return whether the characters [begin, end) spell the given lowercase word,
+//! in any case.
+inline bool EqualsIgnoreCase(const char* begin,
+                             const char* end,
+                             const char* word)
+{
+  for (; begin != end; ++begin, ++word)
+  {
+    if (*word == '\0' || (*begin | 0x20) != *word)
+      return false;
+  }
+
+  return (*word == '\0');
+}
+
+} // namespace details
+
+inline LoadCSV::LoadCSV(const std::string& filename, const bool commas) :
+    file(filename),
+    text(file.Data()),
+    size(file.Size()),
+    commas(commas),
+    fields(0)
+{
+  FindLines();
+  CountFields();
+}
+
+inline LoadCSV::LoadCSV(const char* text,
+                        const size_t size,
+                        const bool commas) :
+    text(text),
+    size(size),
+    commas(commas),
+    fields(0)
+{
+  FindLines();
+  CountFields();
+}
+
+template<typename eT>
+void LoadCSV::Load(arma::Mat<eT>& matrix, const bool transpose)
+{
+  std::vector<char> nonNumeric;
+  ParseLines(matrix, transpose, true, nonNumeric);
+
+  bool anyNonNumeric = false;
+  for (size_t i = 0; i < nonNumeric.size(); ++i)
+    anyNonNumeric = anyNonNumeric || nonNumeric[i];
+  if (!anyNonNumeric)
+    return;
+
+  // Find the first field that isn't a number, so that it can be reported.
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (!transpose && !nonNumeric[i])
+      continue;
+
+    const char* position = text + lines[i].first;
+    const char* end = text + lines[i].second;
+    bool more = true;
+    while (more)
+    {
+      const char* fieldBegin;
+      const char* fieldEnd;
+      bool quoted;
+      more = NextField(position, end, fieldBegin, fieldEnd, quoted);
+
+      double value;
+      if (fieldBegin != fieldEnd &&
+          !ParseField(fieldBegin, fieldEnd, quoted, value))
+      {
+        std::ostringstream oss;
+        oss << "line " << (std::count(text, text + lines[i].first, '\n') + 1)
+            << " holds '" << FieldString(fieldBegin, fieldEnd, quoted)
+            << "', which is not a number";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+}
+
+template<typename eT>
+void LoadCSV::Load(arma::Mat<eT>& matrix,
+                   DatasetInfo& info,
+                   const bool transpose)
+{
+  std::vector<char> nonNumeric;
+  ParseLines(matrix, transpose, false, nonNumeric);
+
+  info = DatasetInfo(nonNumeric.size());
+
+  bool anyNonNumeric = false;
+  for (size_t i = 0; i < nonNumeric.size(); ++i)
+    anyNonNumeric = anyNonNumeric || nonNumeric[i];
+  if (!anyNonNumeric)
+    return;
+
+  // Now map the fields of the categorical dimensions, in the order they appear
+  // in the file, so that the mappings don't depend on how the lines were split
+  // between threads.  This has to be done serially, but it only touches the
+  // categorical dimensions.
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (!transpose && !nonNumeric[i])
+      continue;
+
+    const char* position = text + lines[i].first;
+    const char* end = text + lines[i].second;
+    bool more = true;
+    for (size_t f = 0; f < fields; ++f)
+    {
+      const char* fieldBegin = end;
+      const char* fieldEnd = end;
+      bool quoted = false;
+      if (more)
+        more = NextField(position, end, fieldBegin, fieldEnd, quoted);
+
+      // Missing fields are empty.
+      if (transpose && nonNumeric[f])
+        matrix(f, i) = (eT) info.MapString(FieldString(fieldBegin, fieldEnd,
+            quoted), f);
+      else if (!transpose)
+        matrix(i, f) = (eT) info.MapString(FieldString(fieldBegin, fieldEnd,
+            quoted), i);
+    }
+  }
+}
+
+inline bool LoadCSV::ParseNumber(const char* begin,
+                                 const char* end,
+                                 double& value)
+{
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  if (p == end)
+    return false;
+
+  if (!details::IsDigit(*p) && *p != '.')
+  {
+    if (details::EqualsIgnoreCase(p, end, "inf") ||
+        details::EqualsIgnoreCase(p, end, "infinity"))
+    {
+      value = negative ? -std::numeric_limits<double>::infinity() :
+          std::numeric_limits<double>::infinity();
+      return true;
+    }
+    else if (details::EqualsIgnoreCase(p, end, "nan"))
+    {
+      value = std::numeric_limits<double>::quiet_NaN();
+      return true;
+    }
+
+    return false;
+  }
+
+  // Collect up to 19 significant digits, which always fit in 64 bits, and the
+  // power of ten to scale them by.
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool anyDigits = false;
+  bool truncated = false;
+  for (; p != end && details::IsDigit(*p); ++p)
+  {
+    anyDigits = true;
+    if (digits < 19)
+    {
+      mantissa = 10 * mantissa + (*p - '0');
+      if (mantissa != 0)
+        ++digits;
+    }
+    else
+    {
+      ++exponent;
+      truncated = truncated || (*p != '0');
+    }
+  }
+
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && details::IsDigit(*p); ++p)
+    {
+      anyDigits = true;
+      if (digits < 19)
+      {
+        mantissa = 10 * mantissa + (*p - '0');
+        --exponent;
+        if (mantissa != 0)
+          ++digits;
+      }
+      else
+      {
+        truncated = truncated || (*p != '0');
+      }
+    }
+  }
+
+  if (!anyDigits)
+    return false;
+
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negativeExponent = false;
+    if (p != end && (*p == '+' || *p == '-'))
+    {
+      negativeExponent = (*p == '-');
+      ++p;
+    }
+
+    if (p == end || !details::IsDigit(*p))
+      return false;
+
+    int explicitExponent = 0;
+    for (; p != end && details::IsDigit(*p); ++p)
+    {
+      if (explicitExponent < 100000)
+        explicitExponent = 10 * explicitExponent + (*p - '0');
+    }
+
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+
+  if (p != end)
+    return false;
+
+  // When the mantissa and the power of ten are both exactly representable, a
+  // single multiplication or division rounds correctly (Clinger's fast path).
+  static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+      1e20, 1e21, 1e22 };
+  if (mantissa == 0)
+  {
+    value = 0.0;
+  }
+  else if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 &&
+      exponent <= 22)
+  {
+    value = (exponent < 0) ? (double) mantissa / powers[-exponent] :
+        (double) mantissa * powers[exponent];
+  }
+  else
+  {
+    // Otherwise strtod() has to do the work.  Its input is already validated.
+    const std::string number(begin, end);
+    value = std::strtod(number.c_str(), NULL);
+    return true;
+  }
+
+  if (negative)
+    value = -value;
+  return true;
+}
+
+inline bool LoadCSV::NextField(const char*& position,
+                               const char* end,
+                               const char*& fieldBegin,
+                               const char*& fieldEnd,
+                               bool& quoted) const
+{
+  const char* p = position;
+  while (p != end && details::IsFieldSpace(*p))
+    ++p;
+
+  quoted = (p != end && *p == '"');
+  if (quoted)
+  {
+    fieldBegin = ++p;
+    while (p != end && *p != '"')
+      p += (*p == '\\' && p + 1 != end) ? 2 : 1;
+    fieldEnd = p;
+
+    // Skip the closing quote, and anything between it and the separator.
+    if (p != end)
+      ++p;
+    if (commas)
+    {
+      while (p != end && *p != ',')
+        ++p;
+    }
+    else
+    {
+      while (p != end && !details::IsFieldSpace(*p))
+        ++p;
+    }
+  }
+  else
+  {
+    fieldBegin = p;
+    if (commas)
+    {
+      while (p != end && *p != ',')
+        ++p;
+      fieldEnd = p;
+      while (fieldEnd != fieldBegin && details::IsFieldSpace(*(fieldEnd - 1)))
+        --fieldEnd;
+    }
+    else
+    {
+      while (p != end && !details::IsFieldSpace(*p))
+        ++p;
+      fieldEnd = p;
+    }
+  }
+
+  // Find the next field, if there is one.
+  if (commas)
+  {
+    if (p == end)
+    {
+      position = p;
+      return false;
+    }
+
+    position = p + 1; // Skip the comma.
+    return true;
+  }
+  else
+  {
+    while (p != end && details::IsFieldSpace(*p))
+      ++p;
+    position = p;
+    return (p != end);
+  }
+}
+
+inline std::string LoadCSV::FieldString(const char* fieldBegin,
+                                        const char* fieldEnd,
+                                        const bool quoted)
+{
+  if (!quoted)
+    return std::string(fieldBegin, fieldEnd);
+
+  std::string field;
+  field.reserve(fieldEnd - fieldBegin);
+  for (const char* p = fieldBegin; p != fieldEnd; ++p)
+  {
+    if (*p == '\\' && p + 1 != fieldEnd)
+    {
+      ++p;
+      field.push_back((*p == 'n') ? '\n' : *p);
+    }
+    else
+    {
+      field.push_back(*p);
+    }
+  }
+
+  return field;
+}
+
+inline bool LoadCSV::ParseField(const char* fieldBegin,
+                                const char* fieldEnd,
+                                const bool quoted,
+                                double& value)
+{
+  if (!quoted)
+    return ParseNumber(fieldBegin, fieldEnd, value);
+
+  // Quoted fields are rare, so it doesn't matter that this allocates.
+  std::string field = FieldString(fieldBegin, fieldEnd, true);
+  const size_t first = field.find_first_not_of(" \t\r\v\f");
+  if (first == std::string::npos)
+    return false;
+  const size_t last = field.find_last_not_of(" \t\r\v\f");
+  return ParseNumber(field.data() + first, field.data() + last + 1, value);
+}
+
+template<typename eT>
+void LoadCSV::ParseLines(arma::Mat<eT>& matrix,
+                         const bool transpose,
+                         const bool emptyIsZero,
+                         std::vector<char>& nonNumeric) const
+{
+  // Every element is written below, so the matrix doesn't need to be zeroed.
+  if (transpose)
+    matrix.set_size(fields, lines.size());
+  else
+    matrix.set_size(lines.size(), fields);
+
+  nonNumeric.assign(transpose ? fields : lines.size(), 0);
+
+  #pragma omp parallel
+  {
+    // When the dimensions are fields, every thread may find non-numeric fields
+    // in every dimension, so each keeps its own flags.
+    std::vector<char> localNonNumeric(transpose ? fields : 0, 0);
+
+    #pragma omp for schedule(static)
+    for (intmax_t i = 0; i < (intmax_t) lines.size(); ++i)
+    {
+      const char* position = text + lines[i].first;
+      const char* end = text + lines[i].second;
+
+      // When transposing, the line is written to one contiguous column.
+      eT* out = transpose ? matrix.colptr(i) : matrix.memptr() + i;
+      const size_t stride = transpose ? 1 : matrix.n_rows;
+
+      bool more = true;
+      for (size_t f = 0; f < fields; ++f)
+      {
+        const char* fieldBegin = end;
+        const char* fieldEnd = end;
+        bool quoted = false;
+        if (more)
+          more = NextField(position, end, fieldBegin, fieldEnd, quoted);
+
+        double value = 0.0;
+        const bool empty = (fieldBegin == fieldEnd);
+        if (!(empty && emptyIsZero) &&
+            !ParseField(fieldBegin, fieldEnd, quoted, value))
+        {
+          value = 0.0;
+          if (transpose)
+            localNonNumeric[f] = 1;
+          else
+            nonNumeric[i] = 1;
+        }
+
+        out[f * stride] = (eT) value;
+      }
+    }
+
+    if (transpose)
+    {
+      #pragma omp critical
+      {
+        for (size_t f = 0; f < fields; ++f)
+          nonNumeric[f] |= localNonNumeric[f];
+      }
+    }
+  }
+}
+
+inline void LoadCSV::FindLines()
+{
+
+  // Split the file into chunks of at least 64KB; each chunk holds the lines
+  // that start inside it.
+  size_t numChunks = 1;
+#ifdef _OPENMP
+  numChunks = std::max((size_t) 1, std::min((size_t) omp_get_max_threads(),
+      size / 65536));
+#endif
+
+  std::vector<std::vector<std::pair<size_t, size_t>>> chunkLines(numChunks);
+
+  #pragma omp parallel for schedule(static, 1)
+  for (intmax_t c = 0; c < (intmax_t) numChunks; ++c)
+  {
+    const size_t chunkBegin = size * c / numChunks;
+    const size_t chunkEnd = size * (c + 1) / numChunks;
+
+    // Skip the end of the line that started in the previous chunk.
+    size_t begin = chunkBegin;
+    if (begin > 0 && text[begin - 1] != '\n')
+    {
+      const char* newline = (const char*) std::memchr(text + begin, '\n',
+          chunkEnd - begin);
+      begin = (newline == NULL) ? chunkEnd : (newline - text + 1);
+    }
+
+    while (begin < chunkEnd)
+    {
+      const char* newline = (const char*) std::memchr(text + begin, '\n',
+          size - begin);
+      const size_t next = (newline == NULL) ? size : (newline - text + 1);
+      const size_t end = (newline == NULL) ? size : (newline - text);
+
+      // Blank lines are skipped.
+      for (size_t j = begin; j < end; ++j)
+      {
+        if (!details::IsFieldSpace(text[j]))
+        {
+          chunkLines[c].push_back(std::make_pair(begin, end));
+          break;
+        }
+      }
+
+      begin = next;
+    }
+  }
+
+  size_t numLines = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+    numLines += chunkLines[c].size();
+
+  lines.clear();
+  lines.reserve(numLines);
+  for (size_t c = 0; c < numChunks; ++c)
+    lines.insert(lines.end(), chunkLines[c].begin(), chunkLines[c].end());
+}
+
+inline void LoadCSV::CountFields()
+{
+  std::vector<size_t> counts(lines.size());
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) lines.size(); ++i)
+  {
+    const char* position = text + lines[i].first;
+    const char* end = text + lines[i].second;
+    const char* fieldBegin;
+    const char* fieldEnd;
+    bool quoted;
+
+    size_t count = 1;
+    while (NextField(position, end, fieldBegin, fieldEnd, quoted))
+      ++count;
+    counts[i] = count;
+  }
+
+  fields = 0;
+  for (size_t i = 0; i < counts.size(); ++i)
+    fields = std::max(fields, counts[i]);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
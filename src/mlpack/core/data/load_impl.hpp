@@ -19,85 +19,16 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
-#include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "serialization_shim.hpp"
 
 #include "load_arff.hpp"
+#include "load_csv.hpp"
 
 namespace mlpack {
 namespace data {
 
-namespace details{
-
-template<typename Tokenizer>
-std::vector<std::string> ToTokens(Tokenizer &lineTok)
-{
-  std::vector<std::string> tokens;
-  std::transform(std::begin(lineTok), std::end(lineTok),
-                 std::back_inserter(tokens),
-                 [&tokens](std::string const &str)
-  {
-    std::string trimmedToken(str);
-    boost::trim(trimmedToken);
-    return std::move(trimmedToken);
-  });
-
-  return tokens;
-}
-
-inline
-void TransPoseTokens(std::vector<std::vector<std::string>> const &input,
-                     std::vector<std::string> &output,
-                     size_t index)
-{
-  output.clear();
-  for(size_t i = 0; i != input.size(); ++i)
-  {
-    output.emplace_back(input[i][index]);
-  }
-}
-
-template<typename eT>
-void MapToNumerical(const std::vector<std::string> &tokens,
-                    size_t &row,
-                    DatasetInfo &info,
-                    arma::Mat<eT> &matrix)
-{
-  auto notNumber = [](const std::string &str)
-  {
-    eT val(0);
-    std::stringstream token;
-    token.str(str);
-    token>>val;
-    return token.fail();
-  };
-
-  const bool notNumeric = std::any_of(std::begin(tokens),
-                                      std::end(tokens), notNumber);
-  if(notNumeric)
-  {
-    for(size_t i = 0; i != tokens.size(); ++i)
-    {
-      const eT val = static_cast<eT>(info.MapString(tokens[i], row));
-      matrix.at(row, i) = val;
-    }
-  }
-  else
-  {
-    std::stringstream token;
-    for(size_t i = 0; i != tokens.size(); ++i)
-    {
-      token.str(tokens[i]);
-      token>>matrix.at(row, i);
-      token.clear();
-    }
-  }
-}
-
-}
-
 template<typename eT>
 bool inline inplace_transpose(arma::Mat<eT>& X)
 {
@@ -151,6 +82,37 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Mappable binary data is already column-major, so it is copied straight out
+  // of the mapping and never transposed.
+  if (extension == "mbin")
+  {
+    stream.close();
+    Log::Info << "Loading '" << filename << "' as mappable binary data.  "
+        << std::flush;
+    try
+    {
+      MappedMatrix<eT> mapped(filename);
+      matrix = mapped.Matrix();
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed: " << e.what()
+            << "." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed: " << e.what()
+            << "." << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -330,9 +292,28 @@ bool Load(const std::string& filename,
     Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
         << std::flush;
 
-  // We can't use the stream if the type is HDF5.
+  // Delimited text is parsed by LoadCSV, in parallel, straight into the
+  // transposed layout.  We can't use the stream if the type is HDF5.
+  const bool delimited = (loadType == arma::csv_ascii ||
+      loadType == arma::raw_ascii);
   bool success;
-  if (loadType != arma::hdf5_binary)
+  std::string error;
+  if (delimited)
+  {
+    stream.close();
+    try
+    {
+      LoadCSV loader(filename, loadType == arma::csv_ascii);
+      loader.Load(matrix, transpose);
+      success = true;
+    }
+    catch (std::runtime_error& e)
+    {
+      error = std::string(": ") + e.what();
+      success = false;
+    }
+  }
+  else if (loadType != arma::hdf5_binary)
     success = matrix.load(stream, loadType);
   else
     success = matrix.load(filename, loadType);
@@ -342,19 +323,24 @@ bool Load(const std::string& filename,
     Log::Info << std::endl;
     Timer::Stop("loading_data");
     if (fatal)
-      Log::Fatal << "Loading from '" << filename << "' failed." << std::endl;
+      Log::Fatal << "Loading from '" << filename << "' failed" << error << "."
+          << std::endl;
     else
-      Log::Warn << "Loading from '" << filename << "' failed." << std::endl;
+      Log::Warn << "Loading from '" << filename << "' failed" << error << "."
+          << std::endl;
 
     return false;
   }
+  else if (delimited)
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
   else
     Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
         << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
   // Now transpose the matrix, if necessary.  Armadillo loads HDF5 matrices
   // transposed, so we have to work around that.
-  if (transpose && loadType != arma::hdf5_binary)
+  if (transpose && loadType != arma::hdf5_binary && !delimited)
   {
     inplace_transpose(matrix);
   }
@@ -369,6 +355,51 @@ bool Load(const std::string& filename,
   return success;
 }
 
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  std::string error;
+  if (Extension(filename) != "mbin")
+  {
+    error = "only mappable binary (.mbin) files can be mapped";
+  }
+  else
+  {
+    Log::Info << "Mapping '" << filename << "' as mappable binary data.  "
+        << std::flush;
+    try
+    {
+      matrix.Map(filename);
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Info << std::endl;
+      error = e.what();
+    }
+  }
+
+  Timer::Stop("loading_data");
+  if (!error.empty())
+  {
+    if (fatal)
+      Log::Fatal << "Loading from '" << filename << "' failed: " << error
+          << "." << std::endl;
+    else
+      Log::Warn << "Loading from '" << filename << "' failed: " << error
+          << "." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.Matrix().n_rows << " x "
+      << matrix.Matrix().n_cols << ".\n";
+  return true;
+}
+
 // Load with mappings.  Unfortunately we have to implement this ourselves.
 template<typename eT>
 bool Load(const std::string& filename,
@@ -412,85 +443,27 @@ bool Load(const std::string& filename,
 
     Log::Info << "Loading '" << filename << "' as " << type << ".  "
         << std::flush;
-    std::string separators;
-    if (commas)
-      separators = ",";
-    else
-      separators = " \t";
-
-    // We'll load this as CSV (or CSV with spaces or tabs) according to
-    // RFC4180.  So the first thing to do is determine the size of the matrix.
-    std::string buffer;
-    size_t cols = 0;
-
-    std::getline(stream, buffer, '\n');
-    // Count commas and whitespace in the line, ignoring anything inside
-    // quotes.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", separators, "\"");
-    Tokenizer tok(buffer, sep);
-    for (Tokenizer::iterator i = tok.begin(); i != tok.end(); ++i)
-      ++cols;
-
-    // Now count the number of lines in the file.  We've already counted the
-    // first one.
-    size_t rows = 1;
-    while (!stream.eof() && !stream.bad() && !stream.fail())
-    {
-      std::getline(stream, buffer, '\n');
-      if (!stream.fail())
-        ++rows;
-    }
-
-    // Now we have the size.  So resize our matrix.
-    if (transpose)
-    {
-      matrix.set_size(cols, rows);
-      info = DatasetInfo(cols);
-    }
-    else
-    {
-      matrix.set_size(rows, cols);
-      info = DatasetInfo(rows);
-    }
-
     stream.close();
-    stream.open(filename, std::fstream::in);    
 
-    if(transpose)
+    // LoadCSV parses the lines in parallel, then maps the fields of the
+    // categorical dimensions in the order they appear in the file.
+    try
     {
-      std::vector<std::vector<std::string>> tokensArray;
-      std::vector<std::string> tokens;
-      while (!stream.bad() && !stream.fail() && !stream.eof())
-      {
-        // Extract line by line.
-        std::getline(stream, buffer, '\n');
-        Tokenizer lineTok(buffer, sep);
-        tokens = details::ToTokens(lineTok);
-        if(tokens.size() == cols)
-        {
-          tokensArray.emplace_back(std::move(tokens));
-        }
-      }
-      for(size_t i = 0; i != cols; ++i)
-      {
-        details::TransPoseTokens(tokensArray, tokens, i);
-        details::MapToNumerical(tokens, i,
-                                info, matrix);
-      }
+      LoadCSV loader(filename, commas);
+      loader.Load(matrix, info, transpose);
     }
-    else
+    catch (std::runtime_error& e)
     {
-      size_t row = 0;
-      while (!stream.bad() && !stream.fail() && !stream.eof())
-      {
-        // Extract line by line.
-        std::getline(stream, buffer, '\n');
-        Tokenizer lineTok(buffer, sep);
-        details::MapToNumerical(details::ToTokens(lineTok), row,
-                                info, matrix);
-        ++row;
-      }
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed: " << e.what()
+            << "." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed: " << e.what()
+            << "." << std::endl;
+
+      return false;
     }
   }
   else if (extension == "arff")
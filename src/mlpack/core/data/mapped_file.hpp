@@ -0,0 +1,86 @@
+/**
+ * @file mapped_file.hpp
+ *
+ * Definition of the MappedFile class, which maps a whole file into memory.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A whole file mapped into memory.  The mapping is private: the memory may be
+ * modified, but the changes are not written back to the file, and only the
+ * modified pages are copied.  Nothing is read from disk until it is accessed,
+ * and processes that map the same file share the page cache.
+ *
+ * On systems without mmap(), the file is read into memory instead.
+ */
+class MappedFile
+{
+ public:
+  //! Create an empty MappedFile, which holds no mapping.
+  MappedFile();
+
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file cannot be
+   * opened or mapped.
+   *
+   * @param filename Name of file to map.
+   */
+  MappedFile(const std::string& filename);
+
+  //! Take the mapping of another MappedFile.
+  MappedFile(MappedFile&& other);
+
+  //! Take the mapping of another MappedFile, releasing our own mapping.
+  MappedFile& operator=(MappedFile&& other);
+
+  //! A mapping can't be shared between objects.
+  MappedFile(const MappedFile& other) = delete;
+  //! A mapping can't be shared between objects.
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  //! Release the mapping.
+  ~MappedFile();
+
+  /**
+   * Map the given file, releasing any previous mapping.  A std::runtime_error
+   * is thrown on failure, in which case the object holds no mapping.
+   *
+   * @param filename Name of file to map.
+   */
+  void Map(const std::string& filename);
+
+  //! Release the mapping.
+  void Unmap();
+
+  //! Return whether or not a file is mapped.
+  bool IsMapped() const { return data != NULL; }
+
+  //! Get the mapped memory (NULL if nothing is mapped).
+  const char* Data() const { return data; }
+  //! Modify the mapped memory (the file is not modified).
+  char* Data() { return data; }
+
+  //! Get the size of the mapped file, in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  //! The mapped memory, or NULL.
+  char* data;
+  //! The size of the mapped file, in bytes.
+  size_t size;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_file_impl.hpp"
+
+#endif
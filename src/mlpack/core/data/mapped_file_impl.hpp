@@ -0,0 +1,133 @@
+/**
+ * @file mapped_file_impl.hpp
+ *
+ * Implementation of the MappedFile class.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+inline MappedFile::MappedFile() : data(NULL), size(0)
+{
+  // Nothing to do.
+}
+
+inline MappedFile::MappedFile(const std::string& filename) :
+    data(NULL),
+    size(0)
+{
+  Map(filename);
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) :
+    data(other.data),
+    size(other.size)
+{
+  other.data = NULL;
+  other.size = 0;
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+  if (this != &other)
+  {
+    Unmap();
+
+    data = other.data;
+    size = other.size;
+
+    other.data = NULL;
+    other.size = 0;
+  }
+
+  return *this;
+}
+
+inline MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+inline void MappedFile::Map(const std::string& filename)
+{
+  Unmap();
+
+#ifdef _WIN32
+  // Without mmap(), the best we can do is read the file into memory.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  // Allocate at least one byte, so that an empty file is still mapped.
+  char* memory = new char[fileSize + 1];
+  stream.read(memory, fileSize);
+  if (!stream)
+  {
+    delete[] memory;
+    throw std::runtime_error("cannot read file '" + filename + "'");
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("cannot open file '" + filename + "'");
+  }
+  const size_t fileSize = (size_t) fileStat.st_size;
+
+  // mmap() can't map an empty file, so map a page of anonymous memory instead;
+  // the mapping stays valid after the file is closed.
+  void* memory = (fileSize == 0) ?
+      mmap(NULL, 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+          0) :
+      mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+    throw std::runtime_error("cannot map file '" + filename + "'");
+#endif
+
+  data = (char*) memory;
+  size = fileSize;
+}
+
+inline void MappedFile::Unmap()
+{
+  if (data != NULL)
+  {
+#ifdef _WIN32
+    delete[] data;
+#else
+    munmap(data, (size == 0) ? 1 : size);
+#endif
+    data = NULL;
+    size = 0;
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
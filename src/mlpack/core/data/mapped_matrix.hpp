@@ -0,0 +1,131 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * Definition of the MappedMatrix class, which memory-maps a matrix stored in
+ * mlpack's mappable binary format.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/core/arma_extend/arma_extend.hpp> // Includes Armadillo.
+#include <string>
+#include <ostream>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The size of the header of a mappable binary (.mbin) file, in bytes.  The
+ * header holds:
+ *
+ *  - bytes 0-31: the Armadillo binary header for the element type (i.e.
+ *      "ARMA_MAT_BIN_FN008" for doubles), padded with zeros
+ *  - bytes 32-39: the number of rows, as a 64-bit unsigned integer
+ *  - bytes 40-47: the number of columns, as a 64-bit unsigned integer
+ *  - bytes 48-63: reserved (zeros)
+ *
+ * The elements follow the header directly, in column-major order and native
+ * byte order, so that the file can be mapped into memory and used as the
+ * memory of an arma::Mat without copying or transposing.
+ */
+const size_t MappedHeaderSize = 64;
+
+/**
+ * A matrix that is memory-mapped from a file in mlpack's mappable binary
+ * format (denoted by the .mbin extension; see MappedHeaderSize).  Matrix()
+ * gives an arma::Mat that uses the mapped file as its memory, so nothing is
+ * read until it is accessed, nothing is copied or transposed, and several
+ * processes that map the same file share the page cache.
+ *
+ * The mapping is private: the matrix may be modified, but the changes are not
+ * written back to the file, and only the modified pages are copied.  The matrix
+ * cannot be resized, and it is only valid while the MappedMatrix exists, so it
+ * should not be moved from (pass it by const reference instead; algorithms that
+ * must rearrange the data, such as tree building, will copy it).
+ *
+ * On systems without mmap(), the file is read into memory instead.
+ *
+ * @code
+ * data::MappedMatrix<double> dataset;
+ * data::Load("dataset.mbin", dataset, true);
+ * KNN knn(dataset.Matrix(), true); // Naive search does not copy the data.
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  //! Create an empty MappedMatrix, which holds no mapping.
+  MappedMatrix();
+
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file cannot be
+   * opened, is not in the mappable binary format, or holds another element
+   * type.
+   *
+   * @param filename Name of .mbin file to map.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Take the mapping of another MappedMatrix.
+  MappedMatrix(MappedMatrix&& other);
+
+  //! Take the mapping of another MappedMatrix, releasing our own mapping.
+  MappedMatrix& operator=(MappedMatrix&& other);
+
+  //! A mapping can't be shared between objects.
+  MappedMatrix(const MappedMatrix& other) = delete;
+  //! A mapping can't be shared between objects.
+  MappedMatrix& operator=(const MappedMatrix& other) = delete;
+
+  //! Release the mapping.
+  ~MappedMatrix();
+
+  /**
+   * Map the given file, releasing any previous mapping.  A std::runtime_error
+   * is thrown on failure, in which case the object holds no mapping.
+   *
+   * @param filename Name of .mbin file to map.
+   */
+  void Map(const std::string& filename);
+
+  //! Release the mapping; the matrix becomes empty.
+  void Unmap();
+
+  //! Return whether or not a file is mapped.
+  bool IsMapped() const { return file.IsMapped(); }
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+  //! Modify the mapped matrix (the file is not modified).
+  arma::Mat<eT>& Matrix() { return *matrix; }
+
+ private:
+  //! The mapped file (including the header).
+  MappedFile file;
+  //! The matrix that uses the mapped memory.
+  arma::Mat<eT>* matrix;
+};
+
+/**
+ * Write the given matrix to the given stream in the mappable binary format.
+ * The matrix is written as-is (it is never transposed).
+ *
+ * @param stream Stream to write to; it should be opened in binary mode.
+ * @param matrix Matrix to write.
+ * @return Boolean value indicating success or failure of the write.
+ */
+template<typename eT>
+bool SaveMapped(std::ostream& stream, const arma::Mat<eT>& matrix);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of the MappedMatrix class and of SaveMapped().
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix() : matrix(new arma::Mat<eT>())
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    MappedMatrix()
+{
+  Map(filename);
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(MappedMatrix&& other) :
+    file(std::move(other.file)),
+    matrix(other.matrix)
+{
+  other.matrix = new arma::Mat<eT>();
+}
+
+template<typename eT>
+MappedMatrix<eT>& MappedMatrix<eT>::operator=(MappedMatrix&& other)
+{
+  if (this != &other)
+  {
+    Unmap();
+    delete matrix;
+
+    file = std::move(other.file);
+    matrix = other.matrix;
+
+    other.matrix = new arma::Mat<eT>();
+  }
+
+  return *this;
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  Unmap();
+  delete matrix;
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Map(const std::string& filename)
+{
+  Unmap();
+
+  // Nothing is read until the header is accessed below.
+  MappedFile newFile(filename);
+  if (newFile.Size() < MappedHeaderSize)
+    throw std::runtime_error("'" + filename + "' is not mappable binary data");
+
+  // Make sure the file holds the right type of elements.
+  const char* header = newFile.Data();
+  const std::string typeHeader(header,
+      std::find(header, header + 32, '\0'));
+  if (typeHeader != arma::diskio::gen_bin_header(*matrix))
+  {
+    if (typeHeader.compare(0, 12, "ARMA_MAT_BIN") == 0)
+      throw std::runtime_error("'" + filename + "' holds a different element "
+          "type");
+    else
+      throw std::runtime_error("'" + filename + "' is not mappable binary "
+          "data");
+  }
+
+  uint64_t rows, cols;
+  std::memcpy(&rows, header + 32, sizeof(uint64_t));
+  std::memcpy(&cols, header + 40, sizeof(uint64_t));
+
+  const size_t maxElements = (newFile.Size() - MappedHeaderSize) / sizeof(eT);
+  if (cols != 0 && rows > maxElements / cols)
+    throw std::runtime_error("'" + filename + "' is truncated");
+
+  file = std::move(newFile);
+
+  // Use the mapped memory strictly, so that the matrix can't be resized away
+  // from it.
+  delete matrix;
+  matrix = new arma::Mat<eT>((eT*) (file.Data() + MappedHeaderSize), rows,
+      cols, false, true);
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Unmap()
+{
+  // The matrix must not refer to the mapping once it is released.
+  delete matrix;
+  matrix = new arma::Mat<eT>();
+
+  file.Unmap();
+}
+
+template<typename eT>
+bool SaveMapped(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  char header[MappedHeaderSize];
+  std::fill(header, header + MappedHeaderSize, 0);
+
+  const std::string typeHeader = arma::diskio::gen_bin_header(matrix);
+  std::copy(typeHeader.begin(), typeHeader.end(), header);
+
+  const uint64_t rows = matrix.n_rows;
+  const uint64_t cols = matrix.n_cols;
+  std::memcpy(header + 32, &rows, sizeof(uint64_t));
+  std::memcpy(header + 40, &cols, sizeof(uint64_t));
+
+  stream.write(header, MappedHeaderSize);
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+
+  return stream.good();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #include <string>
 
 #include "format.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices. */ {
@@ -34,6 +35,10 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * mlpack's mappable binary format, denoted by .mbin, is supported too (see
+ * MappedMatrix).  Those files hold mlpack's column-major layout, so the matrix
+ * is never transposed when saving them.
+ *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
  * thrown upon failure.  If the 'transpose' parameter is set to true, the matrix
@@ -64,6 +64,26 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Mappable binary data is written as-is, without transposing.
+  if (extension == "mbin")
+  {
+    Log::Info << "Saving mappable binary data to '" << filename << "'."
+        << std::endl;
+    if (!SaveMapped(stream, matrix))
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+      else
+        Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type saveType;
   std::string stringType;
@@ -0,0 +1,115 @@
+/**
+ * @file streaming_loader.hpp
+ *
+ * Definition of the StreamingLoader class, which reads a dataset from a file or
+ * from standard input a chunk of points at a time.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_LOADER_HPP
+#define MLPACK_CORE_DATA_STREAMING_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Read a dataset a chunk of points at a time, so that algorithms that learn
+ * incrementally (such as HoeffdingTree and NaiveBayesClassifier) can be trained
+ * on datasets that are larger than memory, or on unbounded streams.  Only one
+ * chunk is held in memory at a time.
+ *
+ * The dataset can be numeric text (one point per line, with fields separated
+ * by commas, or by spaces and tabs, as for data::Load()) or mlpack's mappable
+ * binary format (.mbin; see MappedMatrix), whose points are read column by
+ * column.  If the filename is "-", the dataset is read from standard input and
+ * its format is detected from its first bytes.
+ *
+ * Text chunks are parsed in parallel by LoadCSV.  Every chunk has the same
+ * number of dimensions as the first chunk (lines with fewer fields are padded
+ * with zeros).
+ *
+ * @code
+ * data::StreamingLoader loader("dataset.csv", 10000);
+ * arma::mat chunk;
+ * while (loader.Next(chunk) > 0)
+ *   Train(chunk);
+ * @endcode
+ */
+class StreamingLoader
+{
+ public:
+  /**
+   * Open the given file (or standard input, if the filename is "-") for
+   * reading.  A std::runtime_error is thrown if the file cannot be opened or is
+   * not text or mappable binary data.
+   *
+   * @param filename Name of the file to read, or "-" for standard input.
+   * @param chunkSize Maximum number of points to read at a time.
+   */
+  StreamingLoader(const std::string& filename, const size_t chunkSize = 10000);
+
+  /**
+   * Read the next chunk of points into the given matrix, one point per column.
+   * A std::runtime_error is thrown if the chunk is malformed (a field that is
+   * not a number, too many fields, or truncated binary data).
+   *
+   * @param chunk Matrix to store the points in.
+   * @return The number of points read; 0 once the data is exhausted.
+   */
+  template<typename eT>
+  size_t Next(arma::Mat<eT>& chunk);
+
+  //! Get the maximum number of points read at a time.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the maximum number of points read at a time.
+  size_t& ChunkSize() { return chunkSize; }
+
+  //! Get the dimensionality of the data (0 until the first chunk is read from
+  //! text).
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of points read so far.
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  /**
+   * Get the next line of text, which may start with the bytes that were read to
+   * detect the format.
+   *
+   * @param line String to store the line in (without the newline).
+   * @return false if there are no more lines.
+   */
+  bool ReadLine(std::string& line);
+
+  //! The file, if one was opened.
+  std::ifstream file;
+  //! The stream to read from: the file, or std::cin.
+  std::istream* stream;
+  //! The name of the file, for error messages.
+  std::string filename;
+  //! The maximum number of points to read at a time.
+  size_t chunkSize;
+  //! If true, the data is mappable binary data.
+  bool binary;
+  //! For binary data, the Armadillo header of the element type.
+  std::string typeHeader;
+  //! For binary data, the number of points in the file.
+  size_t binaryPoints;
+  //! For text, whether the separators are commas; decided by the first line.
+  bool commas;
+  //! Bytes that were read to detect the format, and not yet used.
+  std::string pending;
+  //! The dimensionality of the data.
+  size_t dimensionality;
+  //! The number of points read so far.
+  size_t pointsRead;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_loader_impl.hpp"
+
+#endif
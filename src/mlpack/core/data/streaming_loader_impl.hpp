@@ -0,0 +1,195 @@
+/**
+ * @file streaming_loader_impl.hpp
+ *
+ * Implementation of the StreamingLoader class.
+ */
+#ifndef MLPACK_CORE_DATA_STREAMING_LOADER_IMPL_HPP
+#define MLPACK_CORE_DATA_STREAMING_LOADER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+
+#include "extension.hpp"
+#include "load_csv.hpp"
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline StreamingLoader::StreamingLoader(const std::string& filename,
+                                        const size_t chunkSize) :
+    stream(&std::cin),
+    filename(filename),
+    chunkSize(chunkSize),
+    binary(false),
+    binaryPoints(0),
+    commas(false),
+    dimensionality(0),
+    pointsRead(0)
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("StreamingLoader: chunk size must be positive");
+
+  const std::string extension = Extension(filename);
+  if (filename != "-")
+  {
+    if (extension != "csv" && extension != "tsv" && extension != "txt" &&
+        extension != "mbin")
+      throw std::runtime_error("cannot stream '" + filename + "'; only text "
+          "(.csv, .tsv, .txt) and mappable binary (.mbin) data can be "
+          "streamed");
+
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+      throw std::runtime_error("cannot open file '" + filename + "'");
+    stream = &file;
+  }
+
+  // Mappable binary data starts with an Armadillo binary header.
+  const std::string binaryPrefix = "ARMA_MAT_BIN";
+  char start[MappedHeaderSize];
+  stream->read(start, binaryPrefix.size());
+  const size_t startSize = (size_t) stream->gcount();
+  binary = (std::string(start, startSize) == binaryPrefix);
+  if (extension == "mbin" && !binary)
+    throw std::runtime_error("'" + filename + "' is not mappable binary data");
+
+  if (binary)
+  {
+    stream->read(start + startSize, MappedHeaderSize - startSize);
+    if ((size_t) stream->gcount() != MappedHeaderSize - startSize)
+      throw std::runtime_error("'" + filename + "' is truncated");
+
+    typeHeader = std::string(start, std::find(start, start + 32, '\0'));
+
+    uint64_t rows, cols;
+    std::memcpy(&rows, start + 32, sizeof(uint64_t));
+    std::memcpy(&cols, start + 40, sizeof(uint64_t));
+    dimensionality = (size_t) rows;
+    binaryPoints = (size_t) cols;
+  }
+  else
+  {
+    pending = std::string(start, startSize);
+  }
+}
+
+template<typename eT>
+size_t StreamingLoader::Next(arma::Mat<eT>& chunk)
+{
+  if (binary)
+  {
+    if (typeHeader != arma::diskio::gen_bin_header(chunk))
+      throw std::runtime_error("'" + filename + "' holds a different element "
+          "type");
+
+    const size_t points = std::min(chunkSize, binaryPoints - pointsRead);
+    chunk.set_size(dimensionality, points);
+    const std::streamsize bytes = chunk.n_elem * sizeof(eT);
+    stream->read((char*) chunk.memptr(), bytes);
+    if (stream->gcount() != bytes)
+      throw std::runtime_error("'" + filename + "' is truncated");
+
+    pointsRead += points;
+    return points;
+  }
+
+  // Gather the lines of the chunk, then parse them all at once.
+  std::string text;
+  std::string line;
+  size_t points = 0;
+  while (points < chunkSize && ReadLine(line))
+  {
+    if (line.find_first_not_of(" \t\r\v\f") == std::string::npos)
+      continue;
+
+    // The first line decides the separator.
+    if (pointsRead == 0 && points == 0)
+      commas = (line.find(',') != std::string::npos);
+
+    text += line;
+    text += '\n';
+    ++points;
+  }
+
+  if (points == 0)
+  {
+    chunk.set_size(dimensionality, 0);
+    return 0;
+  }
+
+  LoadCSV parser(text.data(), text.size(), commas);
+  try
+  {
+    parser.Load(chunk, true);
+  }
+  catch (std::runtime_error& e)
+  {
+    std::ostringstream oss;
+    oss << "in the chunk of '" << filename << "' starting at point "
+        << pointsRead << ": " << e.what();
+    throw std::runtime_error(oss.str());
+  }
+
+  if (dimensionality == 0)
+  {
+    dimensionality = chunk.n_rows;
+  }
+  else if (chunk.n_rows < dimensionality)
+  {
+    // Every line of the chunk was short; pad with zeros.
+    chunk.resize(dimensionality, chunk.n_cols);
+  }
+  else if (chunk.n_rows > dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "the chunk of '" << filename << "' starting at point " << pointsRead
+        << " has " << chunk.n_rows << " dimensions, but earlier points had "
+        << dimensionality;
+    throw std::runtime_error(oss.str());
+  }
+
+  pointsRead += points;
+  return points;
+}
+
+inline bool StreamingLoader::ReadLine(std::string& line)
+{
+  const size_t newline = pending.find('\n');
+  if (newline != std::string::npos)
+  {
+    line = pending.substr(0, newline);
+    pending.erase(0, newline + 1);
+    return true;
+  }
+
+  if (!std::getline(*stream, line))
+  {
+    if (pending.empty())
+      return false;
+
+    line.swap(pending);
+    pending.clear();
+    return true;
+  }
+
+  if (!pending.empty())
+  {
+    line.insert(0, pending);
+    pending.clear();
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file diagonal_gaussian_distribution.hpp
+ *
+ * Implementation of the Gaussian distribution with diagonal covariance.
+ */
+#ifndef MLPACK_CORE_DISTRIBUTIONS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+#define MLPACK_CORE_DISTRIBUTIONS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace distribution {
+
+/**
+ * A single multivariate Gaussian distribution with diagonal covariance.  Only
+ * the variance of each dimension is stored, so the distribution takes O(d)
+ * memory instead of O(d^2), and the probability of each observation is found
+ * in O(d) time without any factorization.  This is the same distribution as a
+ * GaussianDistribution whose covariance is diagonal, but it is much cheaper in
+ * high dimensions.
+ */
+class DiagonalGaussianDistribution
+{
+ private:
+  //! Mean of the distribution.
+  arma::vec mean;
+  //! Variance of each dimension (the diagonal of the covariance).
+  arma::vec covariance;
+  //! Cached inverse of each variance.
+  arma::vec invCov;
+  //! Cached logdet(cov).
+  double logDetCov;
+
+  //! log(2pi)
+  static const constexpr double log2pi = 1.83787706640934533908193770912475883;
+
+ public:
+  /**
+   * Default constructor, which creates a Gaussian with zero dimension.
+   */
+  DiagonalGaussianDistribution() : logDetCov(0) { /* Nothing to do. */ }
+
+  /**
+   * Create a Gaussian distribution with zero mean and identity covariance with
+   * the given dimensionality.
+   */
+  DiagonalGaussianDistribution(const size_t dimension) :
+      mean(arma::zeros<arma::vec>(dimension)),
+      covariance(arma::ones<arma::vec>(dimension)),
+      invCov(arma::ones<arma::vec>(dimension)),
+      logDetCov(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Create a Gaussian distribution with the given mean and the given variance
+   * of each dimension.
+   *
+   * Each variance is expected to be positive.
+   */
+  DiagonalGaussianDistribution(const arma::vec& mean,
+                               const arma::vec& covariance);
+
+  //! Return the dimensionality of this distribution.
+  size_t Dimensionality() const { return mean.n_elem; }
+
+  /**
+   * Return the probability of the given observation.
+   */
+  double Probability(const arma::vec& observation) const
+  {
+    return exp(LogProbability(observation));
+  }
+
+  /**
+   * Return the log probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the multivariate Gaussian probability density function for each
+   * data point (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const
+  {
+    arma::vec logProbabilities;
+    LogProbability(x, logProbabilities);
+    probabilities = arma::exp(logProbabilities);
+  }
+
+  /**
+   * Calculates the multivariate Gaussian log probability density function for
+   * each data point (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
+  /**
+   * Return a randomly generated observation according to the probability
+   * distribution defined by this object.
+   *
+   * @return Random observation from this Gaussian distribution.
+   */
+  arma::vec Random() const;
+
+  /**
+   * Estimate the Gaussian distribution directly from the given observations.
+   *
+   * @param observations List of observations.
+   */
+  void Train(const arma::mat& observations);
+
+  /**
+   * Estimate the Gaussian distribution from the given observations, taking into
+   * account the probability of each observation actually being from this
+   * distribution.
+   */
+  void Train(const arma::mat& observations,
+             const arma::vec& probabilities);
+
+  /**
+   * Return the mean.
+   */
+  const arma::vec& Mean() const { return mean; }
+
+  /**
+   * Return a modifiable copy of the mean.
+   */
+  arma::vec& Mean() { return mean; }
+
+  /**
+   * Return the variance of each dimension (the diagonal of the covariance).
+   */
+  const arma::vec& Covariance() const { return covariance; }
+
+  /**
+   * Set the variance of each dimension.
+   */
+  void Covariance(const arma::vec& covariance);
+
+  void Covariance(arma::vec&& covariance);
+
+  /**
+   * Serialize the distribution.
+   */
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */)
+  {
+    using data::CreateNVP;
+
+    // We just need to serialize each of the members.
+    ar & CreateNVP(mean, "mean");
+    ar & CreateNVP(covariance, "covariance");
+    ar & CreateNVP(invCov, "invCov");
+    ar & CreateNVP(logDetCov, "logDetCov");
+  }
+
+ private:
+  //! Recompute the cached inverse variances and log-determinant.
+  void InvertCovariance();
+};
+
+inline void DiagonalGaussianDistribution::LogProbability(
+    const arma::mat& x,
+    arma::vec& logProbabilities) const
+{
+  // The exponent of each observation is a weighted sum of its squared
+  // differences from the mean, so the whole batch is one matrix-vector product.
+  arma::mat diffs = x;
+  diffs.each_col() -= mean;
+
+  const size_t k = x.n_rows;
+
+  logProbabilities = -0.5 * arma::trans(arma::square(diffs)) * invCov;
+  logProbabilities += -0.5 * k * log2pi - 0.5 * logDetCov;
+}
+
+} // namespace distribution
+} // namespace mlpack
+
+#endif
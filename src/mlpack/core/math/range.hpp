@@ -52,6 +52,15 @@ class RangeType
    */
   inline RangeType(const T lo, const T hi);
 
+  /**
+   * Initialize to the same bounds as a range holding another element type
+   * (i.e. a range of floats).
+   *
+   * @param other Range to convert.
+   */
+  template<typename U>
+  inline RangeType(const RangeType<U>& other);
+
   //! Get the lower bound.
   inline T Lo() const { return lo; }
   //! Modify the lower bound.
@@ -0,0 +1,88 @@
+/**
+ * @file euclidean_block.hpp
+ *
+ * Blocked computation of the Euclidean distances between every pair of points
+ * from two sets, for use in the base cases of tree-based algorithms.
+ */
+#ifndef MLPACK_CORE_METRICS_EUCLIDEAN_BLOCK_HPP
+#define MLPACK_CORE_METRICS_EUCLIDEAN_BLOCK_HPP
+
+#include <mlpack/core.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * IsEuclideanMetric<MetricType>::value is true if MetricType is the Euclidean
+ * distance or the squared Euclidean distance, so that EuclideanBlock can be
+ * used in place of MetricType::Evaluate() on every pair of points.
+ */
+template<typename MetricType>
+struct IsEuclideanMetric
+{
+  static const bool value = false;
+};
+
+template<bool TakeRoot>
+struct IsEuclideanMetric<LMetric<2, TakeRoot>>
+{
+  static const bool value = true;
+};
+
+/**
+ * Compute the squared Euclidean distances between two sets of points all at
+ * once, using
+ *
+ * @f[
+ * \| a - b \|^2 = \| a \|^2 + \| b \|^2 - 2 a^T b,
+ * @f]
+ *
+ * so that nearly all of the work is a single matrix multiplication, which BLAS
+ * carries out with blocked, vectorized kernels.  The expansion suffers from
+ * cancellation when two points are much closer to each other than to the
+ * origin, so a bound on the absolute error of each result is given too.  The
+ * results should only be used to decide which pairs are worth evaluating
+ * exactly.
+ */
+class EuclideanBlock
+{
+ public:
+  /**
+   * Compute the approximate squared distance between every column of a and
+   * every column of b.
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param squaredDistances Matrix to store the approximate squared distance
+   *     between a.col(i) and b.col(j) in, at (i, j).
+   * @param errorBounds Matrix to store a bound on the absolute error of each
+   *     element of squaredDistances in.
+   */
+  static void SquaredDistances(const arma::mat& a,
+                               const arma::mat& b,
+                               arma::mat& squaredDistances,
+                               arma::mat& errorBounds)
+  {
+    const arma::colvec aNorms = arma::trans(arma::sum(arma::square(a), 0));
+    const arma::rowvec bNorms = arma::sum(arma::square(b), 0);
+
+    squaredDistances = -2.0 * arma::trans(a) * b;
+    squaredDistances.each_col() += aNorms;
+    squaredDistances.each_row() += bNorms;
+
+    // The rounding error of the inner product and of the two norms is at most
+    // a small multiple of (dimensionality * machine epsilon) times the sum of
+    // the squared norms.  This is deliberately loose.
+    const double relativeError = 4.0 * (a.n_rows + 2) *
+        std::numeric_limits<double>::epsilon();
+    errorBounds = arma::repmat(aNorms, 1, b.n_cols);
+    errorBounds.each_row() += bNorms;
+    errorBounds *= relativeError;
+  }
+};
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,27 @@
 namespace mlpack {
 namespace optimization {
 
+/**
+ * This gives us a HasBatchGradientCheck object that we can use to tell whether
+ * or not a function can evaluate the gradient of a whole mini-batch at once.
+ */
+HAS_MEM_FUNC(Gradient, HasBatchGradientCheck);
+
+/**
+ * 'value' is true if the function has a member
+ * Gradient(coordinates, begin, gradient, batchSize).  The function type may be
+ * a reference (as it is when the optimizer is created with decltype(*this)).
+ */
+template<typename FunctionType>
+struct HasBatchGradient
+{
+  typedef typename std::remove_reference<FunctionType>::type Type;
+
+  static const bool value = HasBatchGradientCheck<Type,
+      void(Type::*)(const arma::mat&, const size_t, arma::mat&,
+      const size_t)>::value;
+};
+
 /**
  * Mini-batch Stochastic Gradient Descent is a technique for minimizing a
  * function which can be expressed as a sum of other functions.  That is,
@@ -62,6 +83,24 @@ namespace optimization {
  * function on the first point in the dataset (presumably, the dataset is held
  * internally in the DecomposableFunctionType).
  *
+ * If the function also implements
+ *
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t begin,
+ *                   const size_t batchSize,
+ *                   const bool deterministic);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * then each mini-batch (the functions begin, ..., begin + batchSize - 1) is
+ * evaluated with a single call, instead of one call per function.  These
+ * should return the sum of the objectives and the sum of the gradients of the
+ * functions in the batch.  This allows, for instance, a neural network to
+ * propagate the whole batch through each layer at once (see
+ * mlpack::ann::FFN).
+ *
  * @tparam DecomposableFunctionType Decomposable objective function type to be
  *     minimized.
  */
@@ -151,6 +190,31 @@ class MiniBatchSGD
   //! Controls whether or not the individual functions are shuffled when
   //! iterating.
   bool shuffle;
+  /**
+   * Take one step with the mini-batch at the given offset, evaluating the
+   * gradient of the whole batch with one call to the function, and return the
+   * objective of the batch at the new iterate.
+   */
+  template<typename FunctionType>
+  double Step(arma::mat& iterate,
+              const size_t offset,
+              const bool lastBatch,
+              arma::mat& gradient,
+              const typename boost::enable_if_c<
+                  HasBatchGradient<FunctionType>::value>::type* = 0);
+
+  /**
+   * Take one step with the mini-batch at the given offset, evaluating the
+   * gradient of each function in the batch separately, and return the
+   * objective of the batch at the new iterate.
+   */
+  template<typename FunctionType>
+  double Step(arma::mat& iterate,
+              const size_t offset,
+              const bool lastBatch,
+              arma::mat& gradient,
+              const typename boost::disable_if_c<
+                  HasBatchGradient<FunctionType>::value>::type* = 0);
 };
 
 } // namespace optimization
@@ -89,54 +89,15 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
         visitationOrder = arma::shuffle(visitationOrder);
     }
 
-    // Evaluate the gradient for this mini-batch.
+    // Evaluate the gradient for this mini-batch, take a step, and add the
+    // objective of the mini-batch to the overall objective function.
     const size_t offset = (shuffle) ? batchSize * visitationOrder[currentBatch]
         : batchSize * currentBatch;
-    function.Gradient(iterate, offset, gradient);
-    if (visitationOrder[currentBatch] != numBatches - 1)
-    {
-      for (size_t j = 1; j < batchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
-
-      // Now update the iterate.
-      iterate -= (stepSize / batchSize) * gradient;
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < batchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
-    else
-    {
-      // Handle last batch differently: it's not a full-size batch.
-      const size_t lastBatchSize = numFunctions - offset - 1;
-      for (size_t j = 1; j < lastBatchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
-
-      // Ensure the last batch size isn't zero, to avoid division by zero before
-      // updating.
-      if (lastBatchSize > 0)
-      {
-        // Now update the iterate.
-        iterate -= (stepSize / lastBatchSize) * gradient;
-      }
-      else
-      {
-        // Now update the iterate.
-        iterate -= stepSize * gradient;
-      }
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < lastBatchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
+    const bool lastBatch = (shuffle) ?
+        (visitationOrder[currentBatch] == numBatches - 1) :
+        (currentBatch == numBatches - 1);
+    overallObjective += Step<DecomposableFunctionType>(iterate, offset,
+        lastBatch, gradient);
   }
 
   Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations << ") "
@@ -150,6 +111,86 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
   return overallObjective;
 }
 
+template<typename DecomposableFunctionType>
+template<typename FunctionType>
+double MiniBatchSGD<DecomposableFunctionType>::Step(
+    arma::mat& iterate,
+    const size_t offset,
+    const bool lastBatch,
+    arma::mat& gradient,
+    const typename boost::enable_if_c<
+        HasBatchGradient<FunctionType>::value>::type*)
+{
+  // The last batch may be smaller than the others.
+  const size_t effectiveBatchSize = lastBatch ?
+      function.NumFunctions() - offset : batchSize;
+
+  function.Gradient(iterate, offset, gradient, effectiveBatchSize);
+  iterate -= (stepSize / effectiveBatchSize) * gradient;
+
+  return function.Evaluate(iterate, offset, effectiveBatchSize, true);
+}
+
+template<typename DecomposableFunctionType>
+template<typename FunctionType>
+double MiniBatchSGD<DecomposableFunctionType>::Step(
+    arma::mat& iterate,
+    const size_t offset,
+    const bool lastBatch,
+    arma::mat& gradient,
+    const typename boost::disable_if_c<
+        HasBatchGradient<FunctionType>::value>::type*)
+{
+  double objective = 0;
+  function.Gradient(iterate, offset, gradient);
+  if (!lastBatch)
+  {
+    for (size_t j = 1; j < batchSize; ++j)
+    {
+      arma::mat funcGradient;
+      function.Gradient(iterate, offset + j, funcGradient);
+      gradient += funcGradient;
+    }
+
+    // Now update the iterate.
+    iterate -= (stepSize / batchSize) * gradient;
+
+    // Add that to the overall objective function.
+    for (size_t j = 0; j < batchSize; ++j)
+      objective += function.Evaluate(iterate, offset + j);
+  }
+  else
+  {
+    // Handle last batch differently: it's not a full-size batch.
+    const size_t lastBatchSize = function.NumFunctions() - offset - 1;
+    for (size_t j = 1; j < lastBatchSize; ++j)
+    {
+      arma::mat funcGradient;
+      function.Gradient(iterate, offset + j, funcGradient);
+      gradient += funcGradient;
+    }
+
+    // Ensure the last batch size isn't zero, to avoid division by zero before
+    // updating.
+    if (lastBatchSize > 0)
+    {
+      // Now update the iterate.
+      iterate -= (stepSize / lastBatchSize) * gradient;
+    }
+    else
+    {
+      // Now update the iterate.
+      iterate -= stepSize * gradient;
+    }
+
+    // Add that to the overall objective function.
+    for (size_t j = 0; j < lastBatchSize; ++j)
+      objective += function.Evaluate(iterate, offset + j);
+  }
+
+  return objective;
+}
+
 } // namespace optimization
 } // namespace mlpack
 
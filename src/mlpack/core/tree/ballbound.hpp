@@ -194,6 +194,14 @@ struct BoundTraits<BallBound<MetricType, VecType>>
   const static bool HasTightBounds = false;
 };
 
+//! A specialization of BoundElemTraits for this bound type.
+template<typename MetricType, typename ElemType>
+struct BoundElemTraits<BallBound, MetricType, ElemType>
+{
+  //! The center is held in a dense vector of ElemType.
+  typedef BallBound<MetricType, arma::Col<ElemType>> Type;
+};
+
 } // namespace bound
 } // namespace mlpack
 
@@ -27,6 +27,12 @@ namespace tree /** Trees and tree-building procedures. */ {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * If OpenMP is available, large subtrees are built concurrently as OpenMP
+ * tasks, and the bounds of large nodes are computed in parallel.  The
+ * resulting tree, the ordering of the dataset, and the oldFromNew mapping are
+ * identical to those of a serial build.  The SplitType object is shared between
+ * tasks, so it must not hold any state that is modified during splitting.
+ *
  * @tparam MetricType The metric used for tree-building.  The BoundType may
  *     place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -34,7 +40,9 @@ namespace tree /** Trees and tree-building procedures. */ {
  * @tparam MatType The dataset class.
  * @tparam BoundType The bound used for each node.  HRectBound, the default,
  *     requires that an LMetric<> is used for MetricType (so, EuclideanDistance,
- *     ManhattanDistance, etc.).
+ *     ManhattanDistance, etc.).  The bound holds the element type of MatType
+ *     if BoundElemTraits is specialized for it (as it is for HRectBound and
+ *     BallBound).
  * @tparam SplitType The class that partitions the dataset/points at a
  *     particular node into two parts. Its definition decides the way this split
  *     is done.
@@ -53,6 +61,9 @@ class BinarySpaceTree
   typedef MatType Mat;
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
+  //! The type of bound held by each node, which stores ElemType.
+  typedef typename bound::BoundElemTraits<BoundType, MetricType,
+      ElemType>::Type TreeBoundType;
 
  private:
   //! The left child node.
@@ -68,7 +79,7 @@ class BinarySpaceTree
   //! children).
   size_t count;
   //! The bound object for this node.
-  BoundType<MetricType> bound;
+  TreeBoundType bound;
   //! Any extra data contained in the node.
   StatisticType stat;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -81,6 +92,15 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If this is the root of a compacted tree, the block of memory that holds
+  //! all of its descendants, in breadth-first order; otherwise NULL.
+  BinarySpaceTree* nodeArena;
+  //! The number of nodes held in nodeArena.
+  size_t arenaSize;
+
+  //! Subtrees (and blocks of points, when computing bounds) of at least this
+  //! size are processed as separate OpenMP tasks during construction.
+  static const size_t minParallelBuildSize = 16384;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -203,7 +223,7 @@ class BinarySpaceTree
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  SplitType<TreeBoundType, MatType>& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -228,7 +248,7 @@ class BinarySpaceTree
                   const size_t begin,
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  SplitType<TreeBoundType, MatType>& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -257,7 +277,7 @@ class BinarySpaceTree
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  SplitType<TreeBoundType, MatType>& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -291,10 +311,37 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move all of the descendants of this node into a single contiguous block of
+   * memory, in breadth-first order, so that the children of each node are
+   * adjacent and the upper levels of the tree are packed together.  This
+   * reduces cache misses when traversing large trees.  The structure of the
+   * tree is unchanged and any traverser can still be used with it, but
+   * pointers and references to the old descendant nodes are invalidated, and
+   * nodes of a compacted tree must not be deleted individually.  This may only
+   * be called on the root of the tree.
+   */
+  void Compact();
+
+  //! Return whether or not the descendants of this node are held in a
+  //! contiguous block of memory (see Compact()).
+  bool IsCompact() const { return nodeArena != NULL; }
+
+  /**
+   * Recompute the bounds, furthest descendant distances, parent distances, and
+   * statistics of this node and all of its descendants from the points they
+   * hold, without changing the structure of the tree.  After the points in the
+   * dataset have been modified in place (for instance, if they have each moved
+   * a little), this is much cheaper than building a new tree, and the tree
+   * remains valid for any traversal, although its nodes may overlap more than
+   * those of a new tree on the modified points would.
+   */
+  void RefitBounds();
+
   //! Return the bound object for this node.
-  const BoundType<MetricType>& Bound() const { return bound; }
+  const TreeBoundType& Bound() const { return bound; }
   //! Return the bound object for this node.
-  BoundType<MetricType>& Bound() { return bound; }
+  TreeBoundType& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -454,9 +501,22 @@ class BinarySpaceTree
   static bool HasSelfChildren() { return false; }
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) { bound.Center(center); }
 
  private:
+  /**
+   * Destroy all of the nodes held in nodeArena and release its memory.  The
+   * links from this node to its children are not touched.
+   */
+  void FreeNodeArena();
+
+  /**
+   * Expand the bound of this node so that it contains every point held in the
+   * node.  For large nodes with tight bounds, the points are split into blocks
+   * that are bounded by separate OpenMP tasks and then merged.
+   */
+  void UpdateBound();
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
@@ -464,7 +524,7 @@ class BinarySpaceTree
    * @param splitter Instantiated SplitType object.
    */
   void SplitNode(const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<TreeBoundType, MatType>& splitter);
 
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -476,7 +536,7 @@ class BinarySpaceTree
    */
   void SplitNode(std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 SplitType<TreeBoundType, MatType>& splitter);
 
  protected:
   /**
@@ -35,11 +35,18 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -63,7 +70,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -71,8 +80,13 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -97,7 +111,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -105,8 +121,13 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -132,11 +153,18 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -160,7 +188,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -168,8 +198,13 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -194,7 +229,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -202,8 +239,13 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  SplitType<TreeBoundType, MatType> splitter;
+  // Large subtrees are built as OpenMP tasks by the threads of this team.
+  #pragma omp parallel if (count >= minParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -225,7 +267,7 @@ BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
     const size_t count,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    SplitType<TreeBoundType, MatType>& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -233,7 +275,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -254,7 +298,7 @@ BinarySpaceTree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    SplitType<TreeBoundType, MatType>& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -262,7 +306,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -288,7 +334,7 @@ BinarySpaceTree(
     const size_t count,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    SplitType<TreeBoundType, MatType>& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -296,7 +342,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -337,7 +385,9 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodeArena(NULL), // The copy is not compacted.
+    arenaSize(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -395,12 +445,16 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodeArena(other.nodeArena),
+    arenaSize(other.arenaSize)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
   other.left = NULL;
   other.right = NULL;
+  other.nodeArena = NULL;
+  other.arenaSize = 0;
   other.begin = 0;
   other.count = 0;
   other.parentDistance = 0.0;
@@ -444,6 +498,14 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   ~BinarySpaceTree()
 {
+  // If the descendants are held in an arena, they can't be deleted one by one.
+  if (nodeArena)
+  {
+    left = NULL;
+    right = NULL;
+    FreeNodeArena();
+  }
+
   delete left;
   delete right;
 
@@ -628,6 +690,49 @@ inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   return (begin + index);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    UpdateBound()
+{
+  if (count == 0)
+    return;
+
+  // A loose bound may depend on the order in which points are added to it, so
+  // it must be computed serially.  A tight bound is the union of the bounds of
+  // any partition of the points, so large nodes can be handled in blocks.
+  if (!bound::BoundTraits<TreeBoundType>::HasTightBounds ||
+      count < 2 * minParallelBuildSize)
+  {
+    bound |= dataset->cols(begin, begin + count - 1);
+    return;
+  }
+
+  const size_t numBlocks = (count + minParallelBuildSize - 1) /
+      minParallelBuildSize;
+  std::vector<TreeBoundType> blockBounds(numBlocks,
+      TreeBoundType(dataset->n_rows));
+
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    #pragma omp task shared(blockBounds)
+    {
+      const size_t blockBegin = begin + b * minParallelBuildSize;
+      const size_t blockEnd = std::min(blockBegin + minParallelBuildSize,
+          begin + count);
+      blockBounds[b] |= dataset->cols(blockBegin, blockEnd - 1);
+    }
+  }
+  #pragma omp taskwait
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    bound |= blockBounds[b];
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -636,11 +741,10 @@ template<typename MetricType,
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
-              SplitType<BoundType<MetricType>, MatType>& splitter)
+              SplitType<TreeBoundType, MatType>& splitter)
 {
   // We need to expand the bounds of this node properly.
-  if (count > 0)
-    bound |= dataset->cols(begin, begin + count - 1);
+  UpdateBound();
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -665,14 +769,19 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // children hold disjoint ranges of the dataset, so a large left subtree can
+  // be built in a separate task while this thread builds the right subtree.
+  #pragma omp task if (splitCol - begin >= minParallelBuildSize) \
+      shared(splitter)
   left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
       maxLeafSize);
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -694,12 +803,11 @@ template<typename MetricType,
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
-          SplitType<BoundType<MetricType>, MatType>& splitter)
+          SplitType<TreeBoundType, MatType>& splitter)
 {
   // This should be a single function for Bound.
   // We need to expand the bounds of this node properly.
-  if (count > 0)
-    bound |= dataset->cols(begin, begin + count - 1);
+  UpdateBound();
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -724,14 +832,20 @@ SplitNode(std::vector<size_t>& oldFromNew,
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // children only touch their own ranges of the dataset and of oldFromNew, so a
+  // large left subtree can be built in a separate task while this thread builds
+  // the right subtree.
+  #pragma omp task if (splitCol - begin >= minParallelBuildSize) \
+      shared(oldFromNew, splitter)
   left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
       splitter, maxLeafSize);
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       oldFromNew, splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -744,6 +858,139 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitBounds()
+{
+  // The statistics of a node may depend on those of its children, so the
+  // children must be refit first.
+  if (left)
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+  }
+
+  bound = TreeBoundType(dataset->n_rows);
+  UpdateBound();
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left)
+  {
+    arma::Col<ElemType> center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+    right->ParentDistance() = MetricType::Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent != NULL)
+    throw std::invalid_argument("BinarySpaceTree::Compact(): only the root of "
+        "a tree can be compacted");
+
+  // Collect the descendants in breadth-first order.  Each node's two children
+  // are added together, so they will be adjacent in the arena.
+  std::vector<BinarySpaceTree*> nodes;
+  std::vector<size_t> parentIndices; // rootIndex marks children of the root.
+  const size_t rootIndex = size_t(-1);
+  if (left)
+  {
+    nodes.push_back(left);
+    nodes.push_back(right);
+    parentIndices.push_back(rootIndex);
+    parentIndices.push_back(rootIndex);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->left)
+    {
+      nodes.push_back(nodes[i]->left);
+      nodes.push_back(nodes[i]->right);
+      parentIndices.push_back(i);
+      parentIndices.push_back(i);
+    }
+  }
+
+  if (nodes.empty())
+    return;
+
+  // Move every node into the arena.  The moved-from nodes keep no children, so
+  // they can be freed without touching the rest of the tree.
+  BinarySpaceTree* arena = static_cast<BinarySpaceTree*>(
+      ::operator new(nodes.size() * sizeof(BinarySpaceTree)));
+  for (size_t i = 0; i < nodes.size(); ++i)
+    new (arena + i) BinarySpaceTree(std::move(*nodes[i]));
+
+  // Now fix the links between nodes.  Children were added in (left, right)
+  // pairs, so even indices are left children.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BinarySpaceTree* newParent = (parentIndices[i] == rootIndex) ? this :
+        arena + parentIndices[i];
+    arena[i].parent = newParent;
+    if (i % 2 == 0)
+      newParent->left = arena + i;
+    else
+      newParent->right = arena + i;
+  }
+
+  // Free the old nodes.
+  if (nodeArena)
+  {
+    FreeNodeArena();
+  }
+  else
+  {
+    for (size_t i = 0; i < nodes.size(); ++i)
+      delete nodes[i];
+  }
+
+  nodeArena = arena;
+  arenaSize = nodes.size();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    FreeNodeArena()
+{
+  // Each node in the arena is destroyed in place; its children are in the
+  // arena too, so they must not be deleted by its destructor.
+  for (size_t i = 0; i < arenaSize; ++i)
+  {
+    nodeArena[i].left = NULL;
+    nodeArena[i].right = NULL;
+    nodeArena[i].~BinarySpaceTree();
+  }
+
+  ::operator delete(nodeArena);
+  nodeArena = NULL;
+  arenaSize = 0;
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -761,7 +1008,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodeArena(NULL),
+    arenaSize(0)
 {
   // Nothing to do.
 }
@@ -784,6 +1033,13 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
+    if (nodeArena)
+    {
+      left = NULL;
+      right = NULL;
+      FreeNodeArena();
+    }
+
     if (left)
       delete left;
     if (right)
@@ -17,6 +17,24 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * This gives us a HasBaseCaseBlockCheck object that we can use to tell whether
+ * or not a RuleType can evaluate a block of base cases at once.
+ */
+HAS_MEM_FUNC(BaseCaseBlock, HasBaseCaseBlockCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * BaseCaseBlock(const arma::uvec& queryIndices, const size_t referenceBegin,
+ *               const size_t referenceCount).
+ */
+template<typename RuleType>
+struct HasBaseCaseBlock
+{
+  static const bool value = HasBaseCaseBlockCheck<RuleType,
+      void(RuleType::*)(const arma::uvec&, const size_t, const size_t)>::value;
+};
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -64,6 +82,26 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   size_t& NumBaseCases() { return numBaseCases; }
 
  private:
+  /**
+   * Evaluate the base cases between two leaves by handing every unpruned query
+   * point to RuleType::BaseCaseBlock() at once.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const typename boost::enable_if<
+                         HasBaseCaseBlock<Rule>>::type* = 0);
+
+  /**
+   * Evaluate the base cases between two leaves one pair at a time, for rules
+   * that do not provide BaseCaseBlock().
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const typename boost::disable_if<
+                         HasBaseCaseBlock<Rule>>::type* = 0);
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -54,25 +54,7 @@ DualTreeTraverser<RuleType>::Traverse(
   // If both are leaves, we must evaluate the base case.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
-    // Loop through each of the points in each node.
-    const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
-    {
-      // See if we need to investigate this point (this function should be
-      // implemented for the single-tree recursion too).  Restore the traversal
-      // information first.
-      rule.TraversalInfo() = traversalInfo;
-      const double childScore = rule.Score(query, referenceNode);
-
-      if (childScore == DBL_MAX)
-        continue; // We can't improve this particular point.
-
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
-
-      numBaseCases += referenceNode.Count();
-    }
+    LeafBaseCases(queryNode, referenceNode);
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
            (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants() &&
@@ -335,6 +317,86 @@ DualTreeTraverser<RuleType>::Traverse(
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+template<typename Rule>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DualTreeTraverser<RuleType>::LeafBaseCases(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode,
+    const typename boost::enable_if<HasBaseCaseBlock<Rule>>::type*)
+{
+  // Find the query points that can't be pruned, then evaluate all of their
+  // base cases with the reference points in one block.
+  arma::uvec queryIndices(queryNode.Count());
+  size_t numQueries = 0;
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    // Restore the traversal information before scoring each point.
+    rule.TraversalInfo() = traversalInfo;
+    const double childScore = rule.Score(query, referenceNode);
+
+    if (childScore == DBL_MAX)
+      continue; // We can't improve this particular point.
+
+    queryIndices[numQueries++] = query;
+  }
+
+  if (numQueries == 0)
+    return;
+
+  queryIndices.resize(numQueries);
+  rule.BaseCaseBlock(queryIndices, referenceNode.Begin(),
+      referenceNode.Count());
+
+  numBaseCases += numQueries * referenceNode.Count();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+template<typename Rule>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DualTreeTraverser<RuleType>::LeafBaseCases(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode,
+    const typename boost::disable_if<HasBaseCaseBlock<Rule>>::type*)
+{
+  // Loop through each of the points in each node.
+  const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+  {
+    // See if we need to investigate this point (this function should be
+    // implemented for the single-tree recursion too).  Restore the traversal
+    // information first.
+    rule.TraversalInfo() = traversalInfo;
+    const double childScore = rule.Score(query, referenceNode);
+
+    if (childScore == DBL_MAX)
+      continue; // We can't improve this particular point.
+
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+      rule.BaseCase(query, ref);
+
+    numBaseCases += referenceNode.Count();
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -26,6 +26,22 @@ struct BoundTraits
   static const bool HasTightBounds = false;
 };
 
+/**
+ * A class to obtain the type of a bound that holds elements of type ElemType,
+ * so that a tree can store bounds of the same precision as its dataset.  By
+ * default the bound is instantiated with only the metric (and so uses its
+ * default element type).  If you are writing your own BoundType class that can
+ * hold different element types, you should make a template specialization.
+ */
+template<template<typename BoundMetricType, typename...> class BoundType,
+         typename MetricType,
+         typename ElemType>
+struct BoundElemTraits
+{
+  //! The type of the bound.
+  typedef BoundType<MetricType> Type;
+};
+
 } // namespace bound
 } // namespace mlpack
 
@@ -210,6 +210,14 @@ struct BoundTraits<HRectBound<MetricType, ElemType>>
   const static bool HasTightBounds = true;
 };
 
+// A specialization of BoundElemTraits for this class.
+template<typename MetricType, typename ElemType>
+struct BoundElemTraits<HRectBound, MetricType, ElemType>
+{
+  //! The bounds for each dimension hold ElemType.
+  typedef HRectBound<MetricType, ElemType> Type;
+};
+
 } // namespace bound
 } // namespace mlpack
 
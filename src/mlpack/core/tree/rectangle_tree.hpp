@@ -23,6 +23,8 @@
 #include "rectangle_tree/r_star_tree_descent_heuristic.hpp"
 #include "rectangle_tree/traits.hpp"
 #include "rectangle_tree/x_tree_split.hpp"
+#include "rectangle_tree/str_packing.hpp"
+#include "rectangle_tree/hilbert_packing.hpp"
 #include "rectangle_tree/typedef.hpp"
 
 #endif
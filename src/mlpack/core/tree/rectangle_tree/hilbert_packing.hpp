@@ -0,0 +1,76 @@
+/**
+ * @file hilbert_packing.hpp
+ *
+ * Definition of the HilbertPacking class, which orders points along a Hilbert
+ * curve for bulk-loading a RectangleTree.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The Hilbert packing strategy for bulk-loading a RectangleTree.  The bounding
+ * box of the points is discretized into a grid, each point is mapped to its
+ * position along the Hilbert curve that passes through every cell of the grid,
+ * and the points are sorted by that position.  Because the Hilbert curve
+ * preserves locality, consecutive runs of points in the resulting order form
+ * compact nodes.  For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{kamel1993packing,
+ *   title={On packing R-trees},
+ *   author={Kamel, I. and Faloutsos, C.},
+ *   booktitle={Proceedings of the Second International Conference on
+ *       Information and Knowledge Management (CIKM '93)},
+ *   pages={490--499},
+ *   year={1993}
+ * }
+ * @endcode
+ *
+ * The Hilbert positions are computed with the transposition algorithm of
+ * Skilling ("Programming the Hilbert curve", AIP Conference Proceedings 707,
+ * 2004), using as many bits per dimension as an unsigned int holds.
+ */
+class HilbertPacking
+{
+ public:
+  /**
+   * Compute the order in which the given points should be packed into nodes.
+   * The node capacity is not needed to order points along the Hilbert curve,
+   * but it is accepted so that HilbertPacking and STRPacking are
+   * interchangeable.
+   *
+   * @param points Points to be packed (one per column).
+   * @param nodeCapacity Number of points that will be packed into each node.
+   * @param order Vector to store the packing order of the points in.
+   */
+  template<typename MatType>
+  static void Order(const MatType& points,
+                    const size_t nodeCapacity,
+                    std::vector<size_t>& order);
+
+ private:
+  /**
+   * Convert the given grid coordinates (one per dimension) into the transposed
+   * representation of their Hilbert index, in-place.  The bits of the Hilbert
+   * index are the bits of the transposed coordinates, interleaved from the most
+   * significant bit of the first dimension downwards.
+   *
+   * @param coordinates Grid coordinates to transform.
+   * @param dimensions Number of dimensions.
+   */
+  static void AxesToTranspose(unsigned int* coordinates,
+                              const size_t dimensions);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "hilbert_packing_impl.hpp"
+
+#endif
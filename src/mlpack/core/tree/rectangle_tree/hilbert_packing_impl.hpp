@@ -0,0 +1,124 @@
+/**
+ * @file hilbert_packing_impl.hpp
+ *
+ * Implementation of the HilbertPacking class.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_IMPL_HPP
+
+#include "hilbert_packing.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void HilbertPacking::Order(const MatType& points,
+                           const size_t /* nodeCapacity */,
+                           std::vector<size_t>& order)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t dims = points.n_rows;
+  order.resize(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    order[i] = i;
+
+  if (points.n_cols == 0 || dims == 0)
+    return;
+
+  // Find the bounding box of the points, so that it can be discretized.
+  std::vector<ElemType> lo(dims, std::numeric_limits<ElemType>::max());
+  std::vector<ElemType> hi(dims, std::numeric_limits<ElemType>::lowest());
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const ElemType val = points(d, i);
+      if (val < lo[d])
+        lo[d] = val;
+      if (val > hi[d])
+        hi[d] = val;
+    }
+  }
+
+  // Map each point onto the grid, then into its position on the Hilbert curve.
+  const double gridMax = (double) std::numeric_limits<unsigned int>::max();
+  std::vector<unsigned int> keys(dims * points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    unsigned int* key = &keys[i * dims];
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const double width = (double) hi[d] - (double) lo[d];
+      key[d] = (width > 0) ? (unsigned int) (((double) points(d, i) -
+          (double) lo[d]) / width * gridMax) : 0;
+    }
+
+    AxesToTranspose(key, dims);
+  }
+
+  // Now sort by Hilbert index.  The first differing bit of the interleaved
+  // transposed coordinates decides the order.
+  const int numBits = std::numeric_limits<unsigned int>::digits;
+  std::sort(order.begin(), order.end(),
+      [&keys, dims, numBits](const size_t a, const size_t b)
+      {
+        const unsigned int* keyA = &keys[a * dims];
+        const unsigned int* keyB = &keys[b * dims];
+        for (int bit = numBits - 1; bit >= 0; --bit)
+        {
+          for (size_t d = 0; d < dims; ++d)
+          {
+            const unsigned int bitA = (keyA[d] >> bit) & 1;
+            const unsigned int bitB = (keyB[d] >> bit) & 1;
+            if (bitA != bitB)
+              return bitA < bitB;
+          }
+        }
+
+        return false;
+      });
+}
+
+inline void HilbertPacking::AxesToTranspose(unsigned int* coordinates,
+                                            const size_t dimensions)
+{
+  const unsigned int m = 1u << (std::numeric_limits<unsigned int>::digits - 1);
+
+  // Inverse undo excess work.
+  for (unsigned int q = m; q > 1; q >>= 1)
+  {
+    const unsigned int p = q - 1;
+    for (size_t i = 0; i < dimensions; ++i)
+    {
+      if (coordinates[i] & q)
+      {
+        coordinates[0] ^= p; // Invert.
+      }
+      else
+      {
+        // Exchange.
+        const unsigned int t = (coordinates[0] ^ coordinates[i]) & p;
+        coordinates[0] ^= t;
+        coordinates[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode.
+  for (size_t i = 1; i < dimensions; ++i)
+    coordinates[i] ^= coordinates[i - 1];
+
+  unsigned int t = 0;
+  for (unsigned int q = m; q > 1; q >>= 1)
+    if (coordinates[dimensions - 1] & q)
+      t ^= q - 1;
+
+  for (size_t i = 0; i < dimensions; ++i)
+    coordinates[i] ^= t;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
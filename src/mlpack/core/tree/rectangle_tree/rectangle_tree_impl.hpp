@@ -96,6 +96,74 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename> class SplitType,
+         typename DescentType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    localDataset(new MatType(arma::zeros<MatType>(data.n_rows,
+                                                  maxLeafSize + 1)))
+{
+  split = SplitType<RectangleTree>(this);
+
+  BulkLoad(bulkLoad);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename> class SplitType,
+         typename DescentType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    localDataset(new MatType(arma::zeros<MatType>(dataset->n_rows,
+                                                  maxLeafSize + 1)))
+{
+  split = SplitType<RectangleTree>(this);
+
+  BulkLoad(bulkLoad);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -681,6 +749,135 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
   }
 }
 
+/**
+ * Bulk-load the tree.  The points are ordered with the packing strategy and cut
+ * into leaves; the centers of each level of nodes are then ordered the same way
+ * and cut into parents, until the remaining nodes fit into the root.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename> class SplitType,
+         typename DescentType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+    BulkLoad(const BulkLoadType bulkLoad)
+{
+  const size_t numPoints = dataset->n_cols;
+
+  // If all the points fit into a single leaf, the root is that leaf.
+  if (numPoints <= maxLeafSize)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      localDataset->col(i) = dataset->col(i);
+      points[count++] = i;
+    }
+
+    if (numPoints > 0)
+      bound |= *dataset;
+
+    FinishPackedNode();
+    return;
+  }
+
+  std::vector<size_t> order;
+  if (bulkLoad == STR_PACKING)
+    STRPacking::Order(*dataset, maxLeafSize, order);
+  else
+    HilbertPacking::Order(*dataset, maxLeafSize, order);
+
+  // Cut the ordered points into leaves.  The points are spread as evenly as
+  // possible, so that no leaf is left nearly empty at the end; STRPacking cuts
+  // its slabs at the same boundaries.
+  const size_t numLeaves = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  std::vector<RectangleTree*> nodes(numLeaves);
+  for (size_t l = 0; l < numLeaves; ++l)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    const size_t first = (l * numPoints) / numLeaves;
+    const size_t last = ((l + 1) * numPoints) / numLeaves;
+    for (size_t i = first; i < last; ++i)
+    {
+      leaf->localDataset->col(leaf->count) = dataset->col(order[i]);
+      leaf->points[leaf->count++] = order[i];
+    }
+
+    leaf->bound |= leaf->localDataset->cols(0, leaf->count - 1);
+    leaf->FinishPackedNode();
+    nodes[l] = leaf;
+  }
+
+  // Now pack each level of nodes into parents until they fit into the root.
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::mat centers(dataset->n_rows, nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      arma::vec center;
+      nodes[i]->Center(center);
+      centers.col(i) = center;
+    }
+
+    if (bulkLoad == STR_PACKING)
+      STRPacking::Order(centers, maxNumChildren, order);
+    else
+      HilbertPacking::Order(centers, maxNumChildren, order);
+
+    const size_t numParents = (nodes.size() + maxNumChildren - 1) /
+        maxNumChildren;
+    std::vector<RectangleTree*> parents(numParents);
+    for (size_t p = 0; p < numParents; ++p)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      const size_t first = (p * nodes.size()) / numParents;
+      const size_t last = ((p + 1) * nodes.size()) / numParents;
+      for (size_t i = first; i < last; ++i)
+      {
+        RectangleTree* child = nodes[order[i]];
+        child->parent = node;
+        node->children[node->numChildren++] = child;
+        node->bound |= child->bound;
+      }
+
+      node->FinishPackedNode();
+      parents[p] = node;
+    }
+
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    nodes[i]->parent = this;
+    children[numChildren++] = nodes[i];
+    bound |= nodes[i]->bound;
+  }
+
+  FinishPackedNode();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename> class SplitType,
+         typename DescentType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+    FinishPackedNode()
+{
+  if (numChildren > 0)
+  {
+    arma::vec center, childCenter;
+    Center(center);
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      children[i]->Center(childCenter);
+      children[i]->parentDistance = MetricType::Evaluate(center, childCenter);
+    }
+  }
+
+  stat = StatisticType(*this);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,76 @@
+/**
+ * @file str_packing.hpp
+ *
+ * Definition of the STRPacking class, which orders points for bulk-loading a
+ * RectangleTree with the Sort-Tile-Recursive algorithm.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The Sort-Tile-Recursive (STR) packing strategy for bulk-loading a
+ * RectangleTree.  The points are sorted along the first dimension and cut into
+ * vertical slabs; each slab is then sorted along the second dimension and cut
+ * into smaller slabs, and so forth, until the last dimension is reached.
+ *
+ * The resulting order is meant to be cut evenly into L = ceil(n / nodeCapacity)
+ * nodes, where node l holds the positions floor(l * n / L) up to
+ * floor((l + 1) * n / L) - 1.  The slabs are cut at these same boundaries, so
+ * each node is a compact tile inside one slab.  For more information, see the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, S.T. and Lopez, M.A. and Edgington, J.},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering (ICDE '97)},
+ *   pages={497--506},
+ *   year={1997}
+ * }
+ * @endcode
+ */
+class STRPacking
+{
+ public:
+  /**
+   * Compute the order in which the given points should be packed into nodes
+   * that each hold at most nodeCapacity points (cut evenly as described
+   * above).
+   *
+   * @param points Points to be packed (one per column).
+   * @param nodeCapacity Maximum number of points packed into each node.
+   * @param order Vector to store the packing order of the points in.
+   */
+  template<typename MatType>
+  static void Order(const MatType& points,
+                    const size_t nodeCapacity,
+                    std::vector<size_t>& order);
+
+ private:
+  /**
+   * Sort the points of the nodes firstNode, ..., lastNode - 1 along the given
+   * dimension, then cut these nodes into slabs and recurse into each slab with
+   * the next dimension.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& points,
+                   const size_t numNodes,
+                   const size_t dimension,
+                   const size_t firstNode,
+                   const size_t lastNode,
+                   std::vector<size_t>& order);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "str_packing_impl.hpp"
+
+#endif
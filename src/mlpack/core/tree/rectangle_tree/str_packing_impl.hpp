@@ -0,0 +1,66 @@
+/**
+ * @file str_packing_impl.hpp
+ *
+ * Implementation of the STRPacking class.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_IMPL_HPP
+
+#include "str_packing.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void STRPacking::Order(const MatType& points,
+                       const size_t nodeCapacity,
+                       std::vector<size_t>& order)
+{
+  order.resize(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    order[i] = i;
+
+  if (points.n_cols > 0 && points.n_rows > 0)
+  {
+    const size_t numNodes = (points.n_cols + nodeCapacity - 1) / nodeCapacity;
+    Tile(points, numNodes, 0, 0, numNodes, order);
+  }
+}
+
+template<typename MatType>
+void STRPacking::Tile(const MatType& points,
+                      const size_t numNodes,
+                      const size_t dimension,
+                      const size_t firstNode,
+                      const size_t lastNode,
+                      std::vector<size_t>& order)
+{
+  // The points of these nodes, with the nodes cut evenly from the order.
+  const size_t begin = (firstNode * points.n_cols) / numNodes;
+  const size_t end = (lastNode * points.n_cols) / numNodes;
+  std::sort(order.begin() + begin, order.begin() + end,
+      [&points, dimension](const size_t a, const size_t b)
+      { return points(dimension, a) < points(dimension, b); });
+
+  // If this is the last dimension or everything fits in one node, we're done.
+  const size_t count = lastNode - firstNode;
+  if (dimension == points.n_rows - 1 || count <= 1)
+    return;
+
+  // With k dimensions left to tile, cutting the nodes into ceil(P^(1 / k))
+  // slabs (where P is the number of nodes) gives roughly square tiles.
+  const size_t numSlabs = (size_t) std::ceil(std::pow((double) count,
+      1.0 / (points.n_rows - dimension)));
+  const size_t slabNodes = (count + numSlabs - 1) / numSlabs;
+
+  for (size_t slab = firstNode; slab < lastNode; slab += slabNodes)
+  {
+    Tile(points, numNodes, dimension + 1, slab,
+        std::min(slab + slabNodes, lastNode), order);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
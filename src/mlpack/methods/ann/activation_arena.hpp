@@ -0,0 +1,365 @@
+/**
+ * @file activation_arena.hpp
+ *
+ * Definition of the ActivationArena class, which stores the activations and
+ * deltas of all layers of a network in one block of memory.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_ARENA_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_ARENA_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The ActivationArena holds the input parameter, output parameter and delta of
+ * every layer of a network in a single block of memory.  Before a pass, each
+ * layer buffer is made an alias of a region of the arena with exactly the
+ * shape the layer writes into it, so the layers keep writing their results
+ * into the same buffers as usual, but the results end up in the arena: the
+ * buffers are not reallocated by every pass and they are adjacent in memory.
+ *
+ * The shapes of the buffers are recorded after each pass, for the shape of the
+ * input of that pass and for training and inference separately.  A later pass
+ * of the same kind with an input of the same shape finds every buffer in place;
+ * any other pass lets the layers allocate their buffers themselves, and the
+ * pass after it can use the arena.
+ * If a layer writes a result of another shape anyway, the buffer is simply
+ * reallocated, as for any other matrix.
+ *
+ * The arena plans the regions from the lifetime of each buffer:
+ *
+ *  - For training, the activations and deltas of every layer are needed by
+ *    the backward pass and by the gradient, so every buffer gets its own
+ *    region.
+ *  - For inference, a layer only reads the output of the previous layer, so
+ *    the outputs of consecutive layers alternate between two regions, and the
+ *    inputs of all layers (which are only read by the first layer) share one
+ *    region.  The deltas are not used and are released.
+ *
+ * The size of each region is the largest size of the buffer seen so far, so
+ * the arena only grows when a pass needs more memory than any previous pass
+ * (for instance for a larger batch), and alternating between batches and
+ * single points doesn't allocate anything.
+ *
+ * Only buffers of type arma::mat and arma::cube are placed in the arena; any
+ * other buffer (such as an arma::sp_mat) is left to the layer.
+ *
+ * @code
+ * ActivationArena arena;
+ *
+ * arena.Prepare(network, input, true);
+ * // Forward and backward pass through the network...
+ * arena.Record(network);
+ * @endcode
+ */
+class ActivationArena
+{
+ public:
+  //! Create an empty arena.
+  ActivationArena() : trainingPass(false) { }
+
+  /**
+   * Point the buffers of every layer of the given network into the arena.
+   * This should be called before every pass through the network.
+   *
+   * @param network The layers of the network.
+   * @param input The input of the pass.
+   * @param training If true, every buffer gets its own region; otherwise the
+   *     regions are shared as described above, and only a forward pass may
+   *     follow.
+   */
+  template<typename InputType, typename... Tp>
+  void Prepare(std::tuple<Tp...>& network,
+               const InputType& input,
+               const bool training)
+  {
+    const size_t layers = sizeof...(Tp);
+
+    // Record() needs to know which plan the pass belongs to.
+    trainingPass = training;
+
+    // Nothing is known about the buffers before the first pass.
+    if (capacity.size() != 3 * layers)
+      return;
+
+    // Without the shapes of the buffers the layers allocate them, and they
+    // mustn't keep using the regions planned for another pass.
+    const std::map<std::vector<size_t>, std::vector<size_t> >::const_iterator
+        plan = shapes.find(Key(input, training));
+    if (plan == shapes.end())
+    {
+      ReleaseLayers(network);
+      return;
+    }
+
+    size_t size = 0;
+    offset.resize(capacity.size());
+    if (training)
+    {
+      for (size_t i = 0; i < capacity.size(); ++i)
+      {
+        offset[i] = size;
+        size += capacity[i];
+      }
+    }
+    else
+    {
+      size_t inputSize = 0, outputSize = 0;
+      for (size_t l = 0; l < layers; ++l)
+      {
+        inputSize = std::max(inputSize, capacity[3 * l]);
+        outputSize = std::max(outputSize, capacity[3 * l + 1]);
+      }
+
+      for (size_t l = 0; l < layers; ++l)
+      {
+        offset[3 * l] = 0;
+        offset[3 * l + 1] = inputSize + (l % 2) * outputSize;
+        offset[3 * l + 2] = 0;
+      }
+
+      size = inputSize + 2 * outputSize;
+    }
+
+    // Every buffer that used the old memory is pointed into the new memory
+    // below (or released), so the arena can safely be reallocated.
+    if (memory.n_elem < size)
+      memory.set_size(size);
+
+    PrepareLayers(network, plan->second, training);
+  }
+
+  /**
+   * Record the shape of every buffer of the given network after a pass, so
+   * that the next call to Prepare() for the same kind of pass with an input of
+   * the same shape can place them.
+   *
+   * @param network The layers of the network.
+   */
+  template<typename... Tp>
+  void Record(std::tuple<Tp...>& network)
+  {
+    if (capacity.size() != 3 * sizeof...(Tp))
+      capacity.assign(3 * sizeof...(Tp), 0);
+
+    // The first layer holds the input of the pass.
+    std::vector<size_t>& plan = shapes[Key(
+        std::get<0>(network).InputParameter(), trainingPass)];
+    plan.resize(3 * capacity.size());
+
+    RecordLayers(network, plan);
+  }
+
+  /**
+   * Stop the buffers of every layer of the given network from using the arena.
+   * This has to be called before the arena is destroyed if the layers outlive
+   * it.  The contents of the released buffers are lost.
+   *
+   * @param network The layers of the network.
+   */
+  template<typename... Tp>
+  void Release(std::tuple<Tp...>& network)
+  {
+    if (capacity.size() == 3 * sizeof...(Tp))
+      ReleaseLayers(network);
+  }
+
+  //! Get the number of elements of the arena.
+  size_t Size() const { return memory.n_elem; }
+
+ private:
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  PrepareLayers(std::tuple<Tp...>& /* unused */,
+                const std::vector<size_t>& /* unused */,
+                const bool /* unused */)
+  { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  PrepareLayers(std::tuple<Tp...>& network,
+                const std::vector<size_t>& plan,
+                const bool training)
+  {
+    Alias(std::get<I>(network).InputParameter(), 3 * I, plan);
+    Alias(std::get<I>(network).OutputParameter(), 3 * I + 1, plan);
+
+    if (training)
+      Alias(std::get<I>(network).Delta(), 3 * I + 2, plan);
+    else
+      Detach(std::get<I>(network).Delta(), 3 * I + 2);
+
+    PrepareLayers<I + 1, Tp...>(network, plan, training);
+  }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  RecordLayers(std::tuple<Tp...>& /* unused */,
+               std::vector<size_t>& /* unused */)
+  { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  RecordLayers(std::tuple<Tp...>& network, std::vector<size_t>& plan)
+  {
+    RecordBuffer(std::get<I>(network).InputParameter(), 3 * I, plan);
+    RecordBuffer(std::get<I>(network).OutputParameter(), 3 * I + 1, plan);
+    RecordBuffer(std::get<I>(network).Delta(), 3 * I + 2, plan);
+
+    RecordLayers<I + 1, Tp...>(network, plan);
+  }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  ReleaseLayers(std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  ReleaseLayers(std::tuple<Tp...>& network)
+  {
+    Detach(std::get<I>(network).InputParameter(), 3 * I);
+    Detach(std::get<I>(network).OutputParameter(), 3 * I + 1);
+    Detach(std::get<I>(network).Delta(), 3 * I + 2);
+
+    ReleaseLayers<I + 1, Tp...>(network);
+  }
+
+  /**
+   * Make the given buffer an alias of its region of the arena, with the shape
+   * recorded in the given plan.  The result of the layer has the same shape,
+   * so it is written into the region; the alias is not strict, so a result of
+   * any other shape is written into newly allocated memory instead.
+   */
+  template<typename T>
+  void Alias(T& buffer, const size_t index, const std::vector<size_t>& plan)
+  {
+    if (capacity[index] == 0)
+      return;
+
+    const size_t rows = plan[3 * index];
+    const size_t cols = plan[3 * index + 1];
+    const size_t slices = plan[3 * index + 2];
+    if (rows * cols * slices == 0)
+      Detach(buffer, index);
+    else
+      Alias(buffer, memory.memptr() + offset[index], rows, cols, slices);
+  }
+
+  static void Alias(arma::mat& buffer,
+                    double* region,
+                    const size_t rows,
+                    const size_t cols,
+                    const size_t /* slices */)
+  {
+    buffer = arma::mat(region, rows, cols, false, false);
+  }
+
+  static void Alias(arma::cube& buffer,
+                    double* region,
+                    const size_t rows,
+                    const size_t cols,
+                    const size_t slices)
+  {
+    buffer = arma::cube(region, rows, cols, slices, false, false);
+  }
+
+  template<typename T>
+  static void Alias(T& /* unused */,
+                    double* /* unused */,
+                    const size_t /* unused */,
+                    const size_t /* unused */,
+                    const size_t /* unused */)
+  { /* Nothing to do here */ }
+
+  /**
+   * Make sure the given buffer doesn't use the arena anymore.  A reset alias
+   * has no elements, so the next result written into it is allocated.
+   */
+  void Detach(arma::mat& buffer, const size_t index)
+  {
+    if (capacity[index] > 0)
+      buffer.reset();
+  }
+
+  void Detach(arma::cube& buffer, const size_t index)
+  {
+    if (capacity[index] > 0)
+      buffer.reset();
+  }
+
+  template<typename T>
+  void Detach(T& /* unused */, const size_t /* unused */)
+  { /* Nothing to do here */ }
+
+  /**
+   * Store the shape of the given buffer in the given plan, and grow its region
+   * if necessary.  A buffer that isn't placed in the arena has no elements.
+   */
+  template<typename T>
+  void RecordBuffer(const T& buffer,
+                    const size_t index,
+                    std::vector<size_t>& plan)
+  {
+    const std::vector<size_t> shape = Shape(buffer);
+    std::copy(shape.begin(), shape.end(), plan.begin() + 3 * index);
+    capacity[index] = std::max(capacity[index],
+        shape[0] * shape[1] * shape[2]);
+  }
+
+  //! Return the number of rows, columns and slices of a buffer or an input.
+  template<typename eT>
+  static std::vector<size_t> Shape(const arma::Mat<eT>& buffer)
+  {
+    return { buffer.n_rows, buffer.n_cols, 1 };
+  }
+
+  template<typename eT>
+  static std::vector<size_t> Shape(const arma::Cube<eT>& buffer)
+  {
+    return { buffer.n_rows, buffer.n_cols, buffer.n_slices };
+  }
+
+  template<typename eT>
+  static std::vector<size_t> Shape(const arma::subview_cube<eT>& buffer)
+  {
+    return { buffer.n_rows, buffer.n_cols, buffer.n_slices };
+  }
+
+  template<typename T>
+  static std::vector<size_t> Shape(const T& /* unused */)
+  {
+    return { 0, 0, 0 };
+  }
+
+  //! Return the key of the plan for the given input and kind of pass.
+  template<typename InputType>
+  static std::vector<size_t> Key(const InputType& input, const bool training)
+  {
+    std::vector<size_t> key = Shape(input);
+    key.push_back(training);
+    return key;
+  }
+
+  //! The memory of the arena.
+  arma::vec memory;
+
+  //! The largest size of each buffer (input, output and delta of each layer).
+  std::vector<size_t> capacity;
+
+  //! The offset of the region of each buffer in the arena.
+  std::vector<size_t> offset;
+
+  //! The shape of each buffer after the last pass, for each shape of input
+  //! and kind of pass.
+  std::map<std::vector<size_t>, std::vector<size_t> > shapes;
+
+  //! Whether the last pass that was prepared is a training pass.
+  bool trainingPass;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
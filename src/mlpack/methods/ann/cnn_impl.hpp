@@ -54,6 +54,8 @@ CNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("cnn_optimization");
 
+  ResetGradients(this->network);
+
   Log::Info << "CNN::CNN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -116,6 +118,17 @@ CNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   NetworkWeights(parameter, this->network);
 }
 
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+CNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::~CNN()
+{
+  arena.Release(network);
+}
+
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
@@ -137,6 +150,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("cnn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "CNN::CNN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -162,6 +177,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("cnn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "CNN::CNN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -183,6 +200,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("cnn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "CNN::CNN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -199,7 +218,11 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   deterministic = true;
 
   arma::mat responsesTemp;
-  ResetParameter(network);
+  ResetParameter(network, deterministic);
+
+  // Only the forward pass follows, so the arena can reuse the activations of
+  // the earlier layers.
+  arena.Prepare(network, predictors.slices(0, 0), false);
   Forward(predictors.slices(0, 0), network);
   OutputPrediction(responsesTemp, network);
 
@@ -215,6 +238,69 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     OutputPrediction(responsesTemp, network);
     responses.col(i) = responsesTemp.col(0);
   }
+
+  arena.Record(network);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+typename CNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Workspace* CNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::CreateWorkspace() const
+{
+  // The workspace only ever reads the parameters.
+  arma::mat sharedParameter(const_cast<double*>(parameter.memptr()),
+      parameter.n_rows, parameter.n_cols, false, true);
+
+  Workspace* workspace = new Workspace(network, outputLayer);
+
+  // Share the weights instead of keeping a copy.  A workspace never computes
+  // a gradient, so it doesn't need the gradients at all.
+  NetworkWeights(sharedParameter, workspace->network);
+  ResetGradients(workspace->network);
+  ResetParameter(workspace->network, true);
+
+  return workspace;
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+void CNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Predict(const arma::cube& predictors,
+           arma::mat& responses,
+           Workspace& workspace) const
+{
+  arma::mat responsesTemp;
+  for (size_t i = 0; i < predictors.n_slices; i++)
+  {
+    if (i == 0)
+    {
+      workspace.arena.Prepare(workspace.network, predictors.slices(0, 0),
+          false);
+    }
+
+    Forward(predictors.slices(i, i), workspace.network);
+
+    workspace.outputLayer.OutputClass(std::get<std::tuple_size<
+        LayerTypes>::value - 1>(workspace.network).OutputParameter(),
+        responsesTemp);
+
+    if (i == 0)
+      responses.set_size(responsesTemp.n_elem, predictors.n_slices);
+
+    responses.col(i) = responsesTemp.col(0);
+  }
+
+  workspace.arena.Record(workspace.network);
 }
 
 template<typename LayerTypes,
@@ -230,8 +316,11 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 {
   this->deterministic = deterministic;
 
-  ResetParameter(network);
+  ResetParameter(network, deterministic);
+  arena.Prepare(network, predictors.slices(i, i), true);
+
   Forward(predictors.slices(i, i), network);
+  arena.Record(network);
 
   return OutputError(arma::mat(responses.colptr(i), responses.n_rows, 1, false,
       true), error, network);
@@ -254,6 +343,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 
   Backward<>(error, network);
   UpdateGradients<>(network);
+
+  arena.Record(network);
 }
 
 template<typename LayerTypes,
@@ -0,0 +1,335 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col and matrix multiplication.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/core.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering it to a matrix
+ * multiplication. Every patch of the input that the filter is applied to is
+ * unrolled into one column of a matrix (im2col), so that the convolution with
+ * one or more filters becomes a single BLAS matrix product. This is much
+ * faster than the NaiveConvolution for the small filters that are typically
+ * used in convolutional networks; the FFTConvolution and SVDConvolution are
+ * better suited for large filters.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * The ConvLayer recognizes this rule and then lowers the convolution over all
+ * input and output maps to one matrix multiplication in each of the forward,
+ * backward and gradient passes, using the Im2Col() and Col2Im() functions.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid or full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Mat<eT>& output)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, filter.n_rows, filter.n_cols, 1, 1,
+        Padding(filter.n_rows), Padding(filter.n_cols), columns);
+
+    output.set_size(input.n_rows + 2 * Padding(filter.n_rows) -
+        filter.n_rows + 1, input.n_cols + 2 * Padding(filter.n_cols) -
+        filter.n_cols + 1);
+
+    arma::Col<eT> outputCol(output.memptr(), output.n_elem, false, true);
+    outputCol = arma::trans(columns) * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i));
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output. The input is unrolled only once, and all filters are
+   * applied with a single matrix multiplication.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, filter.n_rows, filter.n_cols, 1, 1,
+        Padding(filter.n_rows), Padding(filter.n_cols), columns);
+
+    output.set_size(input.n_rows + 2 * Padding(filter.n_rows) -
+        filter.n_rows + 1, input.n_cols + 2 * Padding(filter.n_cols) -
+        filter.n_cols + 1, filter.n_slices);
+
+    // Each slice of the filter (and the output) is one column of these
+    // matrices.
+    const arma::Mat<eT> filterMat(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols, filter.n_slices, false, true);
+    arma::Mat<eT> outputMat(output.memptr(), output.n_rows * output.n_cols,
+        output.n_slices, false, true);
+    outputMat = arma::trans(columns) * filterMat;
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i));
+    }
+  }
+
+  /**
+   * Unroll every patch of the (zero-padded) input that a filter of the given
+   * size is applied to into one column of the given matrix. The column for the
+   * output position (i, j) is stored at index (i + j * outputRows), and holds
+   * the patch of every input map, one after the other, in column-major order.
+   * So the multi-channel convolution with a filter is the product of the
+   * transposed matrix with the filter unrolled in the same order.
+   *
+   * @param input Input maps, one per slice.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param strideRows Stride of the filter along the rows.
+   * @param strideCols Stride of the filter along the columns.
+   * @param padRows Number of zero rows added on each side of the input.
+   * @param padCols Number of zero columns added on each side of the input.
+   * @param columns Matrix in which the unrolled patches are stored.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t padRows,
+                     const size_t padCols,
+                     arma::Mat<eT>& columns)
+  {
+    const size_t outputRows = (input.n_rows + 2 * padRows - filterRows) /
+        strideRows + 1;
+    const size_t outputCols = (input.n_cols + 2 * padCols - filterCols) /
+        strideCols + 1;
+
+    columns.zeros(filterRows * filterCols * input.n_slices,
+        outputRows * outputCols);
+
+    #pragma omp parallel for schedule(static)
+    for (intmax_t j = 0; j < (intmax_t) outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        eT* columnPtr = columns.colptr(i + j * outputRows);
+        for (size_t s = 0; s < input.n_slices; ++s)
+        {
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            // The column of the padded input; padded positions stay zero.
+            const size_t col = j * strideCols + kj;
+            if (col < padCols || col - padCols >= input.n_cols)
+            {
+              columnPtr += filterRows;
+              continue;
+            }
+
+            const eT* inputPtr = input.slice_colptr(s, col - padCols);
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr)
+            {
+              const size_t row = i * strideRows + ki;
+              if (row >= padRows && row - padRows < input.n_rows)
+                *columnPtr = inputPtr[row - padRows];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * The inverse of Im2Col(): sum every element of the given unrolled patches
+   * back into the position of the input it was taken from. The output has to
+   * be set to the size of the input maps; its contents are overwritten.
+   *
+   * @param columns Unrolled patches, as created by Im2Col().
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param strideRows Stride of the filter along the rows.
+   * @param strideCols Stride of the filter along the columns.
+   * @param padRows Number of zero rows added on each side of the input.
+   * @param padCols Number of zero columns added on each side of the input.
+   * @param output Input maps in which the patches are accumulated.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t padRows,
+                     const size_t padCols,
+                     arma::Cube<eT>& output)
+  {
+    const size_t outputRows = (output.n_rows + 2 * padRows - filterRows) /
+        strideRows + 1;
+    const size_t outputCols = (output.n_cols + 2 * padCols - filterCols) /
+        strideCols + 1;
+    const size_t patchSize = filterRows * filterCols;
+
+    output.zeros();
+
+    // Each slice only receives the rows of its own patches, so the slices can
+    // be accumulated independently.
+    #pragma omp parallel for schedule(static)
+    for (intmax_t s = 0; s < (intmax_t) output.n_slices; ++s)
+    {
+      for (size_t j = 0; j < outputCols; ++j)
+      {
+        for (size_t i = 0; i < outputRows; ++i)
+        {
+          const eT* columnPtr = columns.colptr(i + j * outputRows) +
+              s * patchSize;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            const size_t col = j * strideCols + kj;
+            if (col < padCols || col - padCols >= output.n_cols)
+            {
+              columnPtr += filterRows;
+              continue;
+            }
+
+            eT* outputPtr = output.slice_colptr(s, col - padCols);
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr)
+            {
+              const size_t row = i * strideRows + ki;
+              if (row >= padRows && row - padRows < output.n_rows)
+                outputPtr[row - padRows] += *columnPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  /*
+   * Return the padding of each side of the input for the valid mode.
+   *
+   * @param filterSize The size of the filter (rows or columns).
+   */
+  template<typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, size_t>::type
+  Padding(const size_t /* filterSize */)
+  {
+    return 0;
+  }
+
+  /*
+   * Return the padding of each side of the input for the full mode.
+   *
+   * @param filterSize The size of the filter (rows or columns).
+   */
+  template<typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, size_t>::type
+  Padding(const size_t filterSize)
+  {
+    return filterSize - 1;
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Determine whether the given convolution rule is the Im2ColConvolution, in
+ * which case the ConvLayer lowers the convolution over all maps to one matrix
+ * multiplication.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+//! The Im2ColConvolution with any border mode.
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -10,9 +10,12 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/ann/network_util.hpp>
+#include <mlpack/methods/ann/activation_arena.hpp>
+#include <mlpack/methods/ann/inference_workspace.hpp>
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/performance_functions/cee_function.hpp>
+#include <mlpack/methods/ann/performance_functions/performance_function_traits.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
 
 namespace mlpack {
@@ -108,6 +111,13 @@ class FFN
       InitializationRuleType initializeRule = InitializationRuleType(),
       PerformanceFunction performanceFunction = PerformanceFunction());
 
+  /**
+   * Destroy the FFN object.  If the layers are stored by reference (for
+   * instance with std::tie()), they outlive the network, so their activations
+   * and deltas are taken out of the arena of the network first.
+   */
+  ~FFN();
+
   /**
    * Train the feedforward network on the given input data. By default, the
    * RMSprop optimization algorithm is used, but others can be specified
@@ -165,13 +175,44 @@ class FFN
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
-   * OutputClass() function.
+   * OutputClass() function.  All of the predictors are propagated through the
+   * network at once, as a batch.
    *
    * @param predictors Input predictors.
    * @param responses Matrix to put output predictions of responses into.
    */
   void Predict(arma::mat& predictors, arma::mat& responses);
 
+  //! Type of the workspace used by the thread-safe Predict() overload.
+  typedef InferenceWorkspace<LayerTypes, OutputLayerType> Workspace;
+
+  /**
+   * Create a workspace for the thread-safe Predict() overload.  The workspace
+   * holds a copy of every layer, but the weights of the copies are aliases of
+   * the parameters of this network, so they are shared and not cloned.  The
+   * caller is responsible for deleting the workspace; it can only be used as
+   * long as the parameters of this network are not reallocated (for instance
+   * by training or loading the network).  Usually the InferenceHandle class is
+   * simpler to use.
+   *
+   * @return New workspace.
+   */
+  Workspace* CreateWorkspace() const;
+
+  /**
+   * Predict the responses to a given set of predictors, storing all of the
+   * intermediate activations in the given workspace instead of the layers of
+   * this network.  This does not modify the network, so several threads can
+   * call it at the same time, as long as each uses its own workspace.
+   *
+   * @param predictors Input predictors.
+   * @param responses Matrix to put output predictions of responses into.
+   * @param workspace Workspace created by CreateWorkspace().
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& responses,
+               Workspace& workspace) const;
+
   /**
    * Evaluate the feedforward network with the given parameters. This function
    * is usually called by the optimizer to train the model.
@@ -198,6 +239,40 @@ class FFN
                 const size_t i,
                 arma::mat& gradient);
 
+  /**
+   * Evaluate the feedforward network with the given parameters on the batch of
+   * points begin, ..., begin + batchSize - 1.  The whole batch is propagated
+   * through each layer at once, so every linear layer is a single matrix
+   * product.  For performance functions which sum over the points (such as the
+   * cross-entropy error), this is the sum of the objectives of each point.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param deterministic Whether or not to train or test the model. Note some
+   * layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given parameters
+   * on the batch of points begin, ..., begin + batchSize - 1.  The gradients of
+   * the points in the batch are summed.  This is used by mini-batch optimizers
+   * such as mlpack::optimization::MiniBatchSGD.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
@@ -221,24 +296,25 @@ private:
    */
   template<size_t I = 0, typename... Tp>
   typename std::enable_if<I == sizeof...(Tp), void>::type
-  ResetParameter(std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+  ResetParameter(std::tuple<Tp...>& /* unused */,
+                 const bool /* unused */) const { /* Nothing to do here */ }
 
   template<size_t I = 0, typename... Tp>
   typename std::enable_if<I < sizeof...(Tp), void>::type
-  ResetParameter(std::tuple<Tp...>& network)
+  ResetParameter(std::tuple<Tp...>& network, const bool deterministic) const
   {
-    ResetDeterministic(std::get<I>(network));
-    ResetParameter<I + 1, Tp...>(network);
+    ResetDeterministic(std::get<I>(network), deterministic);
+    ResetParameter<I + 1, Tp...>(network, deterministic);
   }
 
   /**
-   * Reset the layer status by setting the current deterministic parameter
+   * Reset the layer status by setting the given deterministic parameter
    * through all layer that implement the Deterministic function.
    */
   template<typename T>
   typename std::enable_if<
       HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
-  ResetDeterministic(T& layer)
+  ResetDeterministic(T& layer, const bool deterministic) const
   {
     layer.Deterministic() = deterministic;
   }
@@ -246,7 +322,43 @@ private:
   template<typename T>
   typename std::enable_if<
       !HasDeterministicCheck<T, bool&(T::*)(void)>::value, void>::type
-  ResetDeterministic(T& /* unused */) { /* Nothing to do here */ }
+  ResetDeterministic(T& /* unused */, const bool /* unused */) const
+  { /* Nothing to do here */ }
+
+  /**
+   * Detach the gradient of every layer from the memory it aliases.  After
+   * training, the layer gradients still alias the gradient of the optimizer,
+   * which doesn't exist anymore; reset() doesn't touch that memory, and
+   * Gradient() aliases the layer gradients again.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  ResetGradients(std::tuple<Tp...>& /* unused */) const
+  { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  ResetGradients(std::tuple<Tp...>& network) const
+  {
+    ResetGradient(std::get<I>(network));
+    ResetGradients<I + 1, Tp...>(network);
+  }
+
+  template<typename T>
+  typename std::enable_if<
+      HasGradientCheck<T, arma::mat&(T::*)()>::value ||
+      HasGradientCheck<T, arma::cube&(T::*)()>::value, void>::type
+  ResetGradient(T& layer) const
+  {
+    layer.Gradient().reset();
+  }
+
+  template<typename T>
+  typename std::enable_if<
+      !HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+      !HasGradientCheck<T, arma::cube&(T::*)()>::value, void>::type
+  ResetGradient(T& /* unused */) const
+  { /* Nothing to do here */ }
 
   /**
    * Run a single iteration of the feed forward algorithm, using the given
@@ -254,7 +366,7 @@ private:
    * vector.
    */
   template<size_t I = 0, typename DataType, typename... Tp>
-  void Forward(const DataType& input, std::tuple<Tp...>& network)
+  void Forward(const DataType& input, std::tuple<Tp...>& network) const
   {
     std::get<I>(network).InputParameter() = input;
 
@@ -266,42 +378,40 @@ private:
 
   template<size_t I = 1, typename... Tp>
   typename std::enable_if<I == sizeof...(Tp), void>::type
-  ForwardTail(std::tuple<Tp...>& network)
-  {
-    LinkParameter(network);
-  }
+  ForwardTail(std::tuple<Tp...>& /* unused */) const
+  { /* Nothing to do here */ }
 
   template<size_t I = 1, typename... Tp>
   typename std::enable_if<I < sizeof...(Tp), void>::type
-  ForwardTail(std::tuple<Tp...>& network)
+  ForwardTail(std::tuple<Tp...>& network) const
   {
     std::get<I>(network).Forward(std::get<I - 1>(network).OutputParameter(),
                            std::get<I>(network).OutputParameter());
 
+    // The activation is linked right away, because the arena may reuse the
+    // output of the previous layer for the output of the next layer.
+    LinkParameter(std::get<I - 1>(network), std::get<I>(network));
+
     ForwardTail<I + 1, Tp...>(network);
   }
 
   /**
    * Link the calculated activation with the connection layer.
    */
-  template<size_t I = 1, typename... Tp>
-  typename std::enable_if<I == sizeof...(Tp), void>::type
-  LinkParameter(std::tuple<Tp ...>& /* unused */) { /* Nothing to do here */ }
-
-  template<size_t I = 1, typename... Tp>
-  typename std::enable_if<I < sizeof...(Tp), void>::type
-  LinkParameter(std::tuple<Tp...>& network)
+  template<typename PreviousLayerType, typename LayerType>
+  typename std::enable_if<
+      !LayerTraits<LayerType>::IsBiasLayer, void>::type
+  LinkParameter(PreviousLayerType& previousLayer, LayerType& layer) const
   {
-    if (!LayerTraits<typename std::remove_reference<
-        decltype(std::get<I>(network))>::type>::IsBiasLayer)
-    {
-      std::get<I>(network).InputParameter() = std::get<I - 1>(
-          network).OutputParameter();
-    }
-
-    LinkParameter<I + 1, Tp...>(network);
+    layer.InputParameter() = previousLayer.OutputParameter();
   }
 
+  template<typename PreviousLayerType, typename LayerType>
+  typename std::enable_if<
+      LayerTraits<LayerType>::IsBiasLayer, void>::type
+  LinkParameter(PreviousLayerType& /* unused */, LayerType& /* unused */) const
+  { /* Nothing to do here */ }
+
   /*
    * Calculate the output error and update the overall error.
    */
@@ -431,6 +541,9 @@ private:
 
   //! Locally stored backward error.
   arma::mat error;
+
+  //! The memory of the layer activations and deltas.
+  ActivationArena arena;
 }; // class FFN
 
 } // namespace ann
@@ -54,6 +54,8 @@ FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("ffn_optimization");
 
+  ResetGradients(this->network);
+
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -116,6 +118,17 @@ FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   NetworkWeights(parameter, this->network);
 }
 
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::~FFN()
+{
+  arena.Release(network);
+}
+
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
@@ -137,6 +150,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("ffn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -162,6 +177,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("ffn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -183,6 +200,8 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
   const double out = optimizer.Optimize(parameter);
   Timer::Stop("ffn_optimization");
 
+  ResetGradients(network);
+
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
 }
@@ -198,25 +217,59 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 {
   deterministic = true;
 
-  arma::mat responsesTemp;
-  ResetParameter(network);
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true),
-      network);
-  OutputPrediction(responsesTemp, network);
+  ResetParameter(network, deterministic);
 
-  responses = arma::mat(responsesTemp.n_elem, predictors.n_cols);
-  responses.col(0) = responsesTemp.col(0);
+  // Only the forward pass follows, so the arena can reuse the activations of
+  // the earlier layers.
+  arena.Prepare(network, predictors, false);
+  Forward(predictors, network);
+  OutputPrediction(responses, network);
+  arena.Record(network);
+}
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
-  {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true),
-        network);
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+typename FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Workspace* FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::CreateWorkspace() const
+{
+  // The workspace only ever reads the parameters.
+  arma::mat sharedParameter(const_cast<double*>(parameter.memptr()),
+      parameter.n_rows, parameter.n_cols, false, true);
 
-    responsesTemp = arma::mat(responses.colptr(i), responses.n_rows, 1, false,
-        true);
-    OutputPrediction(responsesTemp, network);
-    responses.col(i) = responsesTemp.col(0);
-  }
+  Workspace* workspace = new Workspace(network, outputLayer);
+
+  // Share the weights instead of keeping a copy.  A workspace never computes
+  // a gradient, so it doesn't need the gradients at all.
+  NetworkWeights(sharedParameter, workspace->network);
+  ResetGradients(workspace->network);
+  ResetParameter(workspace->network, true);
+
+  return workspace;
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+void FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Predict(const arma::mat& predictors,
+           arma::mat& responses,
+           Workspace& workspace) const
+{
+  workspace.arena.Prepare(workspace.network, predictors, false);
+  Forward(predictors, workspace.network);
+
+  workspace.outputLayer.OutputClass(std::get<std::tuple_size<
+      LayerTypes>::value - 1>(workspace.network).OutputParameter(), responses);
+  workspace.arena.Record(workspace.network);
 }
 
 template<typename LayerTypes,
@@ -232,10 +285,12 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 {
   this->deterministic = deterministic;
 
-  ResetParameter(network);
+  ResetParameter(network, deterministic);
+  arma::mat input(predictors.colptr(i), predictors.n_rows, 1, false, true);
+  arena.Prepare(network, input, true);
 
-  Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true),
-      network);
+  Forward(input, network);
+  arena.Record(network);
 
   return OutputError(arma::mat(responses.colptr(i), responses.n_rows, 1, false,
       true), error, network);
@@ -264,6 +319,71 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 
   Backward<>(error, network);
   UpdateGradients<>(network);
+
+  arena.Record(network);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+double FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Evaluate(const arma::mat& /* unused */,
+            const size_t begin,
+            const size_t batchSize,
+            const bool deterministic)
+{
+  this->deterministic = deterministic;
+
+  ResetParameter(network, deterministic);
+  // The columns of the batch are contiguous, so they can be used in place.
+  arma::mat input(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true);
+  arena.Prepare(network, input, true);
+
+  Forward(input, network);
+  arena.Record(network);
+
+  const double batchError = OutputError(arma::mat(responses.colptr(begin),
+      responses.n_rows, batchSize, false, true), error, network);
+
+  // The objective of a batch is the sum of the objectives of its points, so
+  // that it is on the same scale as the objectives summed point by point.
+  if (PerformanceFunctionTraits<PerformanceFunction>::IsMean)
+    return batchError * batchSize;
+
+  return batchError;
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+void FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Gradient(const arma::mat& /* unused */,
+            const size_t begin,
+            arma::mat& gradient,
+            const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+
+  Evaluate(parameter, begin, batchSize, false);
+
+  NetworkGradients(gradient, network);
+
+  // Each layer sums the gradients of the points of the batch with a single
+  // matrix product.
+  Backward<>(error, network);
+  UpdateGradients<>(network);
+
+  arena.Record(network);
 }
 
 template<typename LayerTypes,
@@ -0,0 +1,108 @@
+/**
+ * @file inference_handle.hpp
+ *
+ * Definition of the InferenceHandle class, which allows a trained network to
+ * be queried from many threads at once.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_HANDLE_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_HANDLE_HPP
+
+#include <mlpack/core.hpp>
+
+#include <mutex>
+#include <condition_variable>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A read-only handle to a trained network (FFN or CNN) that can be used to
+ * compute predictions from several threads at the same time.  The Predict()
+ * function of a network stores the activations in its own layers, so a network
+ * can only compute one prediction at a time.  The InferenceHandle instead
+ * creates a fixed number of workspaces when it is constructed; each workspace
+ * holds its own copy of the layer buffers, but the weights of every workspace
+ * are aliases of the parameters of the network, so the model is not cloned.
+ *
+ * Each call to Predict() takes a free workspace, computes the prediction in it,
+ * and returns it.  If every workspace is in use, Predict() waits until one is
+ * returned, so the number of workspaces is the number of predictions that can
+ * run in parallel.  The workspaces are reused by later calls, so the layer
+ * buffers are only allocated again when the size of the input changes.
+ *
+ * The network must outlive the handle, and its parameters must not be modified
+ * (for instance by training or loading the network) while the handle exists.
+ *
+ * @code
+ * extern FFN<...> network; // A trained network.
+ *
+ * InferenceHandle<FFN<...> > handle(network);
+ *
+ * // In each request thread:
+ * arma::mat responses;
+ * handle.Predict(predictors, responses);
+ * @endcode
+ *
+ * @tparam NetworkType Type of the network (FFN or CNN).
+ */
+template<typename NetworkType>
+class InferenceHandle
+{
+ public:
+  /**
+   * Create the handle and all of its workspaces.
+   *
+   * @param network Trained network to compute the predictions with.
+   * @param workspaces Number of predictions that can be computed at the same
+   *     time.  If 0, the number of hardware threads is used.
+   */
+  InferenceHandle(const NetworkType& network, const size_t workspaces = 0);
+
+  //! Free the workspaces.
+  ~InferenceHandle();
+
+  //! The workspaces alias the parameters of the network, so they can't be
+  //! copied.
+  InferenceHandle(const InferenceHandle& other) = delete;
+  //! The workspaces alias the parameters of the network, so they can't be
+  //! copied.
+  InferenceHandle& operator=(const InferenceHandle& other) = delete;
+
+  /**
+   * Predict the responses to the given set of predictors, as the Predict()
+   * function of the network does.  This function is thread-safe.
+   *
+   * @param predictors Input predictors (arma::mat for FFN, arma::cube for
+   *     CNN).
+   * @param responses Matrix to put output predictions of responses into.
+   */
+  template<typename PredictorsType>
+  void Predict(const PredictorsType& predictors, arma::mat& responses) const;
+
+  //! Get the number of workspaces.
+  size_t Workspaces() const { return workspaces.size(); }
+
+ private:
+  //! The network used to compute the predictions.
+  const NetworkType& network;
+
+  //! The workspaces in which the predictions are computed.
+  std::vector<typename NetworkType::Workspace*> workspaces;
+
+  //! The indices of the workspaces that are not in use.
+  mutable std::vector<size_t> available;
+
+  //! Mutex protecting the list of available workspaces.
+  mutable std::mutex mutex;
+
+  //! Signaled whenever a workspace is returned.
+  mutable std::condition_variable workspaceReturned;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "inference_handle_impl.hpp"
+
+#endif
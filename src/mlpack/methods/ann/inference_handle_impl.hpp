@@ -0,0 +1,83 @@
+/**
+ * @file inference_handle_impl.hpp
+ *
+ * Implementation of the InferenceHandle class.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_HANDLE_IMPL_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_HANDLE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "inference_handle.hpp"
+
+#include <thread>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename NetworkType>
+InferenceHandle<NetworkType>::InferenceHandle(const NetworkType& network,
+                                              const size_t workspaces) :
+    network(network)
+{
+  const size_t count = (workspaces != 0) ? workspaces :
+      std::max((size_t) std::thread::hardware_concurrency(), (size_t) 1);
+
+  this->workspaces.resize(count);
+  available.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    this->workspaces[i] = network.CreateWorkspace();
+    available[i] = i;
+  }
+}
+
+template<typename NetworkType>
+InferenceHandle<NetworkType>::~InferenceHandle()
+{
+  for (size_t i = 0; i < workspaces.size(); ++i)
+    delete workspaces[i];
+}
+
+template<typename NetworkType>
+template<typename PredictorsType>
+void InferenceHandle<NetworkType>::Predict(const PredictorsType& predictors,
+                                           arma::mat& responses) const
+{
+  // Take a free workspace, or wait until one is returned.
+  size_t index;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (available.empty())
+      workspaceReturned.wait(lock);
+
+    index = available.back();
+    available.pop_back();
+  }
+
+  // The lock is only held to take and return the workspace, so the
+  // predictions themselves run in parallel.
+  try
+  {
+    network.Predict(predictors, responses, *workspaces[index]);
+  }
+  catch (...)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      available.push_back(index);
+    }
+    workspaceReturned.notify_one();
+    throw;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    available.push_back(index);
+  }
+  workspaceReturned.notify_one();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file inference_workspace.hpp
+ *
+ * Definition of the InferenceWorkspace class, which holds the layer buffers
+ * used to compute a prediction with a network without modifying it.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_WORKSPACE_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_WORKSPACE_HPP
+
+#include <mlpack/core.hpp>
+
+#include <mlpack/methods/ann/activation_arena.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The InferenceWorkspace holds a copy of every layer of a network and of its
+ * output layer, so that the activations of a prediction are stored in the
+ * workspace (in its own ActivationArena) instead of the network.  The network
+ * (FFN or CNN) aliases the weights of the copied layers into its own
+ * parameters, so the parameters are shared by the network and all of its
+ * workspaces.  Use
+ * NetworkType::CreateWorkspace() to create a workspace, or the InferenceHandle
+ * class, which manages a set of workspaces.
+ *
+ * @tparam LayerTypes Type of the layers of the network (a std::tuple, possibly
+ *     of references).
+ * @tparam OutputLayerType Type of the output layer of the network.
+ */
+template<typename LayerTypes, typename OutputLayerType>
+class InferenceWorkspace;
+
+template<typename... Tp, typename OutputLayerType>
+class InferenceWorkspace<std::tuple<Tp...>, OutputLayerType>
+{
+ public:
+  //! Type of the copied layers.
+  typedef std::tuple<typename std::decay<Tp>::type...> NetworkType;
+
+  //! Type of the copied output layer.
+  typedef typename std::decay<OutputLayerType>::type OutputType;
+
+  /**
+   * Copy the given layers and output layer.
+   *
+   * @param network Layers of the network.
+   * @param outputLayer Output layer of the network.
+   */
+  InferenceWorkspace(const std::tuple<Tp...>& network,
+                     const OutputType& outputLayer) :
+      network(network),
+      outputLayer(outputLayer)
+  { /* Nothing to do here. */ }
+
+  //! Locally-stored copy of the layers of the network.
+  NetworkType network;
+
+  //! Locally-stored copy of the output layer of the network.
+  OutputType outputLayer;
+
+  //! The memory of the activations of the copied layers.
+  ActivationArena arena;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
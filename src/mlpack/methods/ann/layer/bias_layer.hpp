@@ -57,7 +57,9 @@ class BiasLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
-    output = input + (weights * bias);
+    // Each column of the input is a separate point.
+    output = input;
+    output.each_col() += weights * bias;
   }
 
   /**
@@ -106,7 +108,8 @@ class BiasLayer
                 const ErrorType& error,
                 GradientType& gradient)
   {
-    gradient = error * bias;
+    // For a batch of points (one per column) the gradients are summed.
+    gradient = arma::sum(error, 1) * bias;
   }
 
   //! Get the weights.
@@ -11,6 +11,7 @@
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -19,6 +20,13 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the ConvLayer class. The ConvLayer class represents a
  * single layer of a neural network.
  *
+ * If a convolution rule is the Im2ColConvolution, the corresponding pass
+ * (forward, backward or gradient) unrolls the input into a matrix of patches
+ * and computes the convolution over all input and output maps with a single
+ * matrix multiplication, instead of convolving every pair of maps separately.
+ * The border mode of the Im2ColConvolution is then implied by the pass, and
+ * the stride and padding of the layer are taken into account.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -80,21 +88,7 @@ class ConvLayer
   template<typename eT>
   void Forward(const arma::Cube<eT>& input, arma::Cube<eT>& output)
   {
-    const size_t wConv = ConvOutSize(input.n_rows, wfilter, xStride, wPad);
-    const size_t hConv = ConvOutSize(input.n_cols, hfilter, yStride, hPad);
-
-    output = arma::zeros<arma::Cube<eT> >(wConv, hConv, outMaps);
-    for (size_t outMap = 0, outMapIdx = 0; outMap < outMaps; outMap++)
-    {
-      for (size_t inMap = 0; inMap < inMaps; inMap++, outMapIdx++)
-      {
-        arma::Mat<eT> convOutput;
-        ForwardConvolutionRule::Convolution(input.slice(inMap),
-            weights.slice(outMap), convOutput);
-
-        output.slice(outMap) += convOutput;
-      }
-    }
+    ForwardConvolution<ForwardConvolutionRule>(input, output);
   }
 
   /**
@@ -111,24 +105,7 @@ class ConvLayer
                 const arma::Cube<eT>& gy,
                 arma::Cube<eT>& g)
   {
-    g = arma::zeros<arma::Cube<eT> >(inputParameter.n_rows,
-                                     inputParameter.n_cols,
-                                     inputParameter.n_slices);
-
-    for (size_t outMap = 0, outMapIdx = 0; outMap < inMaps; outMap++)
-    {
-      for (size_t inMap = 0; inMap < outMaps; inMap++, outMapIdx++)
-      {
-        arma::Mat<eT> rotatedFilter;
-        Rotate180(weights.slice(outMap * outMaps + inMap), rotatedFilter);
-
-        arma::Mat<eT> output;
-        BackwardConvolutionRule::Convolution(gy.slice(inMap), rotatedFilter,
-            output);
-
-        g.slice(outMap) += output;
-      }
-    }
+    BackwardConvolution<BackwardConvolutionRule>(gy, g);
   }
 
   /*
@@ -143,23 +120,7 @@ class ConvLayer
                 const arma::Cube<eT>& d,
                 arma::Cube<eT>& g)
   {
-    g = arma::zeros<arma::Cube<eT> >(weights.n_rows, weights.n_cols,
-        weights.n_slices);
-
-    for (size_t outMap = 0; outMap < outMaps; outMap++)
-    {
-      for (size_t inMap = 0, s = outMap; inMap < inMaps; inMap++, s += outMaps)
-      {
-        arma::Cube<eT> inputSlices = input.slices(inMap, inMap);
-        arma::Cube<eT> deltaSlices = d.slices(outMap, outMap);
-
-        arma::Cube<eT> output;
-        GradientConvolutionRule::Convolution(inputSlices, deltaSlices, output);
-
-        for (size_t i = 0; i < output.n_slices; i++)
-          g.slice(s) += output.slice(i);
-      }
-    }
+    GradientConvolution<GradientConvolutionRule>(input, d, g);
   }
 
   //! Get the weights.
@@ -205,6 +166,187 @@ class ConvLayer
   }
 
  private:
+  /*
+   * Convolve every pair of input and output maps with the given rule (forward
+   * pass).
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<!IsIm2ColConvolution<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input, arma::Cube<eT>& output)
+  {
+    const size_t wConv = ConvOutSize(input.n_rows, wfilter, xStride, wPad);
+    const size_t hConv = ConvOutSize(input.n_cols, hfilter, yStride, hPad);
+
+    output = arma::zeros<arma::Cube<eT> >(wConv, hConv, outMaps);
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outMaps; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inMaps; inMap++, outMapIdx++)
+      {
+        arma::Mat<eT> convOutput;
+        Rule::Convolution(input.slice(inMap),
+            weights.slice(inMap * outMaps + outMap), convOutput);
+
+        output.slice(outMap) += convOutput;
+      }
+    }
+  }
+
+  /*
+   * Compute the forward pass with a single matrix multiplication of the
+   * unrolled input patches and the filters of all maps.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<IsIm2ColConvolution<Rule>::value, void>::type
+  ForwardConvolution(const arma::Cube<eT>& input, arma::Cube<eT>& output)
+  {
+    const size_t wConv = ConvOutSize(input.n_rows, wfilter, xStride, wPad);
+    const size_t hConv = ConvOutSize(input.n_cols, hfilter, yStride, hPad);
+
+    arma::Mat<eT> columns, filters;
+    Rule::Im2Col(input, wfilter, hfilter, xStride, yStride, wPad, hPad,
+        columns);
+    FilterMatrix(filters);
+
+    // Each output map is one column of the product, so it can be written
+    // directly into the memory of the output.
+    output.set_size(wConv, hConv, outMaps);
+    arma::Mat<eT> outputMat(output.memptr(), wConv * hConv, outMaps, false,
+        true);
+    outputMat = arma::trans(columns) * filters;
+  }
+
+  /*
+   * Convolve every pair of input and output maps with the given rule (backward
+   * pass).
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<!IsIm2ColConvolution<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& gy, arma::Cube<eT>& g)
+  {
+    g = arma::zeros<arma::Cube<eT> >(inputParameter.n_rows,
+                                     inputParameter.n_cols,
+                                     inputParameter.n_slices);
+
+    for (size_t outMap = 0, outMapIdx = 0; outMap < inMaps; outMap++)
+    {
+      for (size_t inMap = 0; inMap < outMaps; inMap++, outMapIdx++)
+      {
+        arma::Mat<eT> rotatedFilter;
+        Rotate180(weights.slice(outMap * outMaps + inMap), rotatedFilter);
+
+        arma::Mat<eT> output;
+        Rule::Convolution(gy.slice(inMap), rotatedFilter, output);
+
+        g.slice(outMap) += output;
+      }
+    }
+  }
+
+  /*
+   * Compute the backward pass with a single matrix multiplication of the
+   * filters of all maps and the error, which is then summed back into the
+   * shape of the input.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<IsIm2ColConvolution<Rule>::value, void>::type
+  BackwardConvolution(const arma::Cube<eT>& gy, arma::Cube<eT>& g)
+  {
+    arma::Mat<eT> filters;
+    FilterMatrix(filters);
+
+    const arma::Mat<eT> error(const_cast<eT*>(gy.memptr()),
+        gy.n_rows * gy.n_cols, gy.n_slices, false, true);
+    const arma::Mat<eT> columns = filters * arma::trans(error);
+
+    g.set_size(inputParameter.n_rows, inputParameter.n_cols,
+        inputParameter.n_slices);
+    Rule::Col2Im(columns, wfilter, hfilter, xStride, yStride, wPad, hPad, g);
+  }
+
+  /*
+   * Convolve every pair of input and output maps with the given rule
+   * (gradient).
+   */
+  template<typename Rule, typename InputType, typename eT>
+  typename std::enable_if<!IsIm2ColConvolution<Rule>::value, void>::type
+  GradientConvolution(const InputType& input,
+                      const arma::Cube<eT>& d,
+                      arma::Cube<eT>& g)
+  {
+    g = arma::zeros<arma::Cube<eT> >(weights.n_rows, weights.n_cols,
+        weights.n_slices);
+
+    for (size_t outMap = 0; outMap < outMaps; outMap++)
+    {
+      for (size_t inMap = 0, s = outMap; inMap < inMaps; inMap++, s += outMaps)
+      {
+        arma::Cube<eT> inputSlices = input.slices(inMap, inMap);
+        arma::Cube<eT> deltaSlices = d.slices(outMap, outMap);
+
+        arma::Cube<eT> output;
+        Rule::Convolution(inputSlices, deltaSlices, output);
+
+        for (size_t i = 0; i < output.n_slices; i++)
+          g.slice(s) += output.slice(i);
+      }
+    }
+  }
+
+  /*
+   * Compute the gradient of the filters of all maps with a single matrix
+   * multiplication of the unrolled input patches and the delta.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<IsIm2ColConvolution<Rule>::value, void>::type
+  GradientConvolution(const arma::Cube<eT>& input,
+                      const arma::Cube<eT>& d,
+                      arma::Cube<eT>& g)
+  {
+    arma::Mat<eT> columns;
+    Rule::Im2Col(input, wfilter, hfilter, xStride, yStride, wPad, hPad,
+        columns);
+
+    const arma::Mat<eT> delta(const_cast<eT*>(d.memptr()), d.n_rows * d.n_cols,
+        d.n_slices, false, true);
+    const arma::Mat<eT> filterGradients = columns * delta;
+
+    // Scatter the gradient back into the layout of the weights, where the
+    // filter from input map i to output map o is slice (i * outMaps + o).
+    const size_t filterSize = wfilter * hfilter;
+    g.set_size(weights.n_rows, weights.n_cols, weights.n_slices);
+    for (size_t outMap = 0; outMap < outMaps; outMap++)
+    {
+      const eT* gradientPtr = filterGradients.colptr(outMap);
+      for (size_t inMap = 0; inMap < inMaps; inMap++, gradientPtr += filterSize)
+      {
+        std::copy(gradientPtr, gradientPtr + filterSize,
+            g.slice_memptr(inMap * outMaps + outMap));
+      }
+    }
+  }
+
+  /*
+   * Unroll the filters into a matrix with one column per output map, in the
+   * order of the patches created by Im2Col().
+   *
+   * @param filters Matrix in which the unrolled filters are stored.
+   */
+  template<typename eT>
+  void FilterMatrix(arma::Mat<eT>& filters)
+  {
+    const size_t filterSize = wfilter * hfilter;
+    filters.set_size(filterSize * inMaps, outMaps);
+    for (size_t outMap = 0; outMap < outMaps; outMap++)
+    {
+      eT* filterPtr = filters.colptr(outMap);
+      for (size_t inMap = 0; inMap < inMaps; inMap++, filterPtr += filterSize)
+      {
+        const eT* weightsPtr = weights.slice_memptr(inMap * outMaps + outMap);
+        std::copy(weightsPtr, weightsPtr + filterSize, filterPtr);
+      }
+    }
+  }
+
   /*
    * Rotates a 3rd-order tesor counterclockwise by 180 degrees.
    *
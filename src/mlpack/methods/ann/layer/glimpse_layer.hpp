@@ -77,7 +77,7 @@ class GlimpseLayer
   template<typename eT>
   void Forward(const arma::Cube<eT>& input, arma::Cube<eT>& output)
   {
-    output = arma::Cube<eT>(size, size, depth * input.n_slices);
+    output.set_size(size, size, depth * input.n_slices);
 
     inputDepth = input.n_slices / inSize;
 
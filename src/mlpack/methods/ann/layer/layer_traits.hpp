@@ -68,6 +68,10 @@ HAS_MEM_FUNC(RecurrentParameter, HasRecurrentParameterCheck);
 // can use with SFINAE to catch when a type has a SeqLen() function.
 HAS_MEM_FUNC(SeqLen, HasSeqLenCheck);
 
+// This gives us a HasResetStateCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a ResetState() function.
+HAS_MEM_FUNC(ResetState, HasResetStateCheck);
+
 // This gives us a HasWeightsCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Weights() function.
 HAS_MEM_FUNC(Weights, HasWeightsCheck);
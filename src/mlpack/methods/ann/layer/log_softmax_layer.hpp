@@ -74,7 +74,9 @@ class LogSoftmaxLayer
       return 0.0;
     } );
 
-    output = input - (maxInput + std::log(arma::accu(output)));
+    // Normalize each column (each point) separately.
+    maxInput.each_row() += arma::log(arma::sum(output));
+    output = input - maxInput;
   }
 
   /**
@@ -91,7 +93,9 @@ class LogSoftmaxLayer
                 const arma::Mat<eT>& gy,
                 arma::Mat<eT>& g)
   {
-    g = gy - arma::exp(input) * arma::accu(gy);
+    g = arma::exp(input);
+    g.each_row() %= arma::sum(gy);
+    g = gy - g;
   }
 
   //! Get the input parameter.
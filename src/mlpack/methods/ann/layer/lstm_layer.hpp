@@ -21,6 +21,14 @@ namespace ann /** Artificial Neural Network. */ {
  * for the gates and cells and also of the type of the function used to
  * initialize and update the peephole weights.
  *
+ * Every column of the input belongs to another sequence, so a batch of
+ * sequences is processed at once.  The layer stores the activations of the
+ * last SeqLen() steps.  When a sequence is longer than that (with truncated
+ * backpropagation through time), it is processed in windows of SeqLen()
+ * steps.  The cell state is carried from one window to the next, but the
+ * error is only propagated back within the window.  ResetState() starts new
+ * sequences.
+ *
  * @tparam GateActivationFunction Activation function used for the gates.
  * @tparam StateActivationFunction Activation function used for the state.
  * @tparam OutputActivationFunction Activation function used for the output.
@@ -52,7 +60,8 @@ class LSTMLayer
       outSize(outSize),
       peepholes(peepholes),
       seqLen(1),
-      offset(0)
+      offset(0),
+      batchSize(1)
   {
     if (peepholes)
     {
@@ -67,7 +76,8 @@ class LSTMLayer
 
   /**
    * Ordinary feed forward pass of a neural network, evaluating the function
-   * f(x) by propagating the activity forward through f.
+   * f(x) by propagating the activity forward through f.  Each column of the
+   * input belongs to another sequence of the batch.
    *
    * @param input Input data used for evaluating the specified function.
    * @param output Resulting output activation.
@@ -75,60 +85,93 @@ class LSTMLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
-    if (inGate.n_cols < seqLen)
+    // The steps of the window are stored one after the other, each in a block
+    // of batchSize columns.
+    if (offset == 0)
     {
-      inGate = arma::zeros<InputDataType>(outSize, seqLen);
-      inGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      inGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      outGate = arma::zeros<InputDataType>(outSize, seqLen);
-      outGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      outGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGate = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      state = arma::zeros<InputDataType>(outSize, seqLen);
-      stateError = arma::zeros<InputDataType>(outSize, seqLen);
-      cellAct = arma::zeros<InputDataType>(outSize, seqLen);
+      batchSize = input.n_cols;
+
+      if (inGate.n_cols < seqLen * batchSize)
+      {
+        inGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        inGateAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        inGateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        outGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        outGateAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        outGateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        forgetGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        forgetGateAct = arma::zeros<InputDataType>(outSize,
+            seqLen * batchSize);
+        forgetGateError = arma::zeros<InputDataType>(outSize,
+            seqLen * batchSize);
+        state = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        stateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+        cellAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      }
+
+      // Continue from the cell state at the end of the previous window, unless
+      // a new sequence starts.
+      if (carryState.n_cols == batchSize)
+        initialState = carryState;
+      else
+        initialState.zeros(outSize, batchSize);
     }
 
+    const size_t begin = offset * batchSize;
+    const size_t end = begin + batchSize - 1;
+
+    // The cell state of the previous step.
+    const arma::Mat<eT> previousState(offset > 0 ?
+        state.colptr(begin - batchSize) : initialState.memptr(), outSize,
+        batchSize, false, true);
+
     // Split up the inputactivation into the 3 parts (inGate, forgetGate,
     // outGate).
-    inGate.col(offset) = input.submat(0, 0, outSize - 1, 0);
+    inGate.cols(begin, end) = input.rows(0, outSize - 1);
+    forgetGate.cols(begin, end) = input.rows(outSize, (outSize * 2) - 1);
+    outGate.cols(begin, end) = input.rows(outSize * 3, (outSize * 4) - 1);
 
-    forgetGate.col(offset) = input.submat(outSize, 0, (outSize * 2) - 1, 0);
-    outGate.col(offset) = input.submat(outSize * 3, 0, (outSize * 4) - 1, 0);
-
-    if (peepholes && offset > 0)
+    if (peepholes)
     {
-      inGate.col(offset) += peepholeWeights.col(0) % state.col(offset - 1);
-      forgetGate.col(offset) += peepholeWeights.col(1) %
-          state.col(offset - 1);
+      inGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(0)) *
+          previousState;
+      forgetGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(1)) *
+          previousState;
     }
 
-    arma::Col<eT> inGateActivation = inGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(inGate.unsafe_col(offset), inGateActivation);
+    arma::Mat<eT> inGateActivation(inGateAct.colptr(begin), outSize,
+        batchSize, false, true);
+    GateActivationFunction::fn(inGate.cols(begin, end), inGateActivation);
 
-    arma::Col<eT> forgetGateActivation = forgetGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(forgetGate.unsafe_col(offset),
+    arma::Mat<eT> forgetGateActivation(forgetGateAct.colptr(begin), outSize,
+        batchSize, false, true);
+    GateActivationFunction::fn(forgetGate.cols(begin, end),
         forgetGateActivation);
 
-    arma::Col<eT> cellActivation = cellAct.unsafe_col(offset);
-    StateActivationFunction::fn(input.submat(outSize * 2, 0,
-        (outSize * 3) - 1, 0), cellActivation);
+    arma::Mat<eT> cellActivation(cellAct.colptr(begin), outSize, batchSize,
+        false, true);
+    StateActivationFunction::fn(input.rows(outSize * 2, (outSize * 3) - 1),
+        cellActivation);
 
-    state.col(offset) = inGateAct.col(offset) % cellActivation;
-
-    if (offset > 0)
-      state.col(offset) += forgetGateAct.col(offset) % state.col(offset - 1);
+    state.cols(begin, end) = inGateActivation % cellActivation +
+        forgetGateActivation % previousState;
 
     if (peepholes)
-      outGate.col(offset) += peepholeWeights.col(2) % state.col(offset);
+    {
+      outGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(2)) *
+          state.cols(begin, end);
+    }
+
+    arma::Mat<eT> outGateActivation(outGateAct.colptr(begin), outSize,
+        batchSize, false, true);
+    GateActivationFunction::fn(outGate.cols(begin, end), outGateActivation);
 
-    arma::Col<eT> outGateActivation = outGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(outGate.unsafe_col(offset), outGateActivation);
+    OutputActivationFunction::fn(state.cols(begin, end), output);
+    output = outGateActivation % output;
 
-    OutputActivationFunction::fn(state.unsafe_col(offset), output);
-    output = outGateAct.col(offset) % output;
+    // The next window of the sequence starts from this cell state.
+    if (offset == seqLen - 1)
+      carryState = state.cols(begin, end);
 
     offset = (offset + 1) % seqLen;
   }
@@ -136,7 +179,9 @@ class LSTMLayer
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
    * f(x) by propagating x backwards trough f. Using the results from the feed
-   * forward pass.
+   * forward pass.  The error is only propagated back through the steps of the
+   * current window, so the backpropagation through time is truncated at the
+   * start of the window.
    *
    * @param input The propagated input activation.
    * @param gy The backpropagated error.
@@ -149,84 +194,85 @@ class LSTMLayer
   {
     queryOffset = seqLen - offset - 1;
 
-    arma::Col<eT> outGateDerivative;
-    GateActivationFunction::deriv(outGateAct.unsafe_col(queryOffset),
+    const size_t begin = queryOffset * batchSize;
+    const size_t end = begin + batchSize - 1;
+
+    // The cell state of the previous step.
+    const arma::Mat<eT> previousState(queryOffset > 0 ?
+        state.colptr(begin - batchSize) : initialState.memptr(), outSize,
+        batchSize, false, true);
+
+    arma::Mat<eT> outGateDerivative;
+    GateActivationFunction::deriv(outGateAct.cols(begin, end),
         outGateDerivative);
 
-    arma::Col<eT> stateActivation;
-    StateActivationFunction::fn(state.unsafe_col(queryOffset), stateActivation);
+    arma::Mat<eT> stateActivation;
+    StateActivationFunction::fn(state.cols(begin, end), stateActivation);
 
-    outGateError.col(queryOffset) = outGateDerivative % gy % stateActivation;
+    outGateError.cols(begin, end) = outGateDerivative % gy % stateActivation;
 
-    arma::Col<eT> stateDerivative;
+    arma::Mat<eT> stateDerivative;
     StateActivationFunction::deriv(stateActivation, stateDerivative);
 
-    stateError.col(queryOffset) = gy % outGateAct.col(queryOffset) %
+    stateError.cols(begin, end) = gy % outGateAct.cols(begin, end) %
         stateDerivative;
 
     if (queryOffset < (seqLen - 1))
     {
-      stateError.col(queryOffset) += stateError.col(queryOffset + 1) %
-          forgetGateAct.col(queryOffset + 1);
+      stateError.cols(begin, end) += stateError.cols(begin + batchSize,
+          end + batchSize) % forgetGateAct.cols(begin + batchSize,
+          end + batchSize);
 
       if (peepholes)
       {
-        stateError.col(queryOffset) += inGateError.col(queryOffset + 1) %
-            peepholeWeights.col(0);
-        stateError.col(queryOffset) += forgetGateError.col(queryOffset + 1) %
-            peepholeWeights.col(1);
+        stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(0)) *
+            inGateError.cols(begin + batchSize, end + batchSize);
+        stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(1)) *
+            forgetGateError.cols(begin + batchSize, end + batchSize);
       }
     }
 
     if (peepholes)
     {
-      stateError.col(queryOffset) += outGateError.col(queryOffset) %
-          peepholeWeights.col(2);
+      stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(2)) *
+          outGateError.cols(begin, end);
     }
 
-    arma::Col<eT> cellDerivative;
-    StateActivationFunction::deriv(cellAct.col(queryOffset), cellDerivative);
+    arma::Mat<eT> cellDerivative;
+    StateActivationFunction::deriv(cellAct.cols(begin, end), cellDerivative);
 
-    arma::Col<eT> cellError = inGateAct.col(queryOffset) % cellDerivative %
-        stateError.col(queryOffset);
+    const arma::Mat<eT> cellError = inGateAct.cols(begin, end) %
+        cellDerivative % stateError.cols(begin, end);
 
-    if (queryOffset > 0)
-    {
-      arma::Col<eT> forgetGateDerivative;
-      GateActivationFunction::deriv(forgetGateAct.col(queryOffset),
-          forgetGateDerivative);
+    arma::Mat<eT> forgetGateDerivative;
+    GateActivationFunction::deriv(forgetGateAct.cols(begin, end),
+        forgetGateDerivative);
 
-      forgetGateError.col(queryOffset) = forgetGateDerivative %
-          stateError.col(queryOffset) % state.col(queryOffset - 1);
-    }
+    forgetGateError.cols(begin, end) = forgetGateDerivative %
+        stateError.cols(begin, end) % previousState;
 
-    arma::Col<eT> inGateDerivative;
-    GateActivationFunction::deriv(inGateAct.col(queryOffset), inGateDerivative);
+    arma::Mat<eT> inGateDerivative;
+    GateActivationFunction::deriv(inGateAct.cols(begin, end),
+        inGateDerivative);
 
-    inGateError.col(queryOffset) = inGateDerivative %
-        stateError.col(queryOffset) % cellAct.col(queryOffset);
+    inGateError.cols(begin, end) = inGateDerivative %
+        stateError.cols(begin, end) % cellAct.cols(begin, end);
 
     if (peepholes)
     {
-      peepholeDerivatives.col(2) += outGateError.col(queryOffset) %
-          state.col(queryOffset);
-
-      if (queryOffset > 0)
-      {
-        peepholeDerivatives.col(0) += inGateError.col(queryOffset) %
-            state.col(queryOffset - 1);
-        peepholeDerivatives.col(1) += forgetGateError.col(queryOffset) %
-            state.col(queryOffset - 1);
-      }
+      peepholeDerivatives.col(2) += arma::sum(outGateError.cols(begin, end) %
+          state.cols(begin, end), 1);
+      peepholeDerivatives.col(0) += arma::sum(inGateError.cols(begin, end) %
+          previousState, 1);
+      peepholeDerivatives.col(1) += arma::sum(
+          forgetGateError.cols(begin, end) % previousState, 1);
     }
 
-    g = arma::zeros<arma::Mat<eT> >(outSize * 4, 1);
-    g.submat(0, 0, outSize - 1, 0) = inGateError.col(queryOffset);
-    g.submat(outSize, 0, (outSize * 2) - 1, 0) =
-        forgetGateError.col(queryOffset);
-    g.submat(outSize * 2, 0, (outSize * 3) - 1, 0) = cellError;
-    g.submat(outSize * 3, 0, (outSize * 4) - 1, 0) =
-        outGateError.col(queryOffset);
+    g.set_size(outSize * 4, batchSize);
+    g.rows(0, outSize - 1) = inGateError.cols(begin, end);
+    g.rows(outSize, (outSize * 2) - 1) = forgetGateError.cols(begin, end);
+    g.rows(outSize * 2, (outSize * 3) - 1) = cellError;
+    g.rows(outSize * 3, (outSize * 4) - 1) = outGateError.cols(begin, end);
 
     offset = (offset + 1) % seqLen;
   }
@@ -245,22 +291,33 @@ class LSTMLayer
   {
     if (peepholes && offset == 0)
     {
+      const size_t begin = queryOffset * batchSize;
+      const size_t end = begin + batchSize - 1;
+
       peepholeGradient.col(0) = arma::trans((peepholeWeights.col(0).t() *
-          (inGateError.col(queryOffset) % peepholeDerivatives.col(0))) *
-          inGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(0)) *
+          inGateError.cols(begin, end))) * inGate.cols(begin, end).t());
 
       peepholeGradient.col(1) = arma::trans((peepholeWeights.col(1).t() *
-          (forgetGateError.col(queryOffset) % peepholeDerivatives.col(1))) *
-          forgetGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(1)) *
+          forgetGateError.cols(begin, end))) *
+          forgetGate.cols(begin, end).t());
 
       peepholeGradient.col(2) = arma::trans((peepholeWeights.col(2).t() *
-          (outGateError.col(queryOffset) % peepholeDerivatives.col(2))) *
-          outGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(2)) *
+          outGateError.cols(begin, end))) * outGate.cols(begin, end).t());
 
       peepholeDerivatives.zeros();
     }
   }
 
+  /**
+   * Forget the cell state, so that the next call to Forward() starts a new
+   * sequence.  Otherwise the first step of each window continues from the
+   * cell state of the last step of the previous window.
+   */
+  void ResetState() { carryState.reset(); }
+
   //! Get the peephole weights.
   OutputDataType const& Weights() const { return peepholeWeights; }
   //! Modify the peephole weights.
@@ -324,6 +381,9 @@ class LSTMLayer
   //! Locally-stored sequence offset.
   size_t offset;
 
+  //! Locally-stored number of sequences in the batch.
+  size_t batchSize;
+
   //! Locally-stored query offset.
   size_t queryOffset;
 
@@ -375,6 +435,12 @@ class LSTMLayer
   //! Locally-stored cell activation object.
   InputDataType cellAct;
 
+  //! Locally-stored cell state before the first step of the window.
+  InputDataType initialState;
+
+  //! Locally-stored cell state after the last step of the window.
+  InputDataType carryState;
+
   //! Locally-stored peephole weight object.
   OutputDataType peepholeWeights;
 
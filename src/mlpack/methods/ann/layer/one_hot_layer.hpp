@@ -58,9 +58,13 @@ class OneHotLayer
     output = inputActivations;
     output.zeros();
 
+    // Each column is a separate point.
     arma::uword maxIndex;
-    inputActivations.max(maxIndex);
-    output(maxIndex) = 1;
+    for (size_t i = 0; i < inputActivations.n_cols; ++i)
+    {
+      inputActivations.unsafe_col(i).max(maxIndex);
+      output(maxIndex, i) = 1;
+    }
   }
 
   /**
@@ -48,7 +48,9 @@ class SoftmaxLayer
   {
     output = arma::trunc_exp(input -
         arma::repmat(arma::max(input), input.n_rows, 1));
-    output /= arma::accu(output);
+
+    // Normalize each column (each point) separately.
+    output.each_row() /= arma::sum(output);
   }
 
   /**
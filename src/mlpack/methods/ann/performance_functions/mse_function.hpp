@@ -8,6 +8,7 @@
 #define MLPACK_METHODS_ANN_PERFORMANCE_FUNCTIONS_MSE_FUNCTION_HPP
 
 #include <mlpack/core.hpp>
+#include "performance_function_traits.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -50,6 +51,14 @@ class MeanSquaredErrorFunction
 
 }; // class MeanSquaredErrorFunction
 
+//! The mean squared error of a batch is the mean over its points.
+template<>
+class PerformanceFunctionTraits<MeanSquaredErrorFunction>
+{
+ public:
+  static const bool IsMean = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
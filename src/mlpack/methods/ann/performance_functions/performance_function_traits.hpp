@@ -0,0 +1,33 @@
+/**
+ * @file performance_function_traits.hpp
+ *
+ * This provides the PerformanceFunctionTraits class, a template class to get
+ * information about various performance functions.
+ */
+#ifndef MLPACK_METHODS_ANN_PERFORMANCE_FUNCTIONS_PERFORMANCE_FUNCTION_TRAITS_HPP
+#define MLPACK_METHODS_ANN_PERFORMANCE_FUNCTIONS_PERFORMANCE_FUNCTION_TRAITS_HPP
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * This is a template class that can provide information about various
+ * performance functions.  By default, this class will provide the weakest
+ * possible assumptions on the performance function, and each performance
+ * function should override values as necessary.
+ */
+template<typename PerformanceFunction>
+class PerformanceFunctionTraits
+{
+ public:
+  /**
+   * This is true if the error of a batch of points is the mean (rather than the
+   * sum) of the errors of each of the points.
+   */
+  static const bool IsMean = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -10,6 +10,7 @@
 #define MLPACK_METHODS_ANN_PERFORMANCE_FUNCTIONS_SPARSE_FUNCTION_HPP
 
 #include <mlpack/core.hpp>
+#include "performance_function_traits.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -130,6 +131,15 @@ class SparseErrorFunction
 
 }; // class SparseErrorFunction
 
+//! The reconstruction error of a batch is the mean over its points, and each
+//! point carries the regularization cost.
+template<typename DataType>
+class PerformanceFunctionTraits<SparseErrorFunction<DataType> >
+{
+ public:
+  static const bool IsMean = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
@@ -23,6 +23,20 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network.
  *
+ * Each column of the predictors is one sequence.  The gradient is computed
+ * with backpropagation through time.  If BPTTSteps() is set, it is truncated:
+ * the sequence is unrolled in windows of that many steps.  Each window is
+ * propagated forward and then backward, and the recurrent state is carried to
+ * the next window.  So the activations that are stored only depend on the
+ * window, not on the length of the sequence.
+ *
+ * The batch overloads of Evaluate() and Gradient() (used by
+ * mlpack::optimization::MiniBatchSGD) propagate several sequences at once, one
+ * per column of the activations of each step.  Sequences of different lengths
+ * are padded with zeros at the end of their column; SequenceLengths() then
+ * holds the number of steps of each sequence, and the padded steps don't
+ * contribute to the objective or the gradient.
+ *
  * @tparam LayerTypes Contains all layer modules used to construct the network.
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
@@ -201,6 +215,52 @@ class RNN
                 const size_t i,
                 arma::mat& gradient);
 
+  /**
+   * Evaluate the recurrent neural network with the given parameters on the
+   * batch of sequences begin, ..., begin + batchSize - 1.  The sequences are
+   * propagated through each layer at once, and the result is the sum of the
+   * objectives of each sequence.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param deterministic Whether or not to train or test the model. Note some
+   * layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the gradient of the recurrent neural network with the given
+   * parameters on the batch of sequences begin, ..., begin + batchSize - 1.
+   * The gradients of the sequences in the batch are summed.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the first sequence of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of sequences in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  //! Get the number of steps that are backpropagated at once (0 means the
+  //! whole sequence).
+  size_t BPTTSteps() const { return bpttSteps; }
+  //! Modify the number of steps that are backpropagated at once (0 means the
+  //! whole sequence).
+  size_t& BPTTSteps() { return bpttSteps; }
+
+  //! Get the number of steps of each sequence (if empty, every sequence fills
+  //! its whole column).
+  const arma::Row<size_t>& SequenceLengths() const { return sequenceLengths; }
+  //! Modify the number of steps of each sequence (if empty, every sequence
+  //! fills its whole column).  This has to be set before training.
+  arma::Row<size_t>& SequenceLengths() { return sequenceLengths; }
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
@@ -221,16 +281,21 @@ class RNN
   void SinglePredict(const DataType& input, DataType& output)
   {
     deterministic = true;
+    batchSize = 1;
     seqLen = input.n_rows / inputSize;
     ResetParameter(network);
 
     // Iterate through the input sequence and perform the feed forward pass.
+    // Nothing is backpropagated, so the activations don't have to be saved.
+    const size_t window = Window();
     for (seqNum = 0; seqNum < seqLen; seqNum++)
     {
-      // Perform the forward pass and save the activations.
+      if (seqNum % window == 0)
+        ResetWindow(network, std::min(window, seqLen - seqNum));
+
       Forward(input.rows(seqNum * inputSize, (seqNum + 1) * inputSize - 1),
           network);
-      SaveActivations(network);
+      LinkRecurrent(network);
 
       // Retrieve output of the subsequence.
       if (seqOutput)
@@ -246,6 +311,14 @@ class RNN
       OutputPrediction(output, network);
   }
 
+  /**
+   * Return the number of steps of each window of the current sequences.
+   */
+  size_t Window() const
+  {
+    return (bpttSteps == 0 || bpttSteps > seqLen) ? seqLen : bpttSteps;
+  }
+
   /**
    * Reset the network by clearing the layer activations and by setting the
    * layer status.
@@ -262,13 +335,32 @@ class RNN
   ResetParameter(std::tuple<Tp...>& network)
   {
     ResetDeterministic(std::get<I>(network));
-    ResetSeqLen(std::get<I>(network));
     ResetRecurrent(std::get<I>(network), std::get<I>(network).InputParameter());
-    std::get<I>(network).Delta().zeros();
+    ResetState(std::get<I>(network));
 
     ResetParameter<I + 1, Tp...>(network);
   }
 
+  /**
+   * Prepare the network for the next window of the sequences by setting the
+   * number of steps of the window and by clearing the layer deltas, so that no
+   * error is propagated back from the previous window.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  ResetWindow(std::tuple<Tp...>& /* unused */, const size_t /* unused */)
+  { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  ResetWindow(std::tuple<Tp...>& network, const size_t steps)
+  {
+    ResetSeqLen(std::get<I>(network), steps);
+    std::get<I>(network).Delta().reset();
+
+    ResetWindow<I + 1, Tp...>(network, steps);
+  }
+
   /**
    * Reset the layer status by setting the current deterministic parameter
    * for all layer that implement the Deterministic function.
@@ -287,21 +379,39 @@ class RNN
   ResetDeterministic(T& /* unused */) { /* Nothing to do here */ }
 
   /**
-   * Reset the layer sequence length by setting the current seqLen parameter
-   * for all layer that implement the SeqLen function.
+   * Reset the layer sequence length by setting the number of steps of the
+   * current window for all layer that implement the SeqLen function.
    */
   template<typename T>
   typename std::enable_if<
       HasSeqLenCheck<T, size_t&(T::*)(void)>::value, void>::type
-  ResetSeqLen(T& layer)
+  ResetSeqLen(T& layer, const size_t steps)
   {
-    layer.SeqLen() = seqLen;
+    layer.SeqLen() = steps;
   }
 
   template<typename T>
   typename std::enable_if<
       !HasSeqLenCheck<T, size_t&(T::*)(void)>::value, void>::type
-  ResetSeqLen(T& /* unused */) { /* Nothing to do here */ }
+  ResetSeqLen(T& /* unused */, const size_t /* unused */)
+  { /* Nothing to do here */ }
+
+  /**
+   * Reset the state of all layer that implement the ResetState function, so
+   * that they start new sequences.
+   */
+  template<typename T>
+  typename std::enable_if<
+      HasResetStateCheck<T, void(T::*)(void)>::value, void>::type
+  ResetState(T& layer)
+  {
+    layer.ResetState();
+  }
+
+  template<typename T>
+  typename std::enable_if<
+      !HasResetStateCheck<T, void(T::*)(void)>::value, void>::type
+  ResetState(T& /* unused */) { /* Nothing to do here */ }
 
   /**
    * Distinguish between recurrent layer and non-recurrent layer when resetting
@@ -312,7 +422,8 @@ class RNN
       HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   ResetRecurrent(T& layer, P& /* unused */)
   {
-    layer.RecurrentParameter().zeros();
+    layer.RecurrentParameter().zeros(layer.RecurrentParameter().n_rows,
+        batchSize);
   }
 
   template<typename T, typename P>
@@ -413,10 +524,12 @@ class RNN
     if (activations.size() == layerNumber)
     {
       activations.push_back(new arma::mat(layer.RecurrentParameter().n_rows,
-          seqLen));
+          Window() * batchSize));
     }
 
-    activations[layerNumber].unsafe_col(seqNum) = layer.RecurrentParameter();
+    const size_t step = (seqNum - windowBegin) * batchSize;
+    activations[layerNumber].cols(step, step + batchSize - 1) =
+        layer.RecurrentParameter();
   }
 
   template<typename T, typename P>
@@ -427,10 +540,12 @@ class RNN
     if (activations.size() == layerNumber)
     {
       activations.push_back(new arma::mat(layer.OutputParameter().n_rows,
-          seqLen));
+          Window() * batchSize));
     }
 
-    activations[layerNumber].unsafe_col(seqNum) = layer.OutputParameter();
+    const size_t step = (seqNum - windowBegin) * batchSize;
+    activations[layerNumber].cols(step, step + batchSize - 1) =
+        layer.OutputParameter();
   }
 
   /**
@@ -469,7 +584,9 @@ class RNN
       HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   Load(const size_t layerNumber, T& layer, P& /* unused */)
   {
-    layer.RecurrentParameter() = activations[layerNumber].unsafe_col(seqNum);
+    const size_t step = (seqNum - windowBegin) * batchSize;
+    layer.RecurrentParameter() = activations[layerNumber].cols(step,
+        step + batchSize - 1);
   }
 
   template<typename T, typename P>
@@ -477,7 +594,9 @@ class RNN
       !HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   Load(const size_t layerNumber, T& layer, P& /* unused */)
   {
-    layer.OutputParameter() = activations[layerNumber].unsafe_col(seqNum);
+    const size_t step = (seqNum - windowBegin) * batchSize;
+    layer.OutputParameter() = activations[layerNumber].cols(step,
+        step + batchSize - 1);
   }
 
   /**
@@ -590,21 +709,45 @@ class RNN
     /* Nothing to do here */
   }
 
+  /**
+   * Propagate the sequences begin, ..., begin + batchSize - 1 through the
+   * network, one window at a time, and return the sum of their objectives.
+   * If a gradient is given, each window is also propagated backward, and the
+   * gradient of each step is added to it.
+   *
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param gradient Matrix to add the gradient to, or NULL.
+   */
+  double Propagate(const size_t begin,
+                   const size_t batchSize,
+                   arma::mat* gradient);
+
+  /**
+   * Return the number of steps of the given sequence of the current batch.
+   */
+  size_t Length(const size_t sequence) const
+  {
+    if (sequenceLengths.is_empty())
+      return seqLen;
+
+    return std::min((size_t) sequenceLengths[batchBegin + sequence], seqLen);
+  }
+
   /*
-   * Calculate the output error and update the overall error.
+   * Calculate the output error of a single sequence and return the error
+   * measured by the performance function.
    */
-  template<typename DataType, typename ErrorType, typename... Tp>
-  double OutputError(const DataType& target,
-                     ErrorType& error,
-                     const std::tuple<Tp...>& network)
+  double OutputError(const arma::mat& output,
+                     const arma::mat& target,
+                     arma::mat& error)
   {
     // Calculate and store the output error.
-    outputLayer.CalculateError(
-        std::get<sizeof...(Tp) - 1>(network).OutputParameter(), target, error);
+    outputLayer.CalculateError(output, target, error);
 
     // Masures the network's performance with the specified performance
     // function.
-    return performanceFunc.Error(network, target, error);
+    return performanceFunc.Error(output, target, error);
   }
 
   /**
@@ -775,6 +918,21 @@ class RNN
   //! Locally stored parameter that indicates if the input is a sequence.
   bool seqOutput;
 
+  //! The number of steps that are backpropagated at once (0 means all).
+  size_t bpttSteps;
+
+  //! The number of steps of each sequence (empty if all are complete).
+  arma::Row<size_t> sequenceLengths;
+
+  //! The index of the first sequence of the current batch.
+  size_t batchBegin;
+
+  //! The number of sequences in the current batch.
+  size_t batchSize;
+
+  //! The index of the first step of the current window.
+  size_t windowBegin;
+
   //! The activation storage we are using to perform the feed backward pass.
   boost::ptr_vector<arma::mat> activations;
 
@@ -38,7 +38,8 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     responses(responses),
     numFunctions(predictors.n_cols),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    bpttSteps(0)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -77,7 +78,8 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction)),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    bpttSteps(0)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -108,7 +110,8 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction)),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    bpttSteps(0)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -224,50 +227,42 @@ template<typename LayerTypes,
 >
 double RNN<
 LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Evaluate(const arma::mat& /* unused */,
+>::Evaluate(const arma::mat& parameters,
             const size_t i,
             const bool deterministic)
 {
-  this->deterministic = deterministic;
-
-  arma::mat input = arma::mat(predictors.colptr(i), predictors.n_rows,
-      1, false, true);
-  arma::mat target = arma::mat(responses.colptr(i), responses.n_rows,
-      1, false, true);
-
-  // Initialize the activation storage only once.
-  if (activations.empty())
-    InitLayer(input, target, network);
-
-  double networkError = 0;
-  seqLen = input.n_rows / inputSize;
-  ResetParameter(network);
-
-  error = arma::mat(outputSize, outputSize < target.n_elem ? seqLen : 1);
-
-  // Iterate through the input sequence and perform the feed forward pass.
-  for (seqNum = 0; seqNum < seqLen; seqNum++)
-  {
-    // Perform the forward pass and save the activations.
-    Forward(input.rows(seqNum * inputSize, (seqNum + 1) * inputSize - 1),
-        network);
-    SaveActivations(network);
+  return Evaluate(parameters, i, 1, deterministic);
+}
 
-    // Retrieve output error of the subsequence.
-    if (seqOutput)
-    {
-      arma::mat seqError = error.unsafe_col(seqNum);
-      arma::mat seqTarget = target.submat(seqNum * outputSize, 0,
-          (seqNum + 1) * outputSize - 1, 0);
-      networkError += OutputError(seqTarget, seqError, network);
-    }
-  }
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+void RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Gradient(const arma::mat& parameters,
+            const size_t i,
+            arma::mat& gradient)
+{
+  Gradient(parameters, i, gradient, 1);
+}
 
-  // Retrieve output error of the complete sequence.
-  if (!seqOutput)
-    return OutputError(target, error, network);
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+double RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Evaluate(const arma::mat& /* unused */,
+            const size_t begin,
+            const size_t batchSize,
+            const bool deterministic)
+{
+  this->deterministic = deterministic;
 
-  return networkError;
+  return Propagate(begin, batchSize, NULL);
 }
 
 template<typename LayerTypes,
@@ -278,8 +273,9 @@ template<typename LayerTypes,
 void RNN<
 LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 >::Gradient(const arma::mat& /* unused */,
-            const size_t i,
-            arma::mat& gradient)
+            const size_t begin,
+            arma::mat& gradient,
+            const size_t batchSize)
 {
   if (gradient.is_empty())
   {
@@ -290,41 +286,168 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     gradient.zeros();
   }
 
-  Evaluate(parameter, i, false);
+  deterministic = false;
+  Propagate(begin, batchSize, &gradient);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+double RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Propagate(const size_t begin,
+             const size_t batchSize,
+             arma::mat* gradient)
+{
+  if (!sequenceLengths.is_empty() &&
+      sequenceLengths.n_elem != predictors.n_cols)
+  {
+    Log::Fatal << "RNN::Propagate(): the number of sequence lengths ("
+        << sequenceLengths.n_elem << ") doesn't match the number of sequences ("
+        << predictors.n_cols << ")!" << std::endl;
+  }
 
-  arma::mat currentGradient = arma::mat(gradient.n_rows, gradient.n_cols);
-  NetworkGradients(currentGradient, network);
+  this->batchSize = batchSize;
+  batchBegin = begin;
 
-  const arma::mat input = arma::mat(predictors.colptr(i), predictors.n_rows,
-      1, false, true);
+  // Each column of the input and target holds one sequence of the batch.
+  const arma::mat input = arma::mat(predictors.colptr(begin),
+      predictors.n_rows, batchSize, false, true);
+  const arma::mat target = arma::mat(responses.colptr(begin), responses.n_rows,
+      batchSize, false, true);
 
-  // Iterate through the input sequence and perform the feed backward pass.
-  for (seqNum = seqLen - 1; seqNum >= 0; seqNum--)
+  // Initialize the activation storage only once.
+  if (activations.empty())
   {
-    // Load the network activation for the upcoming backward pass.
-    LoadActivations(input.rows(seqNum * inputSize, (seqNum + 1) *
-        inputSize - 1), network);
+    InitLayer(arma::mat(predictors.colptr(begin), predictors.n_rows, 1, false,
+        true), arma::mat(responses.colptr(begin), responses.n_rows, 1, false,
+        true), network);
+  }
+
+  double networkError = 0;
+  seqLen = input.n_rows / inputSize;
+  ResetParameter(network);
+
+  arma::mat currentGradient;
+  if (gradient != NULL)
+  {
+    currentGradient = arma::mat(gradient->n_rows, gradient->n_cols);
+    NetworkGradients(currentGradient, network);
+  }
+
+  // The error of each step of the window, or the error at the end of each
+  // sequence.
+  const size_t window = Window();
+  if (seqOutput)
+    error.set_size(outputSize, window * batchSize);
+  else
+    error.zeros(outputSize, batchSize);
+
+  const arma::mat& output = std::get<std::tuple_size<LayerTypes>::value - 1>(
+      network).OutputParameter();
+
+  arma::mat stepError;
+  for (windowBegin = 0; windowBegin < seqLen; windowBegin += window)
+  {
+    const size_t windowEnd = std::min(windowBegin + window, seqLen);
+    ResetWindow(network, windowEnd - windowBegin);
 
-    // Perform the backward pass.
     if (seqOutput)
+      error.zeros();
+
+    // Perform the forward pass through the window and save the activations.
+    bool windowError = false;
+    for (seqNum = windowBegin; seqNum < windowEnd; seqNum++)
     {
-      arma::mat seqError = error.unsafe_col(seqNum);
-      Backward(seqError, network);
-    }
-    else
-    {
-      Backward(error, network);
+      Forward(input.rows(seqNum * inputSize, (seqNum + 1) * inputSize - 1),
+          network);
+      SaveActivations(network);
+
+      // Retrieve the output error of each sequence that isn't padded at this
+      // step.
+      for (size_t i = 0; i < batchSize; i++)
+      {
+        const size_t length = Length(i);
+        if (seqOutput && seqNum < length)
+        {
+          arma::mat seqError = arma::mat(error.colptr(
+              (seqNum - windowBegin) * batchSize + i), outputSize, 1, false,
+              true);
+          networkError += OutputError(output.col(i), target.submat(
+              seqNum * outputSize, i, (seqNum + 1) * outputSize - 1, i),
+              seqError);
+          windowError = true;
+        }
+        else if (!seqOutput && seqNum + 1 == length)
+        {
+          arma::mat seqError = arma::mat(error.colptr(i), outputSize, 1, false,
+              true);
+          networkError += OutputError(output.col(i), target.col(i), seqError);
+          windowError = true;
+        }
+      }
     }
 
-    // Link the parameters and update the gradients.
-    LinkParameter(network);
-    UpdateGradients<>(network);
+    // Nothing is propagated back from later windows, so there is nothing to do
+    // for a window without error.
+    if (gradient == NULL || !windowError)
+      continue;
 
-    // Update the overall gradient.
-    gradient += currentGradient;
+    // Iterate backward through the window and perform the feed backward pass.
+    for (seqNum = windowEnd - 1; ; seqNum--)
+    {
+      // Load the network activation for the upcoming backward pass.
+      LoadActivations(input.rows(seqNum * inputSize, (seqNum + 1) *
+          inputSize - 1), network);
+
+      if (seqOutput)
+      {
+        stepError = error.cols((seqNum - windowBegin) * batchSize,
+            (seqNum - windowBegin + 1) * batchSize - 1);
+      }
+      else
+      {
+        // The error of a complete sequence is propagated back from each of
+        // its steps in the window it ends in.
+        stepError = error;
+        for (size_t i = 0; i < batchSize; i++)
+        {
+          const size_t length = Length(i);
+          if (length > windowEnd || length <= windowBegin || seqNum >= length)
+          {
+            stepError.col(i).zeros();
+          }
+        }
+      }
+
+      // Perform the backward pass.
+      Backward(stepError, network);
+
+      // Link the parameters and update the gradients.
+      LinkParameter(network);
+      UpdateGradients<>(network);
+
+      // Update the overall gradient.
+      *gradient += currentGradient;
+
+      if (seqNum == windowBegin) break;
+    }
 
-    if (seqNum == 0) break;
+    // The backward pass loaded the activations of the first step of the
+    // window, so restore the recurrent state of the last step for the next
+    // window.
+    if (windowEnd < seqLen)
+    {
+      seqNum = windowEnd - 1;
+      LoadActivations(input.rows(seqNum * inputSize, (seqNum + 1) *
+          inputSize - 1), network);
+      LinkRecurrent(network);
+    }
   }
+
+  return networkError;
 }
 
 template<typename LayerTypes,
@@ -66,8 +66,11 @@ class FastMKS
    *
    * @param singleMode Whether or not to run single-tree search.
    * @param naive Whether or not to run brute-force (naive) search.
+   * @param parallel Whether or not to split single-tree search across threads.
    */
-  FastMKS(const bool singleMode = false, const bool naive = false);
+  FastMKS(const bool singleMode = false,
+          const bool naive = false,
+          const bool parallel = false);
 
   /**
    * Create the FastMKS object with the given reference set (this is the set
@@ -77,10 +80,12 @@ class FastMKS
    * @param referenceSet Set of reference data.
    * @param singleMode Whether or not to run single-tree search.
    * @param naive Whether or not to run brute-force (naive) search.
+   * @param parallel Whether or not to split single-tree search across threads.
    */
   FastMKS(const MatType& referenceSet,
           const bool singleMode = false,
-          const bool naive = false);
+          const bool naive = false,
+          const bool parallel = false);
 
   /**
    * Create the FastMKS object using the reference set (this is the set that is
@@ -92,11 +97,13 @@ class FastMKS
    * @param kernel Initialized kernel.
    * @param single Whether or not to run single-tree search.
    * @param naive Whether or not to run brute-force (naive) search.
+   * @param parallel Whether or not to split single-tree search across threads.
    */
   FastMKS(const MatType& referenceSet,
           KernelType& kernel,
           const bool singleMode = false,
-          const bool naive = false);
+          const bool naive = false,
+          const bool parallel = false);
 
   /**
    * Create the FastMKS object with an already-initialized tree built on the
@@ -108,9 +115,11 @@ class FastMKS
    * @param referenceTree Tree built on reference data.
    * @param single Whether or not to run single-tree search.
    * @param naive Whether or not to run brute-force (naive) search.
+   * @param parallel Whether or not to split single-tree search across threads.
    */
   FastMKS(Tree* referenceTree,
-          const bool singleMode = false);
+          const bool singleMode = false,
+          const bool parallel = false);
 
   //! Destructor for the FastMKS object.
   ~FastMKS();
@@ -227,6 +236,11 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get whether or not single-tree search is split across threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not single-tree search is split across threads.
+  bool& Parallel() { return parallel; }
+
   //! Serialize the model.
   template<typename Archive>
   void Serialize(Archive& ar, const unsigned int /* version */);
@@ -246,6 +260,8 @@ class FastMKS
   bool singleMode;
   //! If true, naive (brute-force) search is used.
   bool naive;
+  //! If true, single-tree search is split across OpenMP threads.
+  bool parallel;
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
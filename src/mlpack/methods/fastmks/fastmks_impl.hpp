@@ -25,13 +25,15 @@ template<typename KernelType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
 FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
-                                                const bool naive) :
+                                                const bool naive,
+                                                const bool parallel) :
     referenceSet(new MatType()),
     referenceTree(NULL),
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallel(parallel)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -48,13 +50,15 @@ template<typename KernelType,
 FastMKS<KernelType, MatType, TreeType>::FastMKS(
     const MatType& referenceSet,
     const bool singleMode,
-    const bool naive) :
+    const bool naive,
+    const bool parallel) :
     referenceSet(&referenceSet),
     referenceTree(NULL),
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    parallel(parallel)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -71,13 +75,15 @@ template<typename KernelType,
 FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
                                                 KernelType& kernel,
                                                 const bool singleMode,
-                                                const bool naive) :
+                                                const bool naive,
+                                                const bool parallel) :
     referenceSet(&referenceSet),
     referenceTree(NULL),
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    parallel(parallel),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -96,13 +102,15 @@ template<typename KernelType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
 FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
-                                                const bool singleMode) :
+                                                const bool singleMode,
+                                                const bool parallel) :
     referenceSet(&referenceTree->Dataset()),
     referenceTree(referenceTree),
     treeOwner(false),
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    parallel(parallel),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -254,18 +262,36 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     // Fill kernels.
     kernels.fill(-DBL_MAX);
 
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
+    // If requested, split the query points across threads.  Each thread gets
+    // its own rules object (which stores the results for the query points it
+    // is given), but then kernel evaluations can't be cached in the shared
+    // reference tree.  The self-kernels are only calculated once, for all
+    // threads.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, indices, kernels, metric.Kernel());
+    arma::vec queryKernels, referenceKernels;
+    RuleType::SelfKernels(querySet, metric.Kernel(), queryKernels);
+    RuleType::SelfKernels(*referenceSet, metric.Kernel(), referenceKernels);
+
+    size_t baseCases = 0;
+    size_t scores = 0;
+    #pragma omp parallel if (parallel) reduction(+:baseCases, scores)
+    {
+      // Create rules object (this will store the results).
+      RuleType rules(*referenceSet, querySet, indices, kernels,
+          metric.Kernel(), queryKernels, referenceKernels, !parallel);
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic, 64)
+      for (intmax_t i = 0; i < (intmax_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+      baseCases += rules.BaseCases();
+      scores += rules.Scores();
+    }
+
+    Log::Info << baseCases << " base cases." << std::endl;
+    Log::Info << scores << " scores." << std::endl;
 
     Timer::Stop("computing_products");
     return;
@@ -376,24 +402,38 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
+    // If requested, split the query points across threads, with a separate
+    // rules object and traverser for each thread.  The self-kernels are only
+    // calculated once, for all threads.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, indices, kernels,
-        metric.Kernel());
+    arma::vec selfKernels;
+    RuleType::SelfKernels(*referenceSet, metric.Kernel(), selfKernels);
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    size_t numPrunes = 0;
+    size_t baseCases = 0;
+    size_t scores = 0;
+    #pragma omp parallel if (parallel) reduction(+:numPrunes, baseCases, scores)
+    {
+      // Create rules object (this will store the results).
+      RuleType rules(*referenceSet, *referenceSet, indices, kernels,
+          metric.Kernel(), selfKernels, selfKernels, !parallel);
 
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+      #pragma omp for schedule(dynamic, 64)
+      for (intmax_t i = 0; i < (intmax_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      // Save the number of pruned nodes.
+      numPrunes += traverser.NumPrunes();
+      baseCases += rules.BaseCases();
+      scores += rules.Scores();
+    }
 
     Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    Log::Info << baseCases << " base cases." << std::endl;
+    Log::Info << scores << " scores." << std::endl;
 
     Timer::Stop("computing_products");
     return;
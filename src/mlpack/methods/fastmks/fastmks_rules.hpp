@@ -21,11 +21,64 @@ template<typename KernelType, typename TreeType>
 class FastMKSRules
 {
  public:
+  /**
+   * Construct the FastMKSRules object.  Each self-kernel of the query and
+   * reference sets is precalculated.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param indices Matrix to store resulting indices in.
+   * @param products Matrix to store resulting kernel values in.
+   * @param kernel Instantiated kernel.
+   * @param cacheKernels If false, kernel evaluations will not be cached in the
+   *     statistics of the reference tree.  This is necessary when multiple
+   *     rules objects perform single-tree traversals of the same reference
+   *     tree at the same time, but it means parent-child prunes are not
+   *     possible.
+   */
   FastMKSRules(const typename TreeType::Mat& referenceSet,
                const typename TreeType::Mat& querySet,
                arma::Mat<size_t>& indices,
                arma::mat& products,
-               KernelType& kernel);
+               KernelType& kernel,
+               const bool cacheKernels = true);
+
+  /**
+   * Construct the FastMKSRules object with self-kernels of the query and
+   * reference sets that were already calculated with SelfKernels().  This
+   * avoids recalculating and copying them when many rules objects are created
+   * for the same sets, such as one for each thread.  The self-kernels are not
+   * copied, so they have to outlive the rules.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param indices Matrix to store resulting indices in.
+   * @param products Matrix to store resulting kernel values in.
+   * @param kernel Instantiated kernel.
+   * @param queryKernels Self-kernels of the query set.
+   * @param referenceKernels Self-kernels of the reference set.
+   * @param cacheKernels If false, kernel evaluations will not be cached in the
+   *     statistics of the reference tree (see above).
+   */
+  FastMKSRules(const typename TreeType::Mat& referenceSet,
+               const typename TreeType::Mat& querySet,
+               arma::Mat<size_t>& indices,
+               arma::mat& products,
+               KernelType& kernel,
+               const arma::vec& queryKernels,
+               const arma::vec& referenceKernels,
+               const bool cacheKernels = true);
+
+  /**
+   * Calculate the self-kernel || p || of each point p of the given set.
+   *
+   * @param set Set of points.
+   * @param kernel Instantiated kernel.
+   * @param selfKernels Vector to store the self-kernels in.
+   */
+  static void SelfKernels(const typename TreeType::Mat& set,
+                          KernelType& kernel,
+                          arma::vec& selfKernels);
 
   //! Compute the base case (kernel value) between two points.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -106,14 +159,22 @@ class FastMKSRules
   //! The maximum kernels.
   arma::mat& products;
 
+  //! The query set self-kernels, if they are computed by these rules.
+  arma::vec ownQueryKernels;
+  //! The reference set self-kernels, if they are computed by these rules.
+  arma::vec ownReferenceKernels;
+
   //! Cached query set self-kernels (|| q || for each q).
-  arma::vec queryKernels;
+  const arma::vec& queryKernels;
   //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  const arma::vec& referenceKernels;
 
   //! The instantiated kernel.
   KernelType& kernel;
 
+  //! If true, single-tree kernel evaluations are cached in the reference tree.
+  bool cacheKernels;
+
   //! The last query index BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference index BaseCase() was called with.
@@ -19,12 +19,16 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& querySet,
     arma::Mat<size_t>& indices,
     arma::mat& products,
-    KernelType& kernel) :
+    KernelType& kernel,
+    const bool cacheKernels) :
     referenceSet(referenceSet),
     querySet(querySet),
     indices(indices),
     products(products),
+    queryKernels(ownQueryKernels),
+    referenceKernels(ownReferenceKernels),
     kernel(kernel),
+    cacheKernels(cacheKernels),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
@@ -32,22 +36,56 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     scores(0)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+  SelfKernels(querySet, kernel, ownQueryKernels);
+  SelfKernels(referenceSet, kernel, ownReferenceKernels);
 
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
+  // Set to invalid memory, so that the first node combination does not try to
+  // dereference null pointers.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    arma::Mat<size_t>& indices,
+    arma::mat& products,
+    KernelType& kernel,
+    const arma::vec& queryKernels,
+    const arma::vec& referenceKernels,
+    const bool cacheKernels) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    indices(indices),
+    products(products),
+    queryKernels(queryKernels),
+    referenceKernels(referenceKernels),
+    kernel(kernel),
+    cacheKernels(cacheKernels),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    baseCases(0),
+    scores(0)
+{
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
   traversalInfo.LastReferenceNode() = (TreeType*) this;
 }
 
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::SelfKernels(
+    const typename TreeType::Mat& set,
+    KernelType& kernel,
+    arma::vec& selfKernels)
+{
+  selfKernels.set_size(set.n_cols);
+  for (size_t i = 0; i < set.n_cols; ++i)
+    selfKernels[i] = sqrt(kernel.Evaluate(set.col(i), set.col(i)));
+}
+
 template<typename KernelType, typename TreeType>
 inline force_inline
 double FastMKSRules<KernelType, TreeType>::BaseCase(
@@ -104,9 +142,10 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   // Compare with the current best.
   const double bestKernel = products(products.n_rows - 1, queryIndex);
 
-  // See if we can perform a parent-child prune.
+  // See if we can perform a parent-child prune.  This is only possible if the
+  // parent's kernel evaluation was cached.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  if (cacheKernels && referenceNode.Parent() != NULL)
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
@@ -144,7 +183,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
     // Could it be that this kernel evaluation has already been calculated?
-    if (tree::TreeTraits<TreeType>::HasSelfChildren &&
+    if (tree::TreeTraits<TreeType>::HasSelfChildren && cacheKernels &&
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
@@ -163,7 +202,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  if (cacheKernels)
+    referenceNode.Stat().LastKernel() = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -0,0 +1,137 @@
+/**
+ * @file diagonal_gmm.cpp
+ *
+ * Implementation of non-template DiagonalGMM methods.
+ */
+#include "diagonal_gmm.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Create a GMM with the given number of Gaussians, each of which have the
+ * specified dimensionality.
+ *
+ * @param gaussians Number of Gaussians in this GMM.
+ * @param dimensionality Dimensionality of each Gaussian.
+ */
+DiagonalGMM::DiagonalGMM(const size_t gaussians, const size_t dimensionality) :
+    gaussians(gaussians),
+    dimensionality(dimensionality),
+    dists(gaussians,
+          distribution::DiagonalGaussianDistribution(dimensionality)),
+    weights(gaussians)
+{
+  // Set equal weights.  Technically this model is still valid, but only barely.
+  weights.fill(1.0 / gaussians);
+}
+
+/**
+ * Return the probability of the given observation being from this GMM.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation) const
+{
+  // Sum the probability for each Gaussian in our mixture (and we have to
+  // multiply by the prior for each Gaussian too).
+  double sum = 0;
+  for (size_t i = 0; i < gaussians; i++)
+    sum += weights[i] * dists[i].Probability(observation);
+
+  return sum;
+}
+
+/**
+ * Return the probability of the given observation being from the given
+ * component in the mixture.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation,
+                                const size_t component) const
+{
+  return weights[component] * dists[component].Probability(observation);
+}
+
+/**
+ * Return a randomly generated observation according to the probability
+ * distribution defined by this object.
+ */
+arma::vec DiagonalGMM::Random() const
+{
+  // Determine which Gaussian it will be coming from.
+  double gaussRand = math::Random();
+  size_t gaussian = 0;
+
+  double sumProb = 0;
+  for (size_t g = 0; g < gaussians; g++)
+  {
+    sumProb += weights(g);
+    if (gaussRand <= sumProb)
+    {
+      gaussian = g;
+      break;
+    }
+  }
+
+  return dists[gaussian].Random();
+}
+
+/**
+ * Classify the given observations as being from an individual component in this
+ * GMM.
+ */
+void DiagonalGMM::Classify(const arma::mat& observations,
+                           arma::Row<size_t>& labels) const
+{
+  // The most probable component is the one with the largest weighted log
+  // probability.
+  arma::mat logProbabilities;
+  LogProbabilities(observations, dists, weights, logProbabilities);
+  arma::inplace_trans(logProbabilities);
+
+  labels.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    arma::uword index;
+    logProbabilities.unsafe_col(i).max(index);
+    labels[i] = index;
+  }
+}
+
+void DiagonalGMM::LogProbabilities(
+    const arma::mat& observations,
+    const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+    const arma::vec& weightsL,
+    arma::mat& logProbabilities) const
+{
+  logProbabilities.set_size(observations.n_cols, gaussians);
+
+  arma::vec componentLogProbabilities;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    distsL[i].LogProbability(observations, componentLogProbabilities);
+    logProbabilities.col(i) = componentLogProbabilities + std::log(weightsL[i]);
+  }
+}
+
+/**
+ * Get the log-likelihood of this data's fit to the model.
+ */
+double DiagonalGMM::LogLikelihood(
+    const arma::mat& data,
+    const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+    const arma::vec& weightsL) const
+{
+  arma::mat logProbabilities;
+  LogProbabilities(data, distsL, weightsL, logProbabilities);
+
+  // Sum over every component with log-sum-exp, so that points far from every
+  // component don't underflow.
+  arma::vec shifts = arma::max(logProbabilities, 1);
+  for (size_t j = 0; j < shifts.n_elem; ++j)
+    if (!std::isfinite(shifts[j]))
+      shifts[j] = 0.0;
+  return arma::accu(shifts + arma::log(arma::sum(
+      arma::exp(logProbabilities.each_col() - shifts), 1)));
+}
+
+} // namespace gmm
+} // namespace mlpack
@@ -0,0 +1,245 @@
+/**
+ * @file diagonal_gmm.hpp
+ *
+ * Defines a Gaussian Mixture model whose components have diagonal covariance,
+ * and estimates the parameters of the model.
+ */
+#ifndef MLPACK_METHODS_GMM_DIAGONAL_GMM_HPP
+#define MLPACK_METHODS_GMM_DIAGONAL_GMM_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+// This is the default fitting method class.
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * A Gaussian Mixture Model (GMM) whose components each have a diagonal
+ * covariance.  This is the same model as a GMM trained with the
+ * DiagonalConstraint, but only the variances of each component are stored, and
+ * every probability is computed in O(d) time instead of O(d^2), so it is much
+ * cheaper for high-dimensional data (such as audio features).
+ *
+ * The DiagonalGMM has the same interface as the GMM class, except that each
+ * component is a DiagonalGaussianDistribution, and the FittingType given to
+ * Train() must estimate DiagonalGaussianDistributions; by default, EMFit<> is
+ * used with DiagonalGaussianDistribution as its distribution type.
+ *
+ * Example use:
+ *
+ * @code
+ * // Set up a mixture of 5 gaussians in a 40-dimensional space.
+ * DiagonalGMM g(5, 40);
+ *
+ * // Train the GMM given the data observations.
+ * g.Train(data);
+ *
+ * // Get the probability of 'observation' being observed from this GMM.
+ * double probability = g.Probability(observation);
+ * @endcode
+ */
+class DiagonalGMM
+{
+ private:
+  //! The number of Gaussians in the model.
+  size_t gaussians;
+  //! The dimensionality of the model.
+  size_t dimensionality;
+
+  //! Vector of Gaussians
+  std::vector<distribution::DiagonalGaussianDistribution> dists;
+
+  //! Vector of a priori weights for each Gaussian.
+  arma::vec weights;
+
+ public:
+  //! The default fitting type for a DiagonalGMM.
+  typedef EMFit<kmeans::KMeans<>, PositiveDefiniteConstraint,
+      distribution::DiagonalGaussianDistribution> DefaultFittingType;
+
+  /**
+   * Create an empty Gaussian Mixture Model, with zero gaussians.
+   */
+  DiagonalGMM() :
+      gaussians(0),
+      dimensionality(0)
+  {
+    // Warn the user.  They probably don't want to do this.  If this constructor
+    // is being used (because it is required by some template classes), the user
+    // should know that it is potentially dangerous.
+    Log::Debug << "DiagonalGMM::DiagonalGMM(): no parameters given; Estimate() "
+        << "may fail unless parameters are set." << std::endl;
+  }
+
+  /**
+   * Create a GMM with the given number of Gaussians, each of which have the
+   * specified dimensionality.  The means will be set to 0 and the variances to
+   * 1.
+   *
+   * @param gaussians Number of Gaussians in this GMM.
+   * @param dimensionality Dimensionality of each Gaussian.
+   */
+  DiagonalGMM(const size_t gaussians, const size_t dimensionality);
+
+  /**
+   * Create a GMM with the given dists and weights.
+   *
+   * @param dists Distributions of the model.
+   * @param weights Weights of the model.
+   */
+  DiagonalGMM(
+      const std::vector<distribution::DiagonalGaussianDistribution>& dists,
+      const arma::vec& weights) :
+      gaussians(dists.size()),
+      dimensionality((!dists.empty()) ? dists[0].Mean().n_elem : 0),
+      dists(dists),
+      weights(weights) { /* Nothing to do. */ }
+
+  //! Return the number of gaussians in the model.
+  size_t Gaussians() const { return gaussians; }
+  //! Return the dimensionality of the model.
+  size_t Dimensionality() const { return dimensionality; }
+
+  /**
+   * Return a const reference to a component distribution.
+   *
+   * @param i index of component.
+   */
+  const distribution::DiagonalGaussianDistribution& Component(size_t i) const
+  {
+    return dists[i];
+  }
+  /**
+   * Return a reference to a component distribution.
+   *
+   * @param i index of component.
+   */
+  distribution::DiagonalGaussianDistribution& Component(size_t i)
+  {
+    return dists[i];
+  }
+
+  //! Return a const reference to the a priori weights of each Gaussian.
+  const arma::vec& Weights() const { return weights; }
+  //! Return a reference to the a priori weights of each Gaussian.
+  arma::vec& Weights() { return weights; }
+
+  /**
+   * Return the probability that the given observation came from this
+   * distribution.
+   *
+   * @param observation Observation to evaluate the probability of.
+   */
+  double Probability(const arma::vec& observation) const;
+
+  /**
+   * Return the probability that the given observation came from the given
+   * Gaussian component in this distribution.
+   *
+   * @param observation Observation to evaluate the probability of.
+   * @param component Index of the component of the GMM to be considered.
+   */
+  double Probability(const arma::vec& observation,
+                     const size_t component) const;
+
+  /**
+   * Return a randomly generated observation according to the probability
+   * distribution defined by this object.
+   *
+   * @return Random observation from this GMM.
+   */
+  arma::vec Random() const;
+
+  /**
+   * Estimate the probability distribution directly from the given observations,
+   * using the given algorithm in the FittingType class to fit the data.  See
+   * GMM::Train() for more details.
+   *
+   * @tparam FittingType The type of fitting method which should be used.
+   * @param observations Observations of the model.
+   * @param trials Number of trials to perform; the model in these trials with
+   *      the greatest log-likelihood will be selected.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *      model for the estimation.
+   * @return The log-likelihood of the best fit.
+   */
+  template<typename FittingType = DefaultFittingType>
+  double Train(const arma::mat& observations,
+               const size_t trials = 1,
+               const bool useExistingModel = false,
+               FittingType fitter = FittingType());
+
+  /**
+   * Estimate the probability distribution directly from the given observations,
+   * taking into account the probability of each observation actually being from
+   * this distribution, and using the given algorithm in the FittingType class
+   * to fit the data.  See GMM::Train() for more details.
+   *
+   * @param observations Observations of the model.
+   * @param probabilities Probability of each observation being from this
+   *     distribution.
+   * @param trials Number of trials to perform; the model in these trials with
+   *     the greatest log-likelihood will be selected.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *     model for the estimation.
+   * @return The log-likelihood of the best fit.
+   */
+  template<typename FittingType = DefaultFittingType>
+  double Train(const arma::mat& observations,
+               const arma::vec& probabilities,
+               const size_t trials = 1,
+               const bool useExistingModel = false,
+               FittingType fitter = FittingType());
+
+  /**
+   * Classify the given observations as being from an individual component in
+   * this GMM.  The resultant classifications are stored in the 'labels' object,
+   * and each label will be between 0 and (Gaussians() - 1).
+   *
+   * @param observations List of observations to classify.
+   * @param labels Object which will be filled with labels.
+   */
+  void Classify(const arma::mat& observations,
+                arma::Row<size_t>& labels) const;
+
+  /**
+   * Serialize the GMM.
+   */
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Calculate the log of the weighted probability of each observation under
+   * each component, and store it in element (j, i) of logProbabilities.
+   */
+  void LogProbabilities(
+      const arma::mat& observations,
+      const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+      const arma::vec& weightsL,
+      arma::mat& logProbabilities) const;
+
+  /**
+   * This function computes the loglikelihood of the given model.  This function
+   * is used by DiagonalGMM::Train().
+   *
+   * @param dataPoints Observations to calculate the likelihood for.
+   * @param distsL Components of the given mixture model.
+   * @param weightsL Weights of the given mixture model.
+   */
+  double LogLikelihood(
+      const arma::mat& dataPoints,
+      const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+      const arma::vec& weightsL) const;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "diagonal_gmm_impl.hpp"
+
+#endif
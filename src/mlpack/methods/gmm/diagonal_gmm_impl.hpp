@@ -0,0 +1,171 @@
+/**
+ * @file diagonal_gmm_impl.hpp
+ *
+ * Implementation of template-based DiagonalGMM methods.
+ */
+#ifndef MLPACK_METHODS_GMM_DIAGONAL_GMM_IMPL_HPP
+#define MLPACK_METHODS_GMM_DIAGONAL_GMM_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "diagonal_gmm.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Fit the GMM to the given observations.
+ */
+template<typename FittingType>
+double DiagonalGMM::Train(const arma::mat& observations,
+                          const size_t trials,
+                          const bool useExistingModel,
+                          FittingType fitter)
+{
+  if (trials == 0)
+    return -DBL_MAX; // It's what they asked for...
+
+  // If each trial must start from the same initial location, we must save it.
+  const std::vector<distribution::DiagonalGaussianDistribution> distsOrig =
+      useExistingModel ? dists :
+      std::vector<distribution::DiagonalGaussianDistribution>();
+  const arma::vec weightsOrig = useExistingModel ? weights : arma::vec();
+
+  // The first training goes into the actual model position, so that if it's
+  // the best we don't need to copy it.
+  fitter.Estimate(observations, dists, weights, useExistingModel);
+  double bestLikelihood = LogLikelihood(observations, dists, weights);
+
+  if (trials > 1)
+    Log::Info << "DiagonalGMM::Train(): Log-likelihood of trial 0 is "
+        << bestLikelihood << "." << std::endl;
+
+  for (size_t trial = 1; trial < trials; ++trial)
+  {
+    std::vector<distribution::DiagonalGaussianDistribution> distsTrial =
+        useExistingModel ? distsOrig :
+        std::vector<distribution::DiagonalGaussianDistribution>(gaussians,
+        distribution::DiagonalGaussianDistribution(dimensionality));
+    arma::vec weightsTrial = useExistingModel ? weightsOrig :
+        arma::vec(gaussians);
+
+    fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
+
+    // Check to see if the log-likelihood of this one is better.
+    const double newLikelihood = LogLikelihood(observations, distsTrial,
+        weightsTrial);
+
+    Log::Info << "DiagonalGMM::Train(): Log-likelihood of trial " << trial
+        << " is " << newLikelihood << "." << std::endl;
+
+    if (newLikelihood > bestLikelihood)
+    {
+      // Save new likelihood and model.
+      bestLikelihood = newLikelihood;
+
+      dists = std::move(distsTrial);
+      weights = std::move(weightsTrial);
+    }
+  }
+
+  // Report final log-likelihood and return it.
+  Log::Info << "DiagonalGMM::Train(): log-likelihood of trained GMM is "
+      << bestLikelihood << "." << std::endl;
+  return bestLikelihood;
+}
+
+/**
+ * Fit the GMM to the given observations, each of which has a certain
+ * probability of being from this distribution.
+ */
+template<typename FittingType>
+double DiagonalGMM::Train(const arma::mat& observations,
+                          const arma::vec& probabilities,
+                          const size_t trials,
+                          const bool useExistingModel,
+                          FittingType fitter)
+{
+  if (trials == 0)
+    return -DBL_MAX; // It's what they asked for...
+
+  // If each trial must start from the same initial location, we must save it.
+  const std::vector<distribution::DiagonalGaussianDistribution> distsOrig =
+      useExistingModel ? dists :
+      std::vector<distribution::DiagonalGaussianDistribution>();
+  const arma::vec weightsOrig = useExistingModel ? weights : arma::vec();
+
+  // The first training goes into the actual model position, so that if it's
+  // the best we don't need to copy it.
+  fitter.Estimate(observations, probabilities, dists, weights,
+      useExistingModel);
+  double bestLikelihood = LogLikelihood(observations, dists, weights);
+
+  if (trials > 1)
+    Log::Debug << "DiagonalGMM::Train(): Log-likelihood of trial 0 is "
+        << bestLikelihood << "." << std::endl;
+
+  for (size_t trial = 1; trial < trials; ++trial)
+  {
+    std::vector<distribution::DiagonalGaussianDistribution> distsTrial =
+        useExistingModel ? distsOrig :
+        std::vector<distribution::DiagonalGaussianDistribution>(gaussians,
+        distribution::DiagonalGaussianDistribution(dimensionality));
+    arma::vec weightsTrial = useExistingModel ? weightsOrig :
+        arma::vec(gaussians);
+
+    fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
+        useExistingModel);
+
+    // Check to see if the log-likelihood of this one is better.
+    const double newLikelihood = LogLikelihood(observations, distsTrial,
+        weightsTrial);
+
+    Log::Debug << "DiagonalGMM::Train(): Log-likelihood of trial " << trial
+        << " is " << newLikelihood << "." << std::endl;
+
+    if (newLikelihood > bestLikelihood)
+    {
+      // Save new likelihood and model.
+      bestLikelihood = newLikelihood;
+
+      dists = std::move(distsTrial);
+      weights = std::move(weightsTrial);
+    }
+  }
+
+  // Report final log-likelihood and return it.
+  Log::Info << "DiagonalGMM::Train(): log-likelihood of trained GMM is "
+      << bestLikelihood << "." << std::endl;
+  return bestLikelihood;
+}
+
+/**
+ * Serialize the object.
+ */
+template<typename Archive>
+void DiagonalGMM::Serialize(Archive& ar, const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  ar & CreateNVP(gaussians, "gaussians");
+  ar & CreateNVP(dimensionality, "dimensionality");
+
+  // Load (or save) the gaussians.  Not going to use the default std::vector
+  // serialize here because it won't call out correctly to Serialize() for each
+  // Gaussian distribution.
+  if (Archive::is_loading::value)
+    dists.resize(gaussians);
+
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    std::ostringstream oss;
+    oss << "dist" << i;
+    ar & CreateNVP(dists[i], oss.str());
+  }
+
+  ar & CreateNVP(weights, "weights");
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -71,6 +71,19 @@ class EigenvalueRatioConstraint
     covariance = eigenvectors * arma::diagmat(eigenvalues) * eigenvectors.t();
   }
 
+  /**
+   * Apply the eigenvalue ratio constraint to the given diagonal covariance,
+   * given as the vector of variances.  The variances are the eigenvalues, so
+   * they are sorted, and each is set according to its ratio to the largest.
+   */
+  void ApplyConstraint(arma::vec& diagCovariance) const
+  {
+    const arma::uvec order = arma::sort_index(diagCovariance, "descend");
+    const double largest = diagCovariance[order[0]];
+    for (size_t i = 0; i < order.n_elem; ++i)
+      diagCovariance[order[i]] = largest * ratios[i];
+  }
+
   //! Serialize the constraint.
   template<typename Archive>
   void Serialize(Archive& ar, const unsigned int /* version */)
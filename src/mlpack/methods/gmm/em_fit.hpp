@@ -31,9 +31,15 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The components of the mixture are of type Distribution, which may be either
+ * GaussianDistribution (the default) or DiagonalGaussianDistribution.  In the
+ * second case only the diagonal of each covariance is estimated, and the
+ * covariance constraint is applied to the vector of variances.
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
-         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
 class EMFit
 {
  public:
@@ -75,7 +81,7 @@ class EMFit
    *      clustering.
    */
   void Estimate(const arma::mat& observations,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -98,7 +104,7 @@ class EMFit
    */
   void Estimate(const arma::mat& observations,
                 const arma::vec& probabilities,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -138,23 +144,89 @@ class EMFit
    * @param weights Vector to store a priori weights in.
    */
   void InitialClustering(const arma::mat& observations,
-                         std::vector<distribution::GaussianDistribution>& dists,
+                         std::vector<Distribution>& dists,
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Calculate the log of the weighted probability of each observation under
+   * each Gaussian, log(w_i) + log p(x_j | i), and store it in element (j, i) of
+   * logProbabilities.  The observations are split into blocks across threads.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
+   * @param observations List of observations.
+   * @param dists Vector of Gaussians.
    * @param weights Vector of a priori weights.
+   * @param logProbabilities Matrix to store log probabilities in.
+   */
+  void LogProbabilities(const arma::mat& observations,
+                        const std::vector<Distribution>& dists,
+                        const arma::vec& weights,
+                        arma::mat& logProbabilities) const;
+
+  /**
+   * Calculate the conditional probability of each Gaussian given each
+   * observation from the output of LogProbabilities(), normalizing each row
+   * with a vectorized log-sum-exp so that nothing underflows, and return the
+   * log-likelihood of the model.  Rows for observations with zero likelihood
+   * are set to zero.
+   *
+   * @param logProbabilities Log probabilities from LogProbabilities().
+   * @param condProbabilities Matrix to store conditional probabilities in.
+   * @return Log-likelihood of the observations.
+   */
+  static double ConditionalProbabilities(const arma::mat& logProbabilities,
+                                         arma::mat& condProbabilities);
+
+  /**
+   * Calculate the (unnormalized) weighted scatter matrix of the observations
+   * around the given mean, sum_j w_j (x_j - mean) (x_j - mean)^T.  Each block
+   * of observations is handled with one matrix multiplication, and the blocks
+   * are split across threads.
+   *
+   * @param observations List of observations.
+   * @param observationWeights Weight of each observation.
+   * @param mean Mean to center the observations on.
+   * @param covariance Matrix to store the weighted scatter matrix in.
+   */
+  static void WeightedCovariance(const arma::mat& observations,
+                                 const arma::vec& observationWeights,
+                                 const arma::vec& mean,
+                                 arma::mat& covariance);
+
+  /**
+   * Calculate the (unnormalized) weighted variance of each dimension of the
+   * observations around the given mean; this is the diagonal of the matrix
+   * given by the other overload, found in O(d) time per observation.
+   *
+   * @param observations List of observations.
+   * @param observationWeights Weight of each observation.
+   * @param mean Mean to center the observations on.
+   * @param diagCovariance Vector to store the weighted variances in.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  static void WeightedCovariance(const arma::mat& observations,
+                                 const arma::vec& observationWeights,
+                                 const arma::vec& mean,
+                                 arma::vec& diagCovariance);
+
+  //! Add the outer product of the given vector to a full covariance.
+  static void AddScatter(const arma::vec& x, arma::mat& covariance)
+  {
+    covariance += x * arma::trans(x);
+  }
+
+  //! Add the diagonal of the outer product of the given vector to a diagonal
+  //! covariance.
+  static void AddScatter(const arma::vec& x, arma::vec& diagCovariance)
+  {
+    diagCovariance += arma::square(x);
+  }
+
+  //! The type of the covariance of each component: arma::mat for
+  //! GaussianDistribution, and arma::vec for DiagonalGaussianDistribution.
+  typedef typename std::decay<decltype(
+      std::declval<const Distribution&>().Covariance())>::type CovarianceType;
+
+  //! The number of observations handled at once by each thread.
+  static const size_t blockSize = 1024;
 
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
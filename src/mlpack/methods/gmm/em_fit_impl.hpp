@@ -15,8 +15,10 @@ namespace mlpack {
 namespace gmm {
 
 //! Constructor.
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::EMFit(
     const size_t maxIterations,
     const double tolerance,
     InitialClusteringType clusterer,
@@ -27,24 +29,30 @@ EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
     constraint(constraint)
 { /* Nothing to do. */ }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(const arma::mat& observations,
+         std::vector<Distribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   // Only perform initial clustering if the user wanted it.
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value.  The log-likelihood
+  // falls out of the normalization.
+  arma::mat logProb, condProb;
+  LogProbabilities(observations, dists, weights, logProb);
+  double l = ConditionalProbabilities(logProb, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -53,27 +61,6 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
@@ -82,82 +69,66 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     for (size_t i = 0; i < dists.size(); i++)
     {
       // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
+      if (probRowSums[i] == 0.0)
+        continue;
+
+      dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
 
       // Calculate the new value of the covariances using the updated
       // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
+      CovarianceType covariance;
+      WeightedCovariance(observations, condProb.col(i), dists[i].Mean(),
+          covariance);
+      covariance /= probRowSums[i];
 
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
     }
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = probRowSums / observations.n_cols;
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood, along with the
+    // conditional probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    LogProbabilities(observations, dists, weights, logProb);
+    l = ConditionalProbabilities(logProb, condProb);
 
     iteration++;
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(const arma::mat& observations,
+         const arma::vec& probabilities,
+         std::vector<Distribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value.  The log-likelihood
+  // falls out of the normalization.
+  arma::mat logProb, condProb;
+  LogProbabilities(observations, dists, weights, logProb);
+  double l = ConditionalProbabilities(logProb, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
     // This will store the sum of probabilities of each state over all the
     // observations.
     arma::vec probRowSums(dists.size());
@@ -170,19 +141,16 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
       // conditional probability of each point being from Gaussian i
       // multiplied by the probability of the point being from this mixture
       // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
+      const arma::vec pointWeights = condProb.col(i) % probabilities;
+      probRowSums[i] = accu(pointWeights);
 
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
+      dists[i].Mean() = (observations * pointWeights) / probRowSums[i];
 
       // Calculate the new value of the covariances using the updated
       // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
+      CovarianceType cov;
+      WeightedCovariance(observations, pointWeights, dists[i].Mean(), cov);
+      cov /= probRowSums[i];
 
       // Apply covariance constraint.
       constraint.ApplyConstraint(cov);
@@ -194,18 +162,22 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     // probabilities.
     weights = probRowSums / accu(probabilities);
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood, along with the
+    // conditional probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    LogProbabilities(observations, dists, weights, logProb);
+    l = ConditionalProbabilities(logProb, condProb);
 
     iteration++;
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
 InitialClustering(const arma::mat& observations,
-                  std::vector<distribution::GaussianDistribution>& dists,
+                  std::vector<Distribution>& dists,
                   arma::vec& weights)
 {
   // Assignments from clustering.
@@ -215,7 +187,7 @@ InitialClustering(const arma::mat& observations,
   clusterer.Cluster(observations, dists.size(), assignments);
 
   std::vector<arma::vec> means(dists.size());
-  std::vector<arma::mat> covs(dists.size());
+  std::vector<CovarianceType> covs(dists.size());
 
   // Now calculate the means, covariances, and weights.
   weights.zeros();
@@ -235,7 +207,7 @@ InitialClustering(const arma::mat& observations,
     means[cluster] += observations.col(i);
 
     // Add this to the relevant covariance.
-    covs[cluster] += observations.col(i) * trans(observations.col(i));
+    AddScatter(observations.col(i), covs[cluster]);
 
     // Now add one to the weights (we will normalize).
     weights[cluster]++;
@@ -250,8 +222,7 @@ InitialClustering(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     const size_t cluster = assignments[i];
-    const arma::vec normObs = observations.col(i) - means[cluster];
-    covs[cluster] += normObs * normObs.t();
+    AddScatter(observations.col(i) - means[cluster], covs[cluster]);
   }
 
   for (size_t i = 0; i < dists.size(); ++i)
@@ -269,39 +240,153 @@ InitialClustering(const arma::mat& observations,
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
-    const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+LogProbabilities(const arma::mat& observations,
+                 const std::vector<Distribution>& dists,
+                 const arma::vec& weights,
+                 arma::mat& logProbabilities) const
 {
-  double logLikelihood = 0;
+  logProbabilities.set_size(observations.n_cols, dists.size());
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
-
-  for (size_t i = 0; i < dists.size(); ++i)
+  // Each block of observations is independent, so the blocks can be split
+  // across threads.
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols) - 1;
+
+    arma::vec blockLogProbabilities;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(observations.cols(begin, end),
+          blockLogProbabilities);
+      logProbabilities.submat(begin, i, end, i) = blockLogProbabilities +
+          std::log(weights[i]);
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+ConditionalProbabilities(const arma::mat& logProbabilities,
+                         arma::mat& condProbabilities)
+{
+  // Shift each row by its maximum before exponentiating, so that the largest
+  // element of each row is 1.  A row whose maximum is -inf has zero likelihood,
+  // and is not shifted.
+  arma::vec shifts = arma::max(logProbabilities, 1);
+  for (size_t j = 0; j < shifts.n_elem; ++j)
+    if (!std::isfinite(shifts[j]))
+      shifts[j] = 0.0;
+
+  condProbabilities = arma::exp(logProbabilities.each_col() - shifts);
+  const arma::vec sums = arma::sum(condProbabilities, 1);
+
+  // Avoid dividing by zero; if the probability for everything is 0, we don't
+  // want to make it NaN.
+  arma::vec scales = 1.0 / sums;
+  const arma::uvec zeroLikelihood = arma::find(sums == 0.0);
+  scales.elem(zeroLikelihood).zeros();
+  condProbabilities.each_col() %= scales;
+
+  for (size_t j = 0; j < zeroLikelihood.n_elem; ++j)
+    Log::Info << "Likelihood of point " << zeroLikelihood[j] << " is 0!  It is "
+        << "probably an outlier." << std::endl;
+
+  return arma::accu(shifts + arma::log(sums));
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+WeightedCovariance(const arma::mat& observations,
+                   const arma::vec& observationWeights,
+                   const arma::vec& mean,
+                   arma::mat& covariance)
+{
+  covariance.zeros(observations.n_rows, observations.n_rows);
+
+  // Scaling the centered observations by the square roots of their weights
+  // makes each block's contribution a single symmetric product.  Each thread
+  // sums its blocks separately, and the sums are added at the end.
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    arma::mat threadCovariance(observations.n_rows, observations.n_rows,
+        arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+
+      arma::mat centered = observations.cols(begin, end);
+      centered.each_col() -= mean;
+      centered.each_row() %= arma::trans(arma::sqrt(
+          observationWeights.subvec(begin, end)));
+
+      threadCovariance += centered * arma::trans(centered);
+    }
+
+    #pragma omp critical
+    covariance += threadCovariance;
   }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+WeightedCovariance(const arma::mat& observations,
+                   const arma::vec& observationWeights,
+                   const arma::vec& mean,
+                   arma::vec& diagCovariance)
+{
+  diagCovariance.zeros(observations.n_rows);
 
-  return logLikelihood;
+  // Only the diagonal is needed, so each block is one matrix-vector product
+  // of the squared centered observations with their weights.
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
+  {
+    arma::vec threadCovariance(observations.n_rows, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+
+      arma::mat centered = observations.cols(begin, end);
+      centered.each_col() -= mean;
+
+      threadCovariance += arma::square(centered) *
+          observationWeights.subvec(begin, end);
+    }
+
+    #pragma omp critical
+    diagCovariance += threadCovariance;
+  }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
 template<typename Archive>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Serialize(
-    Archive& ar,
-    const unsigned int /* version */)
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Serialize(Archive& ar, const unsigned int /* version */)
 {
   using data::CreateNVP;
 
@@ -57,6 +57,20 @@ class PositiveDefiniteConstraint
     }
   }
 
+  /**
+   * Apply the positive definiteness constraint to the given diagonal
+   * covariance, given as the vector of variances.  The variances are the
+   * eigenvalues, so they are projected in the same way.
+   *
+   * @param diagCovariance Diagonal of the covariance matrix.
+   */
+  static void ApplyConstraint(arma::vec& diagCovariance)
+  {
+    const double minVariance = std::max(diagCovariance.max() / 1e5, 1e-50);
+    for (size_t i = 0; i < diagCovariance.n_elem; ++i)
+      diagCovariance[i] = std::max(diagCovariance[i], minVariance);
+  }
+
   //! Serialize the constraint (which stores nothing, so, nothing to do).
   template<typename Archive>
   static void Serialize(Archive& /* ar */, const unsigned int /* version */) { }
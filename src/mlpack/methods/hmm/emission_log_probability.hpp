@@ -0,0 +1,102 @@
+/**
+ * @file emission_log_probability.hpp
+ *
+ * Utilities shared by the HMM classes to compute the emission log probabilities
+ * of a data sequence in log-space.
+ */
+#ifndef MLPACK_METHODS_HMM_EMISSION_LOG_PROBABILITY_HPP
+#define MLPACK_METHODS_HMM_EMISSION_LOG_PROBABILITY_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * This gives us a HasBatchLogProbability object that we can use to tell
+ * whether or not an emission distribution can compute the log probabilities of
+ * many observations at once.
+ */
+HAS_MEM_FUNC(LogProbability, HasBatchLogProbabilityCheck);
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * LogProbability(const arma::mat& observations, arma::vec& logProbabilities).
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasBatchLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+/**
+ * Compute the log probability of each observation in the given data sequence
+ * under each emission distribution, using the batch LogProbability() of the
+ * distribution.  The returned matrix has rows equal to the number of hidden
+ * states and columns equal to the number of observations.
+ *
+ * @param emission Emission distribution of each hidden state.
+ * @param dataSeq Data sequence to compute probabilities for.
+ * @param logProbs Matrix in which the emission log probabilities will be saved.
+ */
+template<typename Distribution>
+void EmissionLogProbability(
+    const std::vector<Distribution>& emission,
+    const arma::mat& dataSeq,
+    arma::mat& logProbs,
+    const typename boost::enable_if_c<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  logProbs.set_size(emission.size(), dataSeq.n_cols);
+
+  arma::vec stateLogProbs;
+  for (size_t state = 0; state < emission.size(); state++)
+  {
+    emission[state].LogProbability(dataSeq, stateLogProbs);
+    logProbs.row(state) = trans(stateLogProbs);
+  }
+}
+
+/**
+ * Compute the log probability of each observation in the given data sequence
+ * under each emission distribution, one observation at a time, for
+ * distributions without a batch LogProbability().
+ *
+ * @param emission Emission distribution of each hidden state.
+ * @param dataSeq Data sequence to compute probabilities for.
+ * @param logProbs Matrix in which the emission log probabilities will be saved.
+ */
+template<typename Distribution>
+void EmissionLogProbability(
+    const std::vector<Distribution>& emission,
+    const arma::mat& dataSeq,
+    arma::mat& logProbs,
+    const typename boost::disable_if_c<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  logProbs.set_size(emission.size(), dataSeq.n_cols);
+
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+    for (size_t state = 0; state < emission.size(); state++)
+      logProbs(state, t) =
+          log(emission[state].Probability(dataSeq.unsafe_col(t)));
+}
+
+/**
+ * Return log(sum(exp(x))) without underflow.  If every element of x is -inf,
+ * -inf is returned.
+ */
+inline double LogSumExp(const arma::vec& x)
+{
+  const double maxVal = x.max();
+  if (!std::isfinite(maxVal))
+    return maxVal;
+
+  return maxVal + std::log(accu(exp(x - maxVal)));
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
@@ -11,6 +11,8 @@
 
 #include <mlpack/core.hpp>
 
+#include "emission_log_probability.hpp"
+
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
 
@@ -50,6 +52,18 @@ namespace hmm /** Hidden Markov Models. */ {
  * Gaussians (GMM), or any other probability distribution implementing the
  * four Distribution functions.
  *
+ * If the distribution also implements
+ *
+ * @code
+ * void LogProbability(const arma::mat& observations,
+ *                     arma::vec& logProbabilities) const;
+ * @endcode
+ *
+ * (as GaussianDistribution does), it is used to find the log probabilities of
+ * a whole sequence at once.  All of the Forward-Backward and Viterbi
+ * computations are done in log-space, so long sequences and very small
+ * emission probabilities do not underflow.
+ *
  * Usage of the HMM class generally involves either training an HMM or loading
  * an already-known HMM and taking probability measurements of sequences.
  * Example code for supervised training of a Gaussian HMM (that is, where the
@@ -224,6 +238,30 @@ class HMM
   double Estimate(const arma::mat& dataSeq,
                   arma::mat& stateProb) const;
 
+  /**
+   * Estimate the log probabilities of each hidden state at each time step for
+   * each given data observation, using the Forward-Backward algorithm in
+   * log-space.  This is the same as Estimate(), except that the logs of each
+   * of the outputs are given, so nothing underflows.  The log-likelihood of the
+   * sequence is returned.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateLogProb Matrix in which the log probabilities of each state at
+   *    each time interval will be stored.
+   * @param forwardLogProb Matrix in which the log of the (scaled) forward
+   *    probabilities of each state at each time interval will be stored.
+   * @param backwardLogProb Matrix in which the log of the (scaled) backward
+   *    probabilities of each state at each time interval will be stored.
+   * @param logScales Vector in which the log of the scaling factors at each
+   *    time interval will be stored.
+   * @return Log-likelihood of the sequence.
+   */
+  double LogEstimate(const arma::mat& dataSeq,
+                     arma::mat& stateLogProb,
+                     arma::mat& forwardLogProb,
+                     arma::mat& backwardLogProb,
+                     arma::vec& logScales) const;
+
   /**
    * Generate a random data sequence of the given length.  The data sequence is
    * stored in the dataSequence parameter, and the state sequence is stored in
@@ -253,6 +291,21 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel, if OpenMP is available.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence for each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of each most
+   *    probable state sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t> >& stateSeq,
+               arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -353,6 +406,33 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * The Forward algorithm in log-space.  Each step is one matrix-vector
+   * product of the transition matrix with the previous (normalized) forward
+   * probabilities, so only the scaling factors need to be kept as logs.
+   *
+   * @param logProbs Emission log probabilities of each state.
+   * @param logScales Vector in which the log scaling factors will be saved.
+   * @param forwardLogProb Matrix in which the log forward probabilities will
+   *     be saved.
+   */
+  void LogForward(const arma::mat& logProbs,
+                  arma::vec& logScales,
+                  arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm in log-space, using the log scaling factors found
+   * by LogForward().
+   *
+   * @param logProbs Emission log probabilities of each state.
+   * @param logScales Vector of log scaling factors.
+   * @param backwardLogProb Matrix in which the log backward probabilities will
+   *     be saved.
+   */
+  void LogBackward(const arma::mat& logProbs,
+                   const arma::vec& logScales,
+                   arma::mat& backwardLogProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
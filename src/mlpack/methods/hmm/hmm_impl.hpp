@@ -94,10 +94,22 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // don't change between iterations, so the list of them is only built once;
+  // each sequence has its own range of columns, starting at its offset.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -113,49 +125,75 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The E-step of each sequence is independent, so the sequences are split
+    // across threads.  Each thread accumulates its own estimates of the
+    // initial and transition probabilities, which are summed at the end.  The
+    // state probabilities of each sequence go to its own range of
+    // emissionProb, so they need no synchronization.
+    #pragma omp parallel
     {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec threadInitial(transition.n_rows, arma::fill::zeros);
+      arma::mat threadTransition(transition.n_rows, transition.n_cols,
+          arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (intmax_t seq = 0; seq < (intmax_t) dataSeq.size(); seq++)
       {
-        for (size_t j = 0; j < transition.n_cols; ++j)
+        const size_t length = dataSeq[seq].n_cols;
+        if (length == 0)
+          continue;
+
+        arma::mat logProbs;
+        arma::mat forwardLogProb;
+        arma::mat backwardLogProb;
+        arma::vec logScales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        EmissionLogProbability(emission, dataSeq[seq], logProbs);
+        LogForward(logProbs, logScales, forwardLogProb);
+        LogBackward(logProbs, logScales, backwardLogProb);
+        loglik += accu(logScales);
+
+        const arma::mat stateProb = exp(forwardLogProb + backwardLogProb);
+
+        // Add to estimate of initial probability for state j.
+        threadInitial += stateProb.col(0);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // The sum over t of the estimate of T_ij (probability of transition
+        // from state j to state i) is a single matrix product of the scaled
+        // backward-emission terms with the forward probabilities.  We
+        // postpone multiplication of the old T_ij until later.
+        if (length > 1)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          arma::rowvec logNextScales = trans(logScales.subvec(1, length - 1));
+          for (size_t t = 0; t < logNextScales.n_elem; t++)
+            if (!std::isfinite(logNextScales[t]))
+              logNextScales[t] = 0.0;
+
+          arma::mat logNext = backwardLogProb.cols(1, length - 1) +
+              logProbs.cols(1, length - 1);
+          logNext.each_row() -= logNextScales;
+
+          threadTransition += exp(logNext) *
+              trans(exp(forwardLogProb.cols(0, length - 2)));
         }
-        sumTime++;
+
+        // Add to list of emission probabilities, for Distribution::Train().
+        for (size_t j = 0; j < transition.n_cols; ++j)
+          emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+              trans(stateProb.row(j));
+      }
+
+      #pragma omp critical
+      {
+        newInitial += threadInitial;
+        newTransition += threadTransition;
       }
     }
 
@@ -304,16 +342,18 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  arma::mat stateLogProb, forwardLogProb, backwardLogProb;
+  arma::vec logScales;
 
-  // Now assemble the state probability matrix based on the forward and backward
-  // probabilities.
-  stateProb = forwardProb % backwardProb;
+  const double loglik = LogEstimate(dataSeq, stateLogProb, forwardLogProb,
+      backwardLogProb, logScales);
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  stateProb = exp(stateLogProb);
+  forwardProb = exp(forwardLogProb);
+  backwardProb = exp(backwardLogProb);
+  scales = exp(logScales);
+
+  return loglik;
 }
 
 /**
@@ -331,6 +371,33 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
   return Estimate(dataSeq, stateProb, forwardProb, backwardProb, scales);
 }
 
+/**
+ * Estimate the log probabilities of each hidden state at each time step for
+ * each given data observation.
+ */
+template<typename Distribution>
+double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
+                                      arma::mat& stateLogProb,
+                                      arma::mat& forwardLogProb,
+                                      arma::mat& backwardLogProb,
+                                      arma::vec& logScales) const
+{
+  // The emission probabilities are found once, and used in both passes.
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  // First run the forward-backward algorithm.
+  LogForward(logProbs, logScales, forwardLogProb);
+  LogBackward(logProbs, logScales, backwardLogProb);
+
+  // Now assemble the state probability matrix based on the forward and backward
+  // probabilities.
+  stateLogProb = forwardLogProb + backwardLogProb;
+
+  // Finally assemble the log-likelihood and return it.
+  return accu(logScales);
+}
+
 /**
  * Generate a random data sequence of a given length.  The data sequence is
  * stored in the dataSequence parameter, and the state sequence is stored in
@@ -390,41 +457,40 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
+  // probable sequence of states to produce the observed data sequence.  It is
+  // done entirely in log-space.
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(transition.n_rows, dataSeq.n_cols);
 
-  // Store the logs of the transposed transition matrix.  This is because we
-  // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  // Store the logs of the transposed transition matrix, so that column j holds
+  // the log probabilities of transitioning to state j from each state.
+  const arma::mat logTrans(log(trans(transition)));
 
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
+  logStateProb.col(0) = log(initial) + logProbs.col(0);
   for (size_t state = 0; state < transition.n_rows; state++)
-  {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
     stateSeqBack(state, 0) = state;
-  }
 
-  // Store the best first state.
+  arma::mat prob(transition.n_rows, transition.n_rows);
   arma::uword index;
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
+    // Element (i, j) of 'prob' is the log probability of the best path that
+    // reaches state i at time t - 1 and then moves to state j.  Given that we
+    // are in state j, we use the state with the highest probability of being
+    // the previous state.
+    prob = logTrans;
+    prob.each_col() += logStateProb.unsafe_col(t - 1);
     for (size_t j = 0; j < transition.n_rows; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
+      logStateProb(j, t) = prob.unsafe_col(j).max(index) + logProbs(j, t);
+      stateSeqBack(j, t) = index;
     }
   }
 
@@ -438,19 +504,40 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observation sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t> >& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  // The sequences may have very different lengths, so they are handed out
+  // dynamically.
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t seq = 0; seq < (intmax_t) dataSeq.size(); ++seq)
+    logLikelihoods[seq] = Predict(dataSeq[seq], stateSeq[seq]);
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forward;
-  arma::vec scales;
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
 
-  Forward(dataSeq, scales, forward);
+  arma::mat forwardLogProb;
+  arma::vec logScales;
+  LogForward(logProbs, logScales, forwardLogProb);
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  // The log-likelihood is the sum of the log scales for each time step.
+  return accu(logScales);
 }
 
 /**
@@ -502,75 +589,112 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  arma::mat forwardLogProb;
+  arma::vec logScales;
+  LogForward(logProbs, logScales, forwardLogProb);
+
+  forwardProb = exp(forwardLogProb);
+  scales = exp(logScales);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  arma::mat backwardLogProb;
+  LogBackward(logProbs, log(scales), backwardLogProb);
+
+  backwardProb = exp(backwardLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogForward(const arma::mat& logProbs,
+                                   arma::vec& logScales,
+                                   arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardLogProb.set_size(transition.n_rows, logProbs.n_cols);
+  logScales.set_size(logProbs.n_cols);
+  if (logProbs.n_cols == 0)
+    return;
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  arma::vec logAlpha = log(initial) + logProbs.col(0);
 
-  // Then normalize the column.
-  scales[0] = accu(forwardProb.col(0));
-  if (scales[0] > 0.0)
-    forwardProb.col(0) /= scales[0];
-
-  // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  // Now compute the probabilities for each successive observation.  Every
+  // column is normalized, so its exponential is safe to use in the product
+  // with the transition matrix; the emission probabilities are only ever used
+  // as logs.
+  for (size_t t = 0; t < logProbs.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    if (t > 0)
     {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
+      // The forward probability of state j at time t is the sum over all
+      // states of the probability of the previous state transitioning to the
+      // current state and emitting the given observation.
+      logAlpha = log(transition * exp(forwardLogProb.unsafe_col(t - 1))) +
+          logProbs.col(t);
     }
 
     // Normalize probability.
-    scales[t] = accu(forwardProb.col(t));
-    if (scales[t] > 0.0)
-      forwardProb.col(t) /= scales[t];
+    logScales[t] = LogSumExp(logAlpha);
+    if (std::isfinite(logScales[t]))
+      forwardLogProb.col(t) = logAlpha - logScales[t];
+    else
+      forwardLogProb.col(t) = logAlpha;
   }
 }
 
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::LogBackward(const arma::mat& logProbs,
+                                    const arma::vec& logScales,
+                                    arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardLogProb.set_size(transition.n_rows, logProbs.n_cols);
+  if (logProbs.n_cols == 0)
+    return;
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardLogProb.col(logProbs.n_cols - 1).zeros();
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = logProbs.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.  The terms are shifted by their maximum
+    // before leaving log-space for the matrix-vector product.
+    const arma::vec logBeta = backwardLogProb.unsafe_col(t + 1) +
+        logProbs.col(t + 1);
+    const double shift = logBeta.max();
+    if (!std::isfinite(shift))
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
+      backwardLogProb.col(t).fill(-std::numeric_limits<double>::infinity());
+      continue;
     }
+
+    backwardLogProb.col(t) = log(trans(transition) * exp(logBeta - shift)) +
+        shift;
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
   }
 }
 
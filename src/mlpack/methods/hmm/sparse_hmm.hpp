@@ -0,0 +1,302 @@
+/**
+ * @file sparse_hmm.hpp
+ *
+ * Definition of the SparseHMM class, a Hidden Markov Model whose transition
+ * matrix is sparse.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+
+#include <mlpack/core.hpp>
+
+#include "emission_log_probability.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * A Hidden Markov Model with an arbitrary type of emission distribution whose
+ * transition matrix is sparse.  Large models, such as the left-to-right phone
+ * models used in speech recognition, can have thousands of hidden states but
+ * only a handful of possible transitions out of each state.  The dense HMM
+ * class spends O(N^2) time per observation in the Forward-Backward and Viterbi
+ * algorithms no matter how many of those transitions are possible; the
+ * SparseHMM stores the transition matrix as an arma::sp_mat, and every one of
+ * its algorithms takes O(nnz) time per observation, where nnz is the number of
+ * nonzero transition probabilities.
+ *
+ * The interface mirrors that of the HMM class, and the Distribution template
+ * parameter has the same requirements (see the HMM documentation).  All of the
+ * computations are done in log-space.
+ *
+ * Transitions that have zero probability in the initial model are never
+ * re-estimated by the Baum-Welch algorithm, so the sparsity structure given to
+ * the constructor is kept (or reduced) by unsupervised training.  Supervised
+ * training estimates the transition matrix from the given state sequences, so
+ * only the transitions that appear in those sequences are nonzero.
+ *
+ * @code
+ * extern arma::vec initial;
+ * extern arma::sp_mat transition; // transition(i, j) is P(i | j).
+ * extern std::vector<GaussianDistribution> emissions;
+ * extern std::vector<arma::mat> sequences;
+ *
+ * SparseHMM<GaussianDistribution> hmm(initial, transition, emissions);
+ * hmm.Train(sequences);
+ *
+ * arma::Row<size_t> states;
+ * const double logLikelihood = hmm.Predict(sequences[0], states);
+ * @endcode
+ *
+ * @tparam Distribution Type of emission distribution for this HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class SparseHMM
+{
+ public:
+  /**
+   * Create an empty SparseHMM with no hidden states.  This is mostly useful
+   * before loading a model.
+   *
+   * @param tolerance Tolerance for convergence of training algorithm
+   *      (Baum-Welch).
+   */
+  SparseHMM(const double tolerance = 1e-5);
+
+  /**
+   * Create the SparseHMM with the given initial probability vector, the given
+   * sparse transition matrix, and the given emission distributions.  The
+   * dimensionality of the observations is taken from the given emission
+   * distributions.
+   *
+   * The transition matrix should be such that T(i, j) is the probability of
+   * transition to state i from state j.  The columns of the matrix should sum
+   * to 1.
+   *
+   * @param initial Initial state probabilities.
+   * @param transition Sparse transition matrix.
+   * @param emission Emission distributions.
+   * @param tolerance Tolerance for convergence of training algorithm
+   *      (Baum-Welch).
+   */
+  SparseHMM(const arma::vec& initial,
+            const arma::sp_mat& transition,
+            const std::vector<Distribution>& emission,
+            const double tolerance = 1e-5);
+
+  /**
+   * Train the model using the Baum-Welch algorithm, with only the given
+   * unlabeled observations.  The E-step of each sequence is run in parallel,
+   * if OpenMP is available.  See HMM::Train() for more details.
+   *
+   * @param dataSeq Vector of observation sequences.
+   */
+  void Train(const std::vector<arma::mat>& dataSeq);
+
+  /**
+   * Train the model using the given labeled observations; the transition and
+   * emission matrices are directly estimated.  See HMM::Train() for more
+   * details.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector of state sequences, corresponding to each
+   *     observation.
+   */
+  void Train(const std::vector<arma::mat>& dataSeq,
+             const std::vector<arma::Row<size_t> >& stateSeq);
+
+  /**
+   * Estimate the probabilities of each hidden state at each time step for each
+   * given data observation, using the Forward-Backward algorithm.  See
+   * HMM::Estimate() for more details.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateProb Matrix in which the probabilities of each state at each
+   *    time interval will be stored.
+   * @param forwardProb Matrix in which the forward probabilities of each state
+   *    at each time interval will be stored.
+   * @param backwardProb Matrix in which the backward probabilities of each
+   *    state at each time interval will be stored.
+   * @param scales Vector in which the scaling factors at each time interval
+   *    will be stored.
+   * @return Log-likelihood of the sequence.
+   */
+  double Estimate(const arma::mat& dataSeq,
+                  arma::mat& stateProb,
+                  arma::mat& forwardProb,
+                  arma::mat& backwardProb,
+                  arma::vec& scales) const;
+
+  /**
+   * Estimate the probabilities of each hidden state at each time step of each
+   * given data observation, using the Forward-Backward algorithm.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateProb Probabilities of each state at each time interval.
+   * @return Log-likelihood of the sequence.
+   */
+  double Estimate(const arma::mat& dataSeq,
+                  arma::mat& stateProb) const;
+
+  /**
+   * Estimate the log probabilities of each hidden state at each time step for
+   * each given data observation, using the Forward-Backward algorithm in
+   * log-space.  See HMM::LogEstimate() for more details.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateLogProb Matrix in which the log probabilities of each state at
+   *    each time interval will be stored.
+   * @param forwardLogProb Matrix in which the log of the (scaled) forward
+   *    probabilities of each state at each time interval will be stored.
+   * @param backwardLogProb Matrix in which the log of the (scaled) backward
+   *    probabilities of each state at each time interval will be stored.
+   * @param logScales Vector in which the log of the scaling factors at each
+   *    time interval will be stored.
+   * @return Log-likelihood of the sequence.
+   */
+  double LogEstimate(const arma::mat& dataSeq,
+                     arma::mat& stateLogProb,
+                     arma::mat& forwardLogProb,
+                     arma::mat& backwardLogProb,
+                     arma::vec& logScales) const;
+
+  /**
+   * Generate a random data sequence of the given length.  The data sequence is
+   * stored in the dataSequence parameter, and the state sequence is stored in
+   * the stateSequence parameter.  Each column of dataSequence represents a
+   * random observation.
+   *
+   * @param length Length of random sequence to generate.
+   * @param dataSequence Vector to store data in.
+   * @param stateSequence Vector to store states in.
+   * @param startState Hidden state to start sequence in (default 0).
+   */
+  void Generate(const size_t length,
+                arma::mat& dataSequence,
+                arma::Row<size_t>& stateSequence,
+                const size_t startState = 0) const;
+
+  /**
+   * Compute the most probable hidden state sequence for the given data
+   * sequence, using the Viterbi algorithm, returning the log-likelihood of the
+   * most likely state sequence.  Only the nonzero transitions are considered
+   * at each step.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq) const;
+
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel, if OpenMP is available.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence for each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of each most
+   *    probable state sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t> >& stateSeq,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of the given data sequence.
+   *
+   * @param dataSeq Data sequence to evaluate the likelihood of.
+   * @return Log-likelihood of the given sequence.
+   */
+  double LogLikelihood(const arma::mat& dataSeq) const;
+
+  //! Return the vector of initial state probabilities.
+  const arma::vec& Initial() const { return initial; }
+  //! Modify the vector of initial state probabilities.
+  arma::vec& Initial() { return initial; }
+
+  //! Return the sparse transition matrix.
+  const arma::sp_mat& Transition() const { return transition; }
+  //! Return a modifiable sparse transition matrix reference.
+  arma::sp_mat& Transition() { return transition; }
+
+  //! Return the emission distributions.
+  const std::vector<Distribution>& Emission() const { return emission; }
+  //! Return a modifiable emission probability matrix reference.
+  std::vector<Distribution>& Emission() { return emission; }
+
+  //! Get the dimensionality of observations.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Set the dimensionality of observations.
+  size_t& Dimensionality() { return dimensionality; }
+
+  //! Get the tolerance of the Baum-Welch algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the Baum-Welch algorithm.
+  double& Tolerance() { return tolerance; }
+
+  /**
+   * Serialize the object.
+   */
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * The Forward algorithm in log-space.  Each step is one product of the sparse
+   * transition matrix with the previous (normalized) forward probabilities.
+   *
+   * @param logProbs Emission log probabilities of each state.
+   * @param logScales Vector in which the log scaling factors will be saved.
+   * @param forwardLogProb Matrix in which the log forward probabilities will
+   *     be saved.
+   */
+  void LogForward(const arma::mat& logProbs,
+                  arma::vec& logScales,
+                  arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm in log-space, using the log scaling factors found
+   * by LogForward().
+   *
+   * @param logProbs Emission log probabilities of each state.
+   * @param logScales Vector of log scaling factors.
+   * @param backwardLogProb Matrix in which the log backward probabilities will
+   *     be saved.
+   */
+  void LogBackward(const arma::mat& logProbs,
+                   const arma::vec& logScales,
+                   arma::mat& backwardLogProb) const;
+
+  /**
+   * Extract the row index, column index, and value of each nonzero element of
+   * the transition matrix, in column-major order.
+   */
+  void NonZeros(arma::uvec& rows, arma::uvec& cols, arma::vec& values) const;
+
+  //! Set of emission probability distributions; one for each state.
+  std::vector<Distribution> emission;
+
+  //! Sparse transition probability matrix.
+  arma::sp_mat transition;
+
+  //! Initial state probability vector.
+  arma::vec initial;
+
+  //! Dimensionality of observations.
+  size_t dimensionality;
+
+  //! Tolerance of Baum-Welch algorithm.
+  double tolerance;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_hmm_impl.hpp"
+
+#endif
@@ -0,0 +1,615 @@
+/**
+ * @file sparse_hmm_impl.hpp
+ *
+ * Implementation of the SparseHMM class.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "sparse_hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * Create an empty SparseHMM.
+ */
+template<typename Distribution>
+SparseHMM<Distribution>::SparseHMM(const double tolerance) :
+    dimensionality(0),
+    tolerance(tolerance)
+{ /* Nothing to do. */ }
+
+/**
+ * Create the SparseHMM with the given initial probabilities, sparse transition
+ * matrix, and emission distributions.
+ */
+template<typename Distribution>
+SparseHMM<Distribution>::SparseHMM(const arma::vec& initial,
+                                   const arma::sp_mat& transition,
+                                   const std::vector<Distribution>& emission,
+                                   const double tolerance) :
+    emission(emission),
+    transition(transition),
+    initial(initial),
+    tolerance(tolerance)
+{
+  // Set the dimensionality, if we can.
+  if (emission.size() > 0)
+    dimensionality = emission[0].Dimensionality();
+  else
+  {
+    Log::Warn << "SparseHMM::SparseHMM(): no emission distributions given; "
+        << "assuming a dimensionality of 0 and hoping it gets set right later."
+        << std::endl;
+    dimensionality = 0;
+  }
+}
+
+/**
+ * Train the model using the Baum-Welch algorithm, with only the given unlabeled
+ * observations.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
+{
+  double loglik = 0;
+  double oldLoglik = 0;
+
+  // Maximum iterations?
+  size_t iterations = 1000;
+
+  // Find length of all sequences and ensure they are the correct size.
+  size_t totalLength = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    totalLength += dataSeq[seq].n_cols;
+
+    if (dataSeq[seq].n_rows != dimensionality)
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+  }
+
+  // The observations of every sequence are collected once, for the training of
+  // the emission distributions.
+  std::vector<arma::vec> emissionProb(transition.n_cols,
+      arma::vec(totalLength));
+  arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
+
+  for (size_t iter = 0; iter < iterations; iter++)
+  {
+    // Only the nonzero transitions are re-estimated; every other transition
+    // would be estimated as zero anyway.
+    arma::uvec rows, cols;
+    arma::vec values;
+    NonZeros(rows, cols, values);
+
+    arma::vec newInitial(transition.n_rows, arma::fill::zeros);
+    arma::vec newValues(values.n_elem, arma::fill::zeros);
+
+    loglik = 0;
+
+    // The E-step of each sequence is independent, so the sequences are split
+    // across threads, as in HMM::Train().
+    #pragma omp parallel
+    {
+      arma::vec threadInitial(transition.n_rows, arma::fill::zeros);
+      arma::vec threadValues(values.n_elem, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (intmax_t seq = 0; seq < (intmax_t) dataSeq.size(); seq++)
+      {
+        const size_t length = dataSeq[seq].n_cols;
+        if (length == 0)
+          continue;
+
+        arma::mat logProbs;
+        arma::mat forwardLogProb;
+        arma::mat backwardLogProb;
+        arma::vec logScales;
+
+        EmissionLogProbability(emission, dataSeq[seq], logProbs);
+        LogForward(logProbs, logScales, forwardLogProb);
+        LogBackward(logProbs, logScales, backwardLogProb);
+        loglik += accu(logScales);
+
+        const arma::mat stateProb = exp(forwardLogProb + backwardLogProb);
+        threadInitial += stateProb.col(0);
+
+        // The estimate of a nonzero transition from state j to state i is the
+        // sum over time of the scaled backward-emission term of state i at
+        // time t + 1 and the forward probability of state j at time t.  With
+        // both matrices transposed, that sum is a dot product of two
+        // contiguous columns, so this takes O(T nnz) time.
+        if (length > 1)
+        {
+          arma::rowvec logNextScales = trans(logScales.subvec(1, length - 1));
+          for (size_t t = 0; t < logNextScales.n_elem; t++)
+            if (!std::isfinite(logNextScales[t]))
+              logNextScales[t] = 0.0;
+
+          arma::mat logNext = backwardLogProb.cols(1, length - 1) +
+              logProbs.cols(1, length - 1);
+          logNext.each_row() -= logNextScales;
+
+          const arma::mat next = trans(exp(logNext));
+          const arma::mat prev = trans(exp(forwardLogProb.cols(0,
+              length - 2)));
+          for (size_t k = 0; k < values.n_elem; ++k)
+            threadValues[k] += dot(next.unsafe_col(rows[k]),
+                prev.unsafe_col(cols[k]));
+        }
+
+        for (size_t j = 0; j < transition.n_cols; ++j)
+          emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+              trans(stateProb.row(j));
+      }
+
+      #pragma omp critical
+      {
+        newInitial += threadInitial;
+        newValues += threadValues;
+      }
+    }
+
+    // Normalize the new initial probabilities.
+    if (dataSeq.size() > 1)
+      initial = newInitial / dataSeq.size();
+    else
+      initial = newInitial;
+
+    // Multiply in the old transition probabilities, then normalize each
+    // column.  A column with no probability mass keeps its old values.
+    newValues %= values;
+    arma::vec sums(transition.n_cols, arma::fill::zeros);
+    for (size_t k = 0; k < values.n_elem; ++k)
+      sums[cols[k]] += newValues[k];
+    for (size_t k = 0; k < values.n_elem; ++k)
+    {
+      if (sums[cols[k]] > 0.0)
+        newValues[k] /= sums[cols[k]];
+      else
+        newValues[k] = values[k];
+    }
+
+    arma::umat locations(2, values.n_elem);
+    locations.row(0) = trans(rows);
+    locations.row(1) = trans(cols);
+    transition = arma::sp_mat(locations, newValues, transition.n_rows,
+        transition.n_cols);
+
+    // Now estimate emission probabilities.
+    for (size_t state = 0; state < transition.n_cols; state++)
+      emission[state].Train(emissionList, emissionProb[state]);
+
+    Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
+        << "." << std::endl;
+
+    if (std::abs(oldLoglik - loglik) < tolerance)
+    {
+      Log::Debug << "Converged after " << iter << " iterations." << std::endl;
+      break;
+    }
+
+    oldLoglik = loglik;
+  }
+}
+
+/**
+ * Train the model using the given labeled observations; the transition and
+ * emission matrices are directly estimated.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Train(
+    const std::vector<arma::mat>& dataSeq,
+    const std::vector<arma::Row<size_t> >& stateSeq)
+{
+  // Simple error checking.
+  if (dataSeq.size() != stateSeq.size())
+  {
+    Log::Fatal << "SparseHMM::Train(): number of data sequences ("
+        << dataSeq.size() << ") not equal to number of state sequences ("
+        << stateSeq.size() << ")." << std::endl;
+  }
+
+  const size_t states = emission.size();
+  initial.zeros(states);
+
+  // Count the transitions that are seen.  The key is (from, to), so that the
+  // counts are ordered by column.
+  std::map<std::pair<size_t, size_t>, double> counts;
+  std::vector<std::vector<std::pair<size_t, size_t> > > emissionList(states);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols != stateSeq[seq].n_elem)
+    {
+      Log::Fatal << "SparseHMM::Train(): number of observations ("
+          << dataSeq[seq].n_cols << ") in sequence " << seq
+          << " not equal to number of states (" << stateSeq[seq].n_cols
+          << ") in sequence " << seq << "." << std::endl;
+    }
+
+    if (dataSeq[seq].n_rows != dimensionality)
+    {
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+    }
+
+    initial[stateSeq[seq][0]]++;
+    for (size_t t = 0; t < dataSeq[seq].n_cols - 1; t++)
+    {
+      counts[std::make_pair(stateSeq[seq][t], stateSeq[seq][t + 1])]++;
+      emissionList[stateSeq[seq][t]].push_back(std::make_pair(seq, t));
+    }
+
+    // Last observation.
+    emissionList[stateSeq[seq][stateSeq[seq].n_elem - 1]].push_back(
+        std::make_pair(seq, stateSeq[seq].n_elem - 1));
+  }
+
+  // Normalize initial weights.
+  initial /= accu(initial);
+
+  // Normalize each column of counts, and build the transition matrix in one
+  // batch.
+  arma::vec sums(states, arma::fill::zeros);
+  std::map<std::pair<size_t, size_t>, double>::const_iterator it;
+  for (it = counts.begin(); it != counts.end(); ++it)
+    sums[it->first.first] += it->second;
+
+  arma::umat locations(2, counts.size());
+  arma::vec values(counts.size());
+  size_t k = 0;
+  for (it = counts.begin(); it != counts.end(); ++it, ++k)
+  {
+    locations(0, k) = it->first.second;
+    locations(1, k) = it->first.first;
+    values[k] = it->second / sums[it->first.first];
+  }
+  transition = arma::sp_mat(locations, values, states, states);
+
+  // Estimate emission matrix.
+  for (size_t state = 0; state < states; state++)
+  {
+    if (emissionList[state].size() > 0)
+    {
+      arma::mat emissions(dimensionality, emissionList[state].size());
+      for (size_t i = 0; i < emissions.n_cols; i++)
+      {
+        emissions.col(i) = dataSeq[emissionList[state][i].first].col(
+            emissionList[state][i].second);
+      }
+
+      emission[state].Train(emissions);
+    }
+    else
+    {
+      Log::Warn << "There are no observations in training data with hidden "
+          << "state " << state << "!  The corresponding emission distribution "
+          << "is likely to be meaningless." << std::endl;
+    }
+  }
+}
+
+/**
+ * Estimate the probabilities of each hidden state at each time step for each
+ * given data observation.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::Estimate(const arma::mat& dataSeq,
+                                         arma::mat& stateProb,
+                                         arma::mat& forwardProb,
+                                         arma::mat& backwardProb,
+                                         arma::vec& scales) const
+{
+  arma::mat stateLogProb, forwardLogProb, backwardLogProb;
+  arma::vec logScales;
+
+  const double loglik = LogEstimate(dataSeq, stateLogProb, forwardLogProb,
+      backwardLogProb, logScales);
+
+  stateProb = exp(stateLogProb);
+  forwardProb = exp(forwardLogProb);
+  backwardProb = exp(backwardLogProb);
+  scales = exp(logScales);
+
+  return loglik;
+}
+
+/**
+ * Estimate the probabilities of each hidden state at each time step for each
+ * given data observation.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::Estimate(const arma::mat& dataSeq,
+                                         arma::mat& stateProb) const
+{
+  // We don't need to save these.
+  arma::mat forwardProb, backwardProb;
+  arma::vec scales;
+
+  return Estimate(dataSeq, stateProb, forwardProb, backwardProb, scales);
+}
+
+/**
+ * Estimate the log probabilities of each hidden state at each time step for
+ * each given data observation.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
+                                            arma::mat& stateLogProb,
+                                            arma::mat& forwardLogProb,
+                                            arma::mat& backwardLogProb,
+                                            arma::vec& logScales) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  LogForward(logProbs, logScales, forwardLogProb);
+  LogBackward(logProbs, logScales, backwardLogProb);
+
+  stateLogProb = forwardLogProb + backwardLogProb;
+
+  return accu(logScales);
+}
+
+/**
+ * Generate a random data sequence of a given length.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Generate(const size_t length,
+                                       arma::mat& dataSequence,
+                                       arma::Row<size_t>& stateSequence,
+                                       const size_t startState) const
+{
+  // Set vectors to the right size.
+  stateSequence.set_size(length);
+  dataSequence.set_size(dimensionality, length);
+
+  // Set start state (default is 0).
+  stateSequence[0] = startState;
+  dataSequence.col(0) = emission[startState].Random();
+
+  for (size_t t = 1; t < length; t++)
+  {
+    // Find where our random value sits in the distribution of state changes.
+    // Only the nonzero elements of the column need to be visited.  If the
+    // probabilities do not quite sum to 1, the last possible state is used.
+    const double randValue = math::Random();
+    double probSum = 0;
+    arma::sp_mat::const_iterator it = transition.begin_col(
+        stateSequence[t - 1]);
+    const arma::sp_mat::const_iterator end = transition.end_col(
+        stateSequence[t - 1]);
+    for (; it != end; ++it)
+    {
+      stateSequence[t] = it.row();
+      probSum += (*it);
+      if (randValue <= probSum)
+        break;
+    }
+
+    // Now choose the emission.
+    dataSequence.col(t) = emission[stateSequence[t]].Random();
+  }
+}
+
+/**
+ * Compute the most probable hidden state sequence for the given observation
+ * using the Viterbi algorithm.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                        arma::Row<size_t>& stateSeq) const
+{
+  stateSeq.set_size(dataSeq.n_cols);
+  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(transition.n_rows, dataSeq.n_cols);
+
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  arma::uvec rows, cols;
+  arma::vec values;
+  NonZeros(rows, cols, values);
+  const arma::vec logValues = log(values);
+
+  logStateProb.col(0) = log(initial) + logProbs.col(0);
+  for (size_t state = 0; state < transition.n_rows; state++)
+    stateSeqBack(state, 0) = state;
+
+  arma::vec best(transition.n_rows);
+  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  {
+    // Each nonzero transition from state j to state i is a candidate for the
+    // best path reaching state i at time t.  States that cannot be reached
+    // keep a log probability of -inf.
+    best.fill(-std::numeric_limits<double>::infinity());
+    for (size_t state = 0; state < transition.n_rows; state++)
+      stateSeqBack(state, t) = state;
+
+    for (size_t k = 0; k < logValues.n_elem; ++k)
+    {
+      const double prob = logStateProb(cols[k], t - 1) + logValues[k];
+      if (prob > best[rows[k]])
+      {
+        best[rows[k]] = prob;
+        stateSeqBack(rows[k], t) = cols[k];
+      }
+    }
+
+    logStateProb.col(t) = best + logProbs.col(t);
+  }
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
+  stateSeq[dataSeq.n_cols - 1] = index;
+  for (size_t t = 2; t <= dataSeq.n_cols; t++)
+    stateSeq[dataSeq.n_cols - t] =
+        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
+
+  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+}
+
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observation sequences, in parallel.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Predict(
+    const std::vector<arma::mat>& dataSeq,
+    std::vector<arma::Row<size_t> >& stateSeq,
+    arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t seq = 0; seq < (intmax_t) dataSeq.size(); ++seq)
+    logLikelihoods[seq] = Predict(dataSeq[seq], stateSeq[seq]);
+}
+
+/**
+ * Compute the log-likelihood of the given data sequence.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(emission, dataSeq, logProbs);
+
+  arma::mat forwardLogProb;
+  arma::vec logScales;
+  LogForward(logProbs, logScales, forwardLogProb);
+
+  // The log-likelihood is the sum of the log scales for each time step.
+  return accu(logScales);
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::LogForward(const arma::mat& logProbs,
+                                         arma::vec& logScales,
+                                         arma::mat& forwardLogProb) const
+{
+  forwardLogProb.set_size(transition.n_rows, logProbs.n_cols);
+  logScales.set_size(logProbs.n_cols);
+  if (logProbs.n_cols == 0)
+    return;
+
+  arma::vec logAlpha = log(initial) + logProbs.col(0);
+  arma::vec alpha;
+  for (size_t t = 0; t < logProbs.n_cols; t++)
+  {
+    if (t > 0)
+    {
+      // The sparse product only visits the nonzero transitions.
+      alpha = exp(forwardLogProb.unsafe_col(t - 1));
+      logAlpha = log(arma::vec(transition * alpha)) + logProbs.col(t);
+    }
+
+    // Normalize probability.
+    logScales[t] = LogSumExp(logAlpha);
+    if (std::isfinite(logScales[t]))
+      forwardLogProb.col(t) = logAlpha - logScales[t];
+    else
+      forwardLogProb.col(t) = logAlpha;
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::LogBackward(const arma::mat& logProbs,
+                                          const arma::vec& logScales,
+                                          arma::mat& backwardLogProb) const
+{
+  backwardLogProb.set_size(transition.n_rows, logProbs.n_cols);
+  if (logProbs.n_cols == 0)
+    return;
+
+  // The transpose is found once, so that each step is a sparse product.
+  const arma::sp_mat transitionT = trans(transition);
+
+  // The last element probability is 1.
+  backwardLogProb.col(logProbs.n_cols - 1).zeros();
+
+  for (size_t t = logProbs.n_cols - 2; t + 1 > 0; t--)
+  {
+    const arma::vec logBeta = backwardLogProb.unsafe_col(t + 1) +
+        logProbs.col(t + 1);
+    const double shift = logBeta.max();
+    if (!std::isfinite(shift))
+    {
+      backwardLogProb.col(t).fill(-std::numeric_limits<double>::infinity());
+      continue;
+    }
+
+    const arma::vec beta = exp(logBeta - shift);
+    backwardLogProb.col(t) = log(arma::vec(transitionT * beta)) + shift;
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
+  }
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::NonZeros(arma::uvec& rows,
+                                       arma::uvec& cols,
+                                       arma::vec& values) const
+{
+  rows.set_size(transition.n_nonzero);
+  cols.set_size(transition.n_nonzero);
+  values.set_size(transition.n_nonzero);
+
+  size_t k = 0;
+  for (arma::sp_mat::const_iterator it = transition.begin();
+       it != transition.end(); ++it, ++k)
+  {
+    rows[k] = it.row();
+    cols[k] = it.col();
+    values[k] = (*it);
+  }
+}
+
+//! Serialize the SparseHMM.
+template<typename Distribution>
+template<typename Archive>
+void SparseHMM<Distribution>::Serialize(Archive& ar,
+                                        const unsigned int /* version */)
+{
+  ar & data::CreateNVP(dimensionality, "dimensionality");
+  ar & data::CreateNVP(tolerance, "tolerance");
+  ar & data::CreateNVP(transition, "transition");
+  ar & data::CreateNVP(initial, "initial");
+
+  // Now serialize each emission.  If we are loading, we must resize the vector
+  // of emissions correctly.
+  if (Archive::is_loading::value)
+    emission.resize(transition.n_rows);
+
+  // Load the emissions; generate the correct name for each one.
+  for (size_t i = 0; i < emission.size(); ++i)
+  {
+    std::ostringstream oss;
+    oss << "emission" << i;
+    ar & data::CreateNVP(emission[i], oss.str());
+  }
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
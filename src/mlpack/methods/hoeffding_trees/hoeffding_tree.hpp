@@ -184,6 +184,12 @@ class HoeffdingTree
   //! Modify the probability of the majority class.
   double& MajorityProbability() { return majorityProbability; }
 
+  //! Get the number of classes the tree is trained on.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the information on the dataset (the type of each feature).
+  const data::DatasetInfo& Info() const { return *datasetInfo; }
+
   //! Get the number of children.
   size_t NumChildren() const { return children.size(); }
 
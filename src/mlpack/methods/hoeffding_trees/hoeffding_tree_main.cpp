@@ -8,6 +8,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
+#include <memory>
 #include <queue>
 
 using namespace std;
@@ -39,7 +40,18 @@ PROGRAM_INFO("Hoeffding trees",
     " with the --test_labels_file (-L) option.  Predictions for each test point"
     " will be stored in the file specified by --predictions_file (-p) and "
     "probabilities for each predictions will be stored in the file specified by"
-    " the --probabilities_file (-P) option.");
+    " the --probabilities_file (-P) option."
+    "\n\n"
+    "Datasets too large to fit in memory, or unbounded streams, can be trained "
+    "on by specifying --chunk_size (-C): then the training file (and labels "
+    "file) are read that many points at a time, and each chunk is classified "
+    "before the tree is trained on it, to report the accuracy on points that "
+    "have not been seen yet.  Streamed data must be numeric text or mappable "
+    "binary (.mbin) data; categorical dimensions of an input model must hold "
+    "category indices.  The training file may be '-' to read from standard "
+    "input.  If --labels_file is not given, the labels are taken from the last "
+    "dimension of each point.  Unless an input model is given, the number of "
+    "classes must be specified with --num_classes (-k).");
 
 PARAM_STRING("training_file", "Training dataset file.", "t", "");
 PARAM_STRING("labels_file", "Labels for training dataset.", "l", "");
@@ -69,6 +81,10 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT("chunk_size", "If nonzero, stream the training set from disk (or "
+    "standard input) this many points at a time.", "C", 0);
+PARAM_INT("num_classes", "Number of classes in the training set; required when "
+    "streaming without an input model.", "k", 0);
 
 PARAM_INT("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -81,6 +97,12 @@ template<typename TreeType>
 void PerformActions(const typename TreeType::NumericSplit& numericSplit =
     typename TreeType::NumericSplit(0));
 
+// Helper function to train a tree (or create one, if tree is NULL) on a stream.
+template<typename TreeType>
+TreeType* StreamingTrain(TreeType* tree,
+                         DatasetInfo& datasetInfo,
+                         const typename TreeType::NumericSplit& numericSplit);
+
 int main(int argc, char** argv)
 {
   CLI::ParseCommandLine(argc, argv);
@@ -107,10 +129,26 @@ int main(int argc, char** argv)
     Log::Fatal << "One of --training_file or --input_model_file must be "
         << "specified!" << endl;
 
-  if (CLI::HasParam("training_file") && !CLI::HasParam("labels_file"))
+  const bool streaming = (CLI::GetParam<int>("chunk_size") > 0);
+  if (CLI::GetParam<int>("chunk_size") < 0)
+    Log::Fatal << "Invalid chunk size (" << CLI::GetParam<int>("chunk_size")
+        << "); must be nonnegative." << endl;
+
+  if (CLI::HasParam("training_file") && !CLI::HasParam("labels_file") &&
+      !streaming)
     Log::Fatal << "If --training_file is specified, --labels_file must be "
         << "specified too!" << endl;
 
+  if (streaming && CLI::HasParam("training_file") &&
+      !CLI::HasParam("input_model_file") && CLI::GetParam<int>("num_classes")
+      <= 0)
+    Log::Fatal << "--num_classes (-k) must be specified when streaming the "
+        << "training set without an input model." << endl;
+
+  if (streaming && CLI::HasParam("batch_mode"))
+    Log::Warn << "--batch_mode (-b) ignored because --chunk_size was "
+        << "specified." << endl;
+
   if (!CLI::HasParam("training_file") && CLI::HasParam("batch_mode"))
     Log::Warn << "--batch_mode (-b) ignored; no training set provided." << endl;
 
@@ -188,10 +226,15 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
   const size_t passes = (size_t) CLI::GetParam<int>("passes");
   if (passes > 1)
     batchTraining = false; // We already warned about this earlier.
+  const bool streaming = (CLI::GetParam<int>("chunk_size") > 0);
 
   TreeType* tree = NULL;
   DatasetInfo datasetInfo;
-  if (!CLI::HasParam("input_model_file"))
+  if (!CLI::HasParam("input_model_file") && streaming)
+  {
+    tree = StreamingTrain<TreeType>(NULL, datasetInfo, numericSplit);
+  }
+  else if (!CLI::HasParam("input_model_file"))
   {
     arma::mat trainingSet;
     data::Load(trainingFile, trainingSet, datasetInfo, true);
@@ -221,7 +264,11 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     tree = new TreeType(datasetInfo, 1, 1);
     data::Load(inputModelFile, "streamingDecisionTree", *tree, true);
 
-    if (CLI::HasParam("training_file"))
+    if (CLI::HasParam("training_file") && streaming)
+    {
+      StreamingTrain(tree, datasetInfo, numericSplit);
+    }
+    else if (CLI::HasParam("training_file"))
     {
       arma::mat trainingSet;
       data::Load(trainingFile, trainingSet, datasetInfo, true);
@@ -249,7 +296,9 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     }
   }
 
-  if (CLI::HasParam("training_file"))
+  // When streaming, the accuracy on the stream has already been reported, and
+  // the training set can't be held in memory (or read again).
+  if (CLI::HasParam("training_file") && !streaming)
   {
     // Get training error.
     arma::mat trainingSet;
@@ -331,3 +380,117 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
   // Clean up memory.
   delete tree;
 }
+
+template<typename TreeType>
+TreeType* StreamingTrain(TreeType* tree,
+                         DatasetInfo& datasetInfo,
+                         const typename TreeType::NumericSplit& numericSplit)
+{
+  const string trainingFile = CLI::GetParam<string>("training_file");
+  const string labelsFile = CLI::GetParam<string>("labels_file");
+  const double confidence = CLI::GetParam<double>("confidence");
+  const size_t maxSamples = (size_t) CLI::GetParam<int>("max_samples");
+  const size_t minSamples = (size_t) CLI::GetParam<int>("min_samples");
+  const size_t passes = (size_t) CLI::GetParam<int>("passes");
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+  const size_t numClasses = (tree == NULL) ?
+      (size_t) CLI::GetParam<int>("num_classes") : tree->NumClasses();
+
+  if (passes > 1 && (trainingFile == "-" || labelsFile == "-"))
+    Log::Fatal << "Cannot take more than one pass over standard input." << endl;
+  if (trainingFile == "-" && labelsFile == "-")
+    Log::Fatal << "The training set and labels can't both be read from "
+        << "standard input." << endl;
+
+  if (passes > 1)
+    Log::Info << "Taking " << passes << " passes over the dataset." << endl;
+
+  // Each chunk is classified before the tree is trained on it, so the accuracy
+  // is measured on points the tree hasn't seen (on the first pass).
+  size_t correct = 0;
+  size_t total = 0;
+
+  Timer::Start("tree_training");
+  try
+  {
+    for (size_t pass = 0; pass < passes; ++pass)
+    {
+      data::StreamingLoader trainingStream(trainingFile, chunkSize);
+      unique_ptr<data::StreamingLoader> labelsStream;
+      if (!labelsFile.empty())
+        labelsStream.reset(new data::StreamingLoader(labelsFile, chunkSize));
+
+      arma::mat chunk;
+      arma::Mat<size_t> labelsChunk;
+      arma::Row<size_t> labels;
+      while (trainingStream.Next(chunk) > 0)
+      {
+        if (labelsStream)
+        {
+          if (labelsStream->Next(labelsChunk) != chunk.n_cols ||
+              labelsChunk.n_rows != 1)
+            throw runtime_error("the labels file must hold one label for each "
+                "point of the training set");
+          labels = labelsChunk.row(0);
+        }
+        else
+        {
+          // The labels are the last dimension.
+          labels = arma::conv_to<arma::Row<size_t>>::from(
+              chunk.row(chunk.n_rows - 1));
+          chunk.shed_row(chunk.n_rows - 1);
+        }
+
+        if (tree == NULL)
+        {
+          datasetInfo = DatasetInfo(chunk.n_rows);
+          tree = new TreeType(datasetInfo, numClasses, confidence, maxSamples,
+              100, minSamples, typename TreeType::CategoricalSplit(0, 0),
+              numericSplit);
+        }
+
+        if (chunk.n_rows != tree->Info().Dimensionality())
+        {
+          ostringstream oss;
+          oss << "the training set has " << chunk.n_rows << " dimensions, but "
+              << "the model has " << tree->Info().Dimensionality();
+          throw runtime_error(oss.str());
+        }
+        if (arma::max(labels) >= numClasses)
+        {
+          ostringstream oss;
+          oss << "label " << arma::max(labels) << " is out of range; there are "
+              << "only " << numClasses << " classes";
+          throw runtime_error(oss.str());
+        }
+
+        if (pass == 0)
+        {
+          arma::Row<size_t> predictions;
+          tree->Classify(chunk, predictions);
+          correct += arma::accu(predictions == labels);
+          total += labels.n_elem;
+        }
+
+        tree->Train(chunk, labels, false);
+      }
+    }
+  }
+  catch (runtime_error& e)
+  {
+    Log::Fatal << "Streaming the training set failed: " << e.what() << "."
+        << endl;
+  }
+  Timer::Stop("tree_training");
+
+  if (tree == NULL)
+    Log::Fatal << "The training set '" << trainingFile << "' is empty!"
+        << endl;
+
+  if (total > 0)
+    Log::Info << correct << " out of " << total << " correct on the training "
+        << "stream before training on each point (" << double(correct) /
+        double(total) * 100.0 << ")." << endl;
+
+  return tree;
+}
@@ -25,6 +25,15 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * If the tree type is a BinarySpaceTree, the tree built on the centroids in the
+ * first iteration is kept, and in each later iteration the moved centroids are
+ * copied into it and its bounds are refit (see BinarySpaceTree::RefitBounds()),
+ * instead of building a new tree.  Other tree types are rebuilt.
+ *
+ * The number of base cases and node scores of each iteration, and the number
+ * of points whose assignment was settled without any base cases, are recorded
+ * and printed with Log::Info, so it can be seen how well each iteration prunes.
  */
 template<
     typename MetricType,
@@ -73,6 +82,16 @@ class DualTreeKMeans
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Get the number of base cases of the traversal in each iteration.
+  const std::vector<size_t>& IterationBaseCases() const { return baseCases; }
+  //! Get the number of node combinations scored by the traversal in each
+  //! iteration.
+  const std::vector<size_t>& IterationScores() const { return scores; }
+  //! Get the number of points in each iteration that were pruned: that is,
+  //! whose assignment was settled without evaluating any base cases.
+  const std::vector<size_t>& IterationPrunedPoints() const
+  { return prunedPointCounts; }
+
  private:
   //! The original dataset reference.
   const MatType& datasetOrig; // Maybe not necessary.
@@ -88,6 +107,20 @@ class DualTreeKMeans
   //! Track iteration number.
   size_t iteration;
 
+  //! The tree built on the centroids; it is kept between iterations if it can
+  //! be refit.
+  Tree* centroidTree;
+  //! Mappings from the indices of the centroids in the centroid tree to their
+  //! original indices.
+  std::vector<size_t> oldFromNewCentroids;
+
+  //! The number of base cases in each iteration.
+  std::vector<size_t> baseCases;
+  //! The number of scores in each iteration.
+  std::vector<size_t> scores;
+  //! The number of pruned points in each iteration.
+  std::vector<size_t> prunedPointCounts;
+
   //! Upper bounds on nearest centroid.
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
@@ -153,6 +186,25 @@ void RestoreChildren(TreeType& node,
                      const typename boost::enable_if_c<tree::TreeTraits<
                          TreeType>::BinaryTree>::type* junk = 0);
 
+//! Copy the new centroids into the centroid tree and refit its bounds.  This is
+//! called if the tree is a binary tree (i.e. a BinarySpaceTree).
+template<typename TreeType>
+void RefitCentroidTree(TreeType& tree,
+                       const arma::mat& centroids,
+                       const std::vector<size_t>& oldFromNew,
+                       const typename boost::enable_if_c<
+                           tree::TreeTraits<TreeType>::BinaryTree>::type*
+                               junk = 0);
+
+//! Other tree types can't be refit, so this is never called.
+template<typename TreeType>
+void RefitCentroidTree(TreeType& tree,
+                       const arma::mat& centroids,
+                       const std::vector<size_t>& oldFromNew,
+                       const typename boost::disable_if_c<
+                           tree::TreeTraits<TreeType>::BinaryTree>::type*
+                               junk = 0);
+
 //! A template typedef for the DualTreeKMeans algorithm with the default tree
 //! type (a kd-tree).
 template<typename MetricType, typename MatType>
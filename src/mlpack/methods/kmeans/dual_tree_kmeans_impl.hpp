@@ -58,6 +58,7 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     metric(metric),
     distanceCalculations(0),
     iteration(0),
+    centroidTree(NULL),
     upperBounds(dataset.n_cols),
     lowerBounds(dataset.n_cols),
     prunedPoints(dataset.n_cols, false), // Fill with false.
@@ -83,6 +84,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  if (centroidTree)
+    delete centroidTree;
 }
 
 // Run a single iteration.
@@ -97,9 +100,23 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::Col<size_t>& counts)
 {
   // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  // is unfortunate, but I don't see a reasonable way around it.  If the tree
+  // from the last iteration can be refit to the moved centroids, it is reused
+  // instead.
+  Timer::Start("centroid_tree");
+  if (centroidTree != NULL && tree::TreeTraits<Tree>::BinaryTree &&
+      centroidTree->Dataset().n_rows == centroids.n_rows &&
+      centroidTree->Dataset().n_cols == centroids.n_cols)
+  {
+    RefitCentroidTree(*centroidTree, centroids, oldFromNewCentroids);
+  }
+  else
+  {
+    delete centroidTree;
+    oldFromNewCentroids.clear();
+    centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  }
+  Timer::Stop("centroid_tree");
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -163,6 +180,20 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   traverser.Traverse(*tree, *centroidTree);
   distanceCalculations += rules.BaseCases() + rules.Scores();
 
+  // Every point that needed a base case was visited; the others were pruned.
+  size_t visitedPoints = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if (visited[i])
+      ++visitedPoints;
+
+  baseCases.push_back(rules.BaseCases());
+  scores.push_back(rules.Scores());
+  prunedPointCounts.push_back(dataset.n_cols - visitedPoints);
+  Log::Info << "DualTreeKMeans::Iterate(): iteration " << iteration << ": "
+      << prunedPointCounts.back() << " of " << dataset.n_cols << " points "
+      << "pruned, " << rules.BaseCases() << " base cases, " << rules.Scores()
+      << " scores." << std::endl;
+
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
   Timer::Stop("tree_mod");
@@ -195,7 +226,13 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
+  // Only binary trees can be refit next iteration.  Other trees may refer to
+  // the centroids matrix, which can't be relied on after we return.
+  if (!tree::TreeTraits<Tree>::BinaryTree)
+  {
+    delete centroidTree;
+    centroidTree = NULL;
+  }
 
   ++iteration;
 
@@ -623,6 +660,33 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
     DecoalesceTree(node.Child(i));
 }
 
+//! Copy the new centroids into the centroid tree and refit its bounds.
+template<typename TreeType>
+void RefitCentroidTree(TreeType& tree,
+                       const arma::mat& centroids,
+                       const std::vector<size_t>& oldFromNew,
+                       const typename boost::enable_if_c<
+                           tree::TreeTraits<TreeType>::BinaryTree>::type*)
+{
+  // The tree holds the centroids in its own order.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    tree.Dataset().col(i) = centroids.col(oldFromNew[i]);
+
+  tree.RefitBounds();
+}
+
+//! Other tree types are rebuilt instead.
+template<typename TreeType>
+void RefitCentroidTree(TreeType& /* tree */,
+                       const arma::mat& /* centroids */,
+                       const std::vector<size_t>& /* oldFromNew */,
+                       const typename boost::disable_if_c<
+                           tree::TreeTraits<TreeType>::BinaryTree>::type*)
+{
+  throw std::logic_error("RefitCentroidTree(): only binary trees can be "
+      "refit");
+}
+
 //! Utility function for hiding children in a non-binary tree.
 template<typename TreeType>
 void HideChild(TreeType& node,
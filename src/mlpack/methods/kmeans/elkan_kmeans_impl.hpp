@@ -41,9 +41,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -74,19 +71,32 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // bounds and assignment of each point are only touched while that point is
+  // being handled, so the points can be split across threads; each thread
+  // accumulates the points it is given into its own sums and counts, which are
+  // added together at the end.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:pointDistanceCalculations)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> threadCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic, 256)
+    for (intmax_t i = 0; i < (intmax_t) dataset.n_cols; ++i)
     {
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        threadCounts(assignments[i])++;
+        threadCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+
+      // Initially set r(x) to true.
+      bool mustRecalculate = true;
       for (size_t c = 0; c < centroids.n_cols; ++c)
       {
         // Step 3: for all remaining points x and centers c such that c != c(x),
@@ -103,13 +113,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
+          mustRecalculate = false;
           dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -131,7 +141,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -139,14 +149,21 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      threadCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      threadCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    #pragma omp critical
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+    }
   }
+  distanceCalculations += pointDistanceCalculations;
 
   // Now, normalize and calculate the distance each cluster has moved.
   arma::vec moveDistances(centroids.n_cols);
@@ -161,7 +178,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
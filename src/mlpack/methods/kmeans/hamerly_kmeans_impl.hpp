@@ -62,64 +62,85 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // The bounds and assignment of each point are only touched while that point
+  // is being handled, so the points can be split across threads.  Each thread
+  // accumulates the points it is given into its own sums and counts, which are
+  // added together at the end.
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:hamerlyPruned, pointDistanceCalculations)
   {
-    const double m = std::max(minClusterDistances(assignments[i]),
-                              lowerBounds(i));
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> threadCounts(centroids.n_cols, arma::fill::zeros);
 
-    // First bound test.
-    if (upperBounds(i) <= m)
+    #pragma omp for schedule(dynamic, 256)
+    for (intmax_t i = 0; i < (intmax_t) dataset.n_cols; ++i)
     {
-      ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+      const double m = std::max(minClusterDistances(assignments[i]),
+                                lowerBounds(i));
 
-    // Second bound test.
-    if (upperBounds(i) <= m)
-    {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // The bounds failed.  So test against all other clusters.
-    // This is Hamerly's Point-All-Ctrs() function from the paper.
-    // We have to reset the lower bound first.
-    lowerBounds(i) = DBL_MAX;
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-    {
-      if (c == assignments[i])
+      // First bound test.
+      if (upperBounds(i) <= m)
+      {
+        ++hamerlyPruned;
+        threadCentroids.col(assignments[i]) += dataset.col(i);
+        ++threadCounts(assignments[i]);
         continue;
+      }
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      // Tighten upper bound.
+      upperBounds(i) = metric.Evaluate(dataset.col(i),
+                                       centroids.col(assignments[i]));
+      ++pointDistanceCalculations;
 
-      // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
-      if (dist < upperBounds(i))
+      // Second bound test.
+      if (upperBounds(i) <= m)
       {
-        // lowerBounds holds the second closest cluster.
-        lowerBounds(i) = upperBounds(i);
-        upperBounds(i) = dist;
-        assignments[i] = c;
+        threadCentroids.col(assignments[i]) += dataset.col(i);
+        ++threadCounts(assignments[i]);
+        continue;
       }
-      else if (dist < lowerBounds(i))
+
+      // The bounds failed.  So test against all other clusters.
+      // This is Hamerly's Point-All-Ctrs() function from the paper.
+      // We have to reset the lower bound first.
+      lowerBounds(i) = DBL_MAX;
+      for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // This is a closer second-closest cluster.
-        lowerBounds(i) = dist;
+        if (c == assignments[i])
+          continue;
+
+        const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+
+        // Is this a better cluster?  At this point, upperBounds[i] =
+        // d(i, c(i)).
+        if (dist < upperBounds(i))
+        {
+          // lowerBounds holds the second closest cluster.
+          lowerBounds(i) = upperBounds(i);
+          upperBounds(i) = dist;
+          assignments[i] = c;
+        }
+        else if (dist < lowerBounds(i))
+        {
+          // This is a closer second-closest cluster.
+          lowerBounds(i) = dist;
+        }
       }
+      pointDistanceCalculations += centroids.n_cols - 1;
+
+      // Update new centroids.
+      threadCentroids.col(assignments[i]) += dataset.col(i);
+      ++threadCounts(assignments[i]);
     }
-    distanceCalculations += centroids.n_cols - 1;
 
-    // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    #pragma omp critical
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+    }
   }
+  distanceCalculations += pointDistanceCalculations;
 
   // Normalize centroids and calculate cluster movement (contains parts of
   // Move-Centers() and Update-Bounds()).
@@ -153,7 +174,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
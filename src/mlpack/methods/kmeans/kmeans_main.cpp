@@ -10,10 +10,13 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus.hpp"
+#include "scalable_kmeans_plus_plus.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -35,13 +38,32 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "to be used in each sample, the --percentage parameter is used (it should "
     "be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the initial centroids can be chosen with k-means++ (Arthur "
+    "and Vassilvitskii, 2007) by specifying --kmeans_plus_plus (-K), or with "
+    "its scalable variant k-means|| (Bahmani et al., 2012) by specifying "
+    "--kmeans_parallel (-L).  k-means++ takes one pass over the dataset per "
+    "cluster, whereas k-means|| takes --rounds (-R) passes, sampling about "
+    "--oversampling (-O) times the number of clusters in each, so k-means|| is "
+    "preferable when many clusters are requested."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the --algorithm (-a) option.  The standard O(kN)"
     " approach can be used ('naive').  Other options include the Pelleg-Moore "
     "tree-based algorithm ('pelleg-moore'), Elkan's triangle-inequality based "
     "algorithm ('elkan'), Hamerly's modification to Elkan's algorithm "
-    "('hamerly'), the dual-tree k-means algorithm ('dualtree'), and the "
-    "dual-tree k-means algorithm using the cover tree ('dualtree-covertree')."
+    "('hamerly'), the dual-tree k-means algorithm ('dualtree'), the "
+    "dual-tree k-means algorithm using the cover tree ('dualtree-covertree'), "
+    "and mini-batch k-means ('minibatch')."
+    "\n\n"
+    "Mini-batch k-means (Sculley, \"Web-scale k-means clustering\", 2010) does "
+    "not take full Lloyd iterations; instead, each iteration samples "
+    "--batch_size (-b) points and moves each centroid towards the sampled "
+    "points closest to it, so that each centroid is the mean of every point it "
+    "has been given.  This is much faster than the other algorithms for very "
+    "large datasets, but the result is approximate.  Its residual is noisy, so "
+    "the number of iterations should be controlled with --max_iterations (-m)."
+    "  Labels are still computed with a full pass over the dataset, so if only "
+    "centroids are needed, only --centroid_file (-C) should be given."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the --allow_empty_clusters (-e) option.  When this option is specified "
@@ -91,9 +113,33 @@ PARAM_INT("samplings", "Number of samplings to perform for refined start (use "
 PARAM_DOUBLE("percentage", "Percentage of dataset to use for each refined start"
     " sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means++ and k-means||.
+PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ strategy to choose initial "
+    "points.", "K");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| (scalable k-means++) strategy "
+    "to choose initial points.", "L");
+PARAM_DOUBLE("oversampling", "Expected number of points sampled in each round "
+    "of k-means||, as a multiple of the number of clusters (use when "
+    "--kmeans_parallel is specified).", "O", 2.0);
+PARAM_INT("rounds", "Number of sampling rounds of k-means|| (use when "
+    "--kmeans_parallel is specified).", "R", 5);
+
 PARAM_STRING("algorithm", "Algorithm to use for the Lloyd iteration ('naive', "
-    "'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or 'dualtree-covertree').",
-    "a", "naive");
+    "'pelleg-moore', 'elkan', 'hamerly', 'dualtree', 'dualtree-covertree', or "
+    "'minibatch').", "a", "naive");
+PARAM_INT("batch_size", "Number of points sampled in each iteration of "
+    "mini-batch k-means (use when --algorithm is 'minibatch').", "b", 1000);
+
+// Mini-batch k-means with the batch size given on the command line, so that it
+// can be passed to KMeans as a Lloyd step type.
+template<typename MetricType, typename MatType>
+class CLIMiniBatchKMeans : public MiniBatchKMeans<MetricType, MatType>
+{
+ public:
+  CLIMiniBatchKMeans(const MatType& dataset, MetricType& metric) :
+      MiniBatchKMeans<MetricType, MatType>(dataset, metric,
+          (size_t) CLI::GetParam<int>("batch_size")) { }
+};
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -124,6 +170,11 @@ int main(int argc, char** argv)
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  if (CLI::HasParam("refined_start") + CLI::HasParam("kmeans_plus_plus") +
+      CLI::HasParam("kmeans_parallel") > 1)
+    Log::Fatal << "Only one of --refined_start (-r), --kmeans_plus_plus (-K), "
+        << "or --kmeans_parallel (-L) may be specified!" << endl;
+
   if (CLI::HasParam("refined_start"))
   {
     const int samplings = CLI::GetParam<int>("samplings");
@@ -138,6 +189,25 @@ int main(int argc, char** argv)
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_plus_plus"))
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlus>(KMeansPlusPlus());
+  }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    const double oversampling = CLI::GetParam<double>("oversampling");
+    const int rounds = CLI::GetParam<int>("rounds");
+
+    if (oversampling <= 0.0)
+      Log::Fatal << "Oversampling factor (" << oversampling << ") must be "
+          << "greater than 0.0!" << endl;
+    if (rounds < 0)
+      Log::Fatal << "Number of rounds (" << rounds << ") must be greater than "
+          << "or equal to 0!" << endl;
+
+    FindEmptyClusterPolicy<ScalableKMeansPlusPlus>(
+        ScalableKMeansPlusPlus(oversampling, (size_t) rounds));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -182,10 +252,13 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        CLIMiniBatchKMeans>(ipp);
   else
     Log::Fatal << "Unknown algorithm: '" << algorithm << "'.  Supported options"
-        << " are 'naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', and "
-        << "'dualtree-covertree'." << endl;
+        << " are 'naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+        << "'dualtree-covertree', and 'minibatch'." << endl;
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -220,6 +293,18 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
         ")! Must be greater than or equal to 0." << endl;
   }
 
+  if (CLI::GetParam<int>("batch_size") <= 0)
+  {
+    Log::Fatal << "Invalid batch size (" << CLI::GetParam<int>("batch_size")
+        << ")! Must be greater than 0." << endl;
+  }
+  else if (CLI::HasParam("batch_size") &&
+      CLI::GetParam<string>("algorithm") != "minibatch")
+  {
+    Log::Warn << "--batch_size (-b) is ignored unless --algorithm is "
+        << "'minibatch'." << endl;
+  }
+
   // Make sure we have an output file if we're not doing the work in-place.
   if (!CLI::HasParam("in_place") && !CLI::HasParam("output_file") &&
       !CLI::HasParam("centroid_file"))
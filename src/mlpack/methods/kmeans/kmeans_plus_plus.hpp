@@ -0,0 +1,109 @@
+/**
+ * @file kmeans_plus_plus.hpp
+ *
+ * The k-means++ strategy for choosing initial centroids, which samples each
+ * centroid with probability proportional to its squared distance from the
+ * centroids chosen so far.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ initial partition policy.  The first centroid is a random
+ * point, and each following centroid is a point sampled with probability
+ * proportional to its squared Euclidean distance from the closest centroid
+ * chosen so far.  This spreads the centroids out over the dataset, so that
+ * fewer Lloyd iterations are needed, and the expected cost of the initial
+ * clustering is within O(log k) of the optimal cost.  For more information, see
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{arthur2007kmeanspp,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, D. and Vassilvitskii, S.},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA '07)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * Choosing k centroids takes k passes over the dataset; the distances in each
+ * pass are computed in parallel (if OpenMP is available).  For large k, the
+ * ScalableKMeansPlusPlus policy needs far fewer passes.
+ */
+class KMeansPlusPlus
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlus() { }
+
+  /**
+   * Choose the initial centroids with the k-means++ strategy.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  static void Cluster(const MatType& data,
+                      const size_t clusters,
+                      arma::mat& centroids);
+
+  /**
+   * Choose the initial centroids with the k-means++ strategy, where each point
+   * has a weight (i.e., it stands for that many points).  Each point is sampled
+   * with probability proportional to its weight times its squared distance
+   * from the closest centroid chosen so far.
+   *
+   * @param data Dataset.
+   * @param weights Weight of each point.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  static void Cluster(const MatType& data,
+                      const arma::vec& weights,
+                      const size_t clusters,
+                      arma::mat& centroids);
+
+  /**
+   * Sample an index with probability proportional to the given (unnormalized)
+   * probabilities.  If they are all zero, an index is sampled uniformly.
+   *
+   * @param probabilities Unnormalized probability of each index.
+   * @return Sampled index.
+   */
+  static size_t Sample(const arma::vec& probabilities);
+
+  /**
+   * Lower the squared distance from each point to its closest centroid, given
+   * a new centroid.
+   *
+   * @param data Dataset.
+   * @param centroid New centroid.
+   * @param minDistances Squared distance from each point to its closest
+   *     centroid; this is updated.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const arma::vec& centroid,
+                              arma::vec& minDistances);
+
+  //! Serialize the object (there is nothing to save).
+  template<typename Archive>
+  void Serialize(Archive& /* ar */, const unsigned int /* version */) { }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_plus_plus_impl.hpp"
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file kmeans_plus_plus_impl.hpp
+ *
+ * Implementation of the k-means++ initial partition policy.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_plus_plus.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansPlusPlus::Cluster(const MatType& data,
+                             const size_t clusters,
+                             arma::mat& centroids)
+{
+  Cluster(data, arma::ones<arma::vec>(data.n_cols), clusters, centroids);
+}
+
+template<typename MatType>
+void KMeansPlusPlus::Cluster(const MatType& data,
+                             const arma::vec& weights,
+                             const size_t clusters,
+                             arma::mat& centroids)
+{
+  if (weights.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "KMeansPlusPlus::Cluster(): number of weights (" << weights.n_elem
+        << ") does not match number of points (" << data.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0 || data.n_cols == 0)
+    return;
+
+  // The first centroid is sampled by weight alone.
+  centroids.col(0) = data.col(Sample(weights));
+
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(std::numeric_limits<double>::infinity());
+  for (size_t c = 1; c < clusters; ++c)
+  {
+    UpdateDistances(data, centroids.col(c - 1), minDistances);
+
+    // Points that are already centroids have a distance of 0, so they can't be
+    // sampled again unless every point is a centroid.
+    centroids.col(c) = data.col(Sample(weights % minDistances));
+  }
+}
+
+inline size_t KMeansPlusPlus::Sample(const arma::vec& probabilities)
+{
+  const double total = arma::accu(probabilities);
+  if (!(total > 0.0) || std::isinf(total))
+  {
+    // RandInt() can't give indices past the range of an int, so scale a
+    // uniform random number instead.
+    return std::min((size_t) (math::Random() * probabilities.n_elem),
+                    (size_t) probabilities.n_elem - 1);
+  }
+
+  const double target = math::Random() * total;
+  double sum = 0.0;
+  size_t last = 0;
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+  {
+    if (probabilities[i] <= 0.0)
+      continue;
+
+    sum += probabilities[i];
+    last = i;
+    if (sum > target)
+      return i;
+  }
+
+  // Rounding may leave the sum just short of the target.
+  return last;
+}
+
+template<typename MatType>
+void KMeansPlusPlus::UpdateDistances(const MatType& data,
+                                     const arma::vec& centroid,
+                                     arma::vec& minDistances)
+{
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  {
+    const double distance = metric::SquaredEuclideanDistance::Evaluate(
+        data.col(i), centroid);
+    if (distance < minDistances[i])
+      minDistances[i] = distance;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means, which updates the centroids from a
+ * small random sample of the dataset in each iteration.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An approximate replacement for the Lloyd iteration, which, in each
+ * iteration, samples a fixed-size batch of points (with replacement), assigns
+ * each of them to its closest centroid, and then moves each centroid towards
+ * the points assigned to it with a per-centroid learning rate of 1 / v, where v
+ * is the number of points ever assigned to that centroid.  Each centroid is
+ * therefore the running mean of the points it has been given.  An iteration
+ * costs O(kb) for a batch size b, instead of O(kN), so this is useful for very
+ * large datasets, where even one full pass is expensive; only the sampled
+ * points are ever touched.  For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * The counts given by Iterate() are the number of points ever assigned to each
+ * centroid, so a cluster is only considered empty if no sampled point has been
+ * assigned to it yet.  The residual is the distance the centroids moved in the
+ * iteration, which shrinks as the learning rates decay; because it is noisy,
+ * the number of iterations is usually better controlled by the maximum number
+ * of iterations given to KMeans.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points to sample in each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single iteration of mini-batch k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points ever assigned to each cluster.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of points sampled in each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled in each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points sampled in each iteration.
+  size_t batchSize;
+
+  //! The number of points ever assigned to each cluster.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{
+  if (batchSize == 0)
+    throw std::invalid_argument("MiniBatchKMeans: batch size must be greater "
+        "than 0");
+}
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // If this is the first iteration, no points have been assigned yet.  Later
+  // on, the counts (and so the learning rates) of the surviving clusters are
+  // kept; only a cluster that was killed (its centroid is filled with DBL_MAX
+  // by KillEmptyClusters) loses its count.
+  if (clusterCounts.is_empty())
+    clusterCounts.zeros(centroids.n_cols);
+  else if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.resize(centroids.n_cols);
+
+  if (centroids.n_rows > 0)
+  {
+    for (size_t i = 0; i < centroids.n_cols; ++i)
+      if (centroids(0, i) == DBL_MAX)
+        clusterCounts[i] = 0;
+  }
+
+  // Sample the batch.  RandInt() can't give indices past the range of an int,
+  // so scale a uniform random number instead.
+  arma::Col<size_t> batch(batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    batch[i] = std::min((size_t) (math::Random() * dataset.n_cols),
+                        (size_t) dataset.n_cols - 1);
+
+  // Assign each point in the batch to the closest of the current centroids.
+  // This is where nearly all of the work is, so the batch is split across
+  // threads.
+  arma::Col<size_t> batchAssignments(batchSize);
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) batchSize; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(dataset.col(batch[i]),
+                                              centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    batchAssignments[i] = closestCluster;
+  }
+  distanceCalculations += centroids.n_cols * batchSize;
+
+  // Now take a gradient step for each point, with a learning rate of 1 / v for
+  // a centroid that has been given v points, so that each centroid is the mean
+  // of all the points it has been given.
+  newCentroids = centroids;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t cluster = batchAssignments[i];
+    Log::Assert(cluster != centroids.n_cols);
+
+    ++clusterCounts[cluster];
+    const double eta = 1.0 / clusterCounts[cluster];
+    newCentroids.col(cluster) = (1.0 - eta) * newCentroids.col(cluster) +
+        eta * arma::vec(dataset.col(batch[i]));
+  }
+
+  counts = clusterCounts;
+
+  // Calculate the distance the centroids have moved in this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -9,6 +9,8 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 
+#include <mlpack/core/metrics/euclidean_block.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -18,6 +20,15 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * The points are split across threads (if OpenMP is available); each thread
+ * sums the points it assigns into its own centroids and counts, and these are
+ * added together at the end of the iteration.  For the Euclidean distance on
+ * dense data, the points are assigned in blocks, using one matrix
+ * multiplication per block to approximate the distances to every centroid (see
+ * metric::EuclideanBlock); only the centroids that might be the closest are
+ * then evaluated exactly, so the assignments are the same as if every distance
+ * had been evaluated.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -50,6 +61,45 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  //! True if AssignPoints() can approximate distances with EuclideanBlock.
+  static const bool UsesEuclideanBlock =
+      metric::IsEuclideanMetric<MetricType>::value &&
+      std::is_same<MatType, arma::mat>::value;
+
+  //! Below this dimensionality, exact evaluation of each distance is cheaper
+  //! than approximating the block first.
+  static const size_t minBlockDimensionality = 16;
+
+  //! The number of points assigned at once by each thread.
+  static const size_t blockSize = 256;
+
+  /**
+   * Assign the points in the given range to their closest centroids, adding
+   * each point to the sum of its centroid and incrementing its count.
+   *
+   * @param centroids Current cluster centroids.
+   * @param begin Index of the first point to assign.
+   * @param end Index one past the last point to assign.
+   * @param centroidSums Sums of the points assigned to each centroid.
+   * @param counts Number of points assigned to each centroid.
+   */
+  template<bool UseBlock = UsesEuclideanBlock>
+  void AssignPoints(const arma::mat& centroids,
+                    const size_t begin,
+                    const size_t end,
+                    arma::mat& centroidSums,
+                    arma::Col<size_t>& counts,
+                    const typename boost::enable_if_c<UseBlock>::type* = 0);
+
+  //! Assign the points in the given range by evaluating every distance.
+  template<bool UseBlock = UsesEuclideanBlock>
+  void AssignPoints(const arma::mat& centroids,
+                    const size_t begin,
+                    const size_t end,
+                    arma::mat& centroidSums,
+                    arma::Col<size_t>& counts,
+                    const typename boost::disable_if_c<UseBlock>::type* = 0);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
@@ -32,29 +32,29 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
-  // Find the closest centroid to each point and update the new centroids.
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  // Find the closest centroid to each point and update the new centroids.  Each
+  // thread accumulates the points it is given into its own sums and counts,
+  // which are added together at the end.
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
   {
-    // Find the closest centroid to this point.
-    double minDistance = std::numeric_limits<double>::infinity();
-    size_t closestCluster = centroids.n_cols; // Invalid value.
+    arma::mat threadCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> threadCounts(centroids.n_cols, arma::fill::zeros);
 
-    for (size_t j = 0; j < centroids.n_cols; j++)
+    #pragma omp for schedule(static)
+    for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
     {
-      const double distance = metric.Evaluate(dataset.col(i), centroids.col(j));
-
-      if (distance < minDistance)
-      {
-        minDistance = distance;
-        closestCluster = j;
-      }
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) dataset.n_cols);
+      AssignPoints(centroids, begin, end, threadCentroids, threadCounts);
     }
 
-    Log::Assert(closestCluster != centroids.n_cols);
-
-    // We now have the minimum distance centroid index.  Update that centroid.
-    newCentroids.col(closestCluster) += arma::vec(dataset.col(i));
-    counts(closestCluster)++;
+    #pragma omp critical
+    {
+      newCentroids += threadCentroids;
+      counts += threadCounts;
+    }
   }
 
   // Now normalize the centroid.
@@ -76,6 +76,116 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   return std::sqrt(cNorm);
 }
 
+template<typename MetricType, typename MatType>
+template<bool UseBlock>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    const size_t begin,
+    const size_t end,
+    arma::mat& centroidSums,
+    arma::Col<size_t>& counts,
+    const typename boost::enable_if_c<UseBlock>::type* /* junk */)
+{
+  if (dataset.n_rows < minBlockDimensionality)
+  {
+    AssignPoints<false>(centroids, begin, end, centroidSums, counts);
+    return;
+  }
+
+  const arma::mat points = dataset.cols(begin, end - 1);
+  arma::mat squaredDistances, errorBounds;
+  metric::EuclideanBlock::SquaredDistances(points, centroids, squaredDistances,
+      errorBounds);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    // The closest centroid can't be further away than the smallest upper bound
+    // on any of the distances.
+    double bestUpperBound = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double upperBound = squaredDistances(i, j) + errorBounds(i, j);
+      if (upperBound < bestUpperBound)
+      {
+        bestUpperBound = upperBound;
+        closestCluster = j;
+      }
+    }
+
+    // Any other centroid whose lower bound is below that might be the closest,
+    // so in that case every such centroid is evaluated exactly.
+    bool ambiguous = false;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      if (j != closestCluster &&
+          squaredDistances(i, j) - errorBounds(i, j) <= bestUpperBound)
+      {
+        ambiguous = true;
+        break;
+      }
+    }
+
+    if (ambiguous)
+    {
+      double minDistance = std::numeric_limits<double>::infinity();
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        if (squaredDistances(i, j) - errorBounds(i, j) > bestUpperBound)
+          continue;
+
+        const double distance = metric.Evaluate(points.col(i),
+            centroids.col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    centroidSums.col(closestCluster) += points.col(i);
+    counts(closestCluster)++;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<bool UseBlock>
+void NaiveKMeans<MetricType, MatType>::AssignPoints(
+    const arma::mat& centroids,
+    const size_t begin,
+    const size_t end,
+    arma::mat& centroidSums,
+    arma::Col<size_t>& counts,
+    const typename boost::disable_if_c<UseBlock>::type* /* junk */)
+{
+  for (size_t i = begin; i < end; i++)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(dataset.col(i), centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    // We now have the minimum distance centroid index.  Update that centroid.
+    centroidSums.col(closestCluster) += arma::vec(dataset.col(i));
+    counts(closestCluster)++;
+  }
+}
+
 } // namespace kmeans
 } // namespace mlpack
 
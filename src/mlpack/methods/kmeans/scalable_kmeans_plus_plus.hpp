@@ -0,0 +1,111 @@
+/**
+ * @file scalable_kmeans_plus_plus.hpp
+ *
+ * The k-means|| ("scalable k-means++") strategy for choosing initial
+ * centroids, which oversamples candidate centroids in a few passes over the
+ * dataset and then reduces them to k centroids with k-means++.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SCALABLE_KMEANS_PLUS_PLUS_HPP
+#define MLPACK_METHODS_KMEANS_SCALABLE_KMEANS_PLUS_PLUS_HPP
+
+#include <mlpack/core.hpp>
+#include "kmeans_plus_plus.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initial partition policy.  k-means++ needs one pass over the
+ * dataset for every centroid, which is slow for large k.  Instead, k-means||
+ * starts from one random point and, in each of a small number of rounds,
+ * samples every point independently with probability
+ *
+ * @f[
+ * \min\left(1, \frac{l D(x)^2}{\sum_y D(y)^2}\right),
+ * @f]
+ *
+ * where D(x) is the distance from x to the closest candidate so far and l is
+ * the oversampling factor times k.  Each round takes one pass over the dataset
+ * and adds about l candidates.  Each candidate is then weighted by the number
+ * of points closest to it, and the weighted candidates are reduced to k
+ * centroids with k-means++ (see KMeansPlusPlus).  For more information, see
+ * the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, B. and Moseley, B. and Vattani, A. and Kumar, R. and
+ *       Vassilvitskii, S.},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * The distances to the new candidates in each round are computed in parallel
+ * (if OpenMP is available).  If fewer than k distinct candidates are found
+ * (for instance, if the dataset has fewer than k distinct points), k-means++
+ * is run on the whole dataset instead.
+ */
+class ScalableKMeansPlusPlus
+{
+ public:
+  /**
+   * Create the ScalableKMeansPlusPlus object, optionally specifying the
+   * oversampling factor and the number of rounds.
+   *
+   * @param oversampling Expected number of candidates sampled in each round,
+   *     as a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds.
+   */
+  ScalableKMeansPlusPlus(const double oversampling = 2.0,
+                         const size_t rounds = 5) :
+      oversampling(oversampling), rounds(rounds) { }
+
+  /**
+   * Choose the initial centroids with the k-means|| strategy.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & data::CreateNVP(oversampling, "oversampling");
+    ar & data::CreateNVP(rounds, "rounds");
+  }
+
+ private:
+  //! The expected number of candidates sampled in each round, as a multiple of
+  //! the number of clusters.
+  double oversampling;
+  //! The number of sampling rounds.
+  size_t rounds;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "scalable_kmeans_plus_plus_impl.hpp"
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file scalable_kmeans_plus_plus_impl.hpp
+ *
+ * Implementation of the k-means|| initial partition policy.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SCALABLE_KMEANS_PLUS_PLUS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SCALABLE_KMEANS_PLUS_PLUS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "scalable_kmeans_plus_plus.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void ScalableKMeansPlusPlus::Cluster(const MatType& data,
+                                     const size_t clusters,
+                                     arma::mat& centroids)
+{
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0 || data.n_cols == 0)
+    return;
+
+  // The first candidate is a random point.
+  std::vector<size_t> candidates;
+  candidates.push_back(KMeansPlusPlus::Sample(
+      arma::ones<arma::vec>(data.n_cols)));
+
+  // The squared distance from each point to its closest candidate, and the
+  // index of that candidate.
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(std::numeric_limits<double>::infinity());
+  arma::Col<size_t> closestCandidates(data.n_cols);
+
+  const double expectedSamples = oversampling * clusters;
+  size_t round = 0;
+  size_t updated = 0; // The candidates before this one are in minDistances.
+  while (true)
+  {
+    // Find the distances to the candidates added in the last round.  This is
+    // where nearly all of the work is.
+    const size_t newCandidates = candidates.size();
+    #pragma omp parallel for schedule(static)
+    for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+    {
+      for (size_t c = updated; c < newCandidates; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(i), data.col(candidates[c]));
+        if (distance < minDistances[i])
+        {
+          minDistances[i] = distance;
+          closestCandidates[i] = c;
+        }
+      }
+    }
+    updated = newCandidates;
+
+    if (round++ == rounds)
+      break;
+
+    // Every point has already been chosen if the cost is 0.
+    const double cost = arma::accu(minDistances);
+    if (!(cost > 0.0))
+      break;
+
+    // Sample each point independently.  A chosen point has a distance of 0
+    // after the next pass, so it can't be chosen again in a later round; but
+    // identical points can be chosen in the same round.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      if (math::Random() < expectedSamples * minDistances[i] / cost)
+        candidates.push_back(i);
+  }
+
+  // Weight each candidate by the number of points closest to it.  Each point
+  // is closest to the first of several identical candidates, so only that one
+  // gets a weight; every other candidate is at least closest to itself.
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[closestCandidates[i]] += 1.0;
+
+  const arma::uvec distinct = arma::find(weights > 0.0);
+
+  Log::Info << "ScalableKMeansPlusPlus::Cluster(): " << candidates.size()
+      << " candidates sampled, " << distinct.n_elem << " distinct."
+      << std::endl;
+
+  if (distinct.n_elem < clusters)
+  {
+    Log::Info << "ScalableKMeansPlusPlus::Cluster(): too few candidates; "
+        << "using k-means++ on the whole dataset." << std::endl;
+    KMeansPlusPlus::Cluster(data, clusters, centroids);
+    return;
+  }
+
+  arma::mat candidatePoints(data.n_rows, distinct.n_elem);
+  for (size_t c = 0; c < distinct.n_elem; ++c)
+    candidatePoints.col(c) = data.col(candidates[distinct[c]]);
+  const arma::vec candidateWeights = weights.elem(distinct);
+
+  // Reduce the weighted candidates to the centroids.
+  KMeansPlusPlus::Cluster(candidatePoints, candidateWeights, clusters,
+      centroids);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
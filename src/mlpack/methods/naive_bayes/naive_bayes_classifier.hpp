@@ -115,10 +115,14 @@ class NaiveBayesClassifier
    * nbc.Classify(test_data, &results);
    * @endcode
    *
+   * The points are classified in blocks, with the log-likelihoods of each
+   * block computed as dense matrix operations; the blocks are split across
+   * threads if OpenMP is available.
+   *
    * @param data List of data points.
    * @param results Vector that class predictions will be placed into.
    */
-  void Classify(const MatType& data, arma::Row<size_t>& results);
+  void Classify(const MatType& data, arma::Row<size_t>& results) const;
 
   //! Get the sample means for each class.
   const MatType& Means() const { return means; }
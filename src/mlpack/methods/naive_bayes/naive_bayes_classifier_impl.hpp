@@ -68,8 +68,15 @@ void NaiveBayesClassifier<MatType>::Train(const MatType& data,
   if (incremental)
   {
     // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
+    // Fist, de-normalize probabilities, and turn the variances back into sums
+    // of squared differences, so that training can continue from where the
+    // last call left off.
     probabilities *= trainingPoints;
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    {
+      if (probabilities[i] > 2)
+        variances.col(i) *= (probabilities[i] - 1);
+    }
 
     for (size_t j = 0; j < data.n_cols; ++j)
     {
@@ -131,8 +138,11 @@ void NaiveBayesClassifier<MatType>::Train(const MatType& data,
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  if (incremental)
+    trainingPoints += data.n_cols;
+  else
+    trainingPoints = data.n_cols;
+  probabilities /= trainingPoints;
 }
 
 template<typename MatType>
@@ -158,54 +168,59 @@ void NaiveBayesClassifier<MatType>::Train(const VecType& point,
 
 template<typename MatType>
 void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
-                                             arma::Row<size_t>& results)
+                                             arma::Row<size_t>& results) const
 {
   // Check that the number of features in the test data is same as in the
   // training data.
   Log::Assert(data.n_rows == means.n_rows);
 
-  arma::vec probs = arma::log(probabilities);
-  arma::mat invVar = 1.0 / variances;
-
-  arma::mat testProbs = arma::repmat(probs.t(), data.n_cols, 1);
-
   results.set_size(data.n_cols); // No need to fill with anything yet.
 
   Log::Info << "Running Naive Bayes classifier on " << data.n_cols
       << " data points with " << data.n_rows << " features each." << std::endl;
 
-  // Calculate the joint probability for each of the data points for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // The log-likelihood of a point under class i is an adaptation of gmm::phi()
+  // for a diagonal covariance:
+  //   log P(y_i) - 0.5 (d log(2 pi) + sum_k log var_ki)
+  //       - 0.5 sum_k (x_k - mu_ki)^2 / var_ki.
+  // Everything but the last term is the same for every point, so it is found
+  // once for each class.  The sum of the logs of the variances is used instead
+  // of the log of the determinant, which would underflow in high dimensions.
+  const arma::mat invVar = 1.0 / variances;
+  const arma::vec logNormalizers = arma::log(probabilities) - 0.5 *
+      (data.n_rows * log(2 * M_PI) + arma::trans(arma::sum(arma::log(
+      variances), 0)));
+
+  // Each block of points is independent, so the blocks can be split across
+  // threads.  Within a block, the last term for each class is one
+  // matrix-vector product.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    arma::mat diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    arma::mat rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::vec exponents(diffs.n_cols);
-    for (size_t j = 0; j < diffs.n_cols; ++j) // log(exp(value)) == value
-      exponents(j) = arma::accu(diffs.col(j) % rhs.unsafe_col(j));
-
-    // Calculate probability as sum of logarithm to decrease floating point
-    // errors.
-    testProbs.col(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
-  }
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
 
-  // Now calculate the label.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Find the index of the class with maximum probability for this point.
-    arma::uword maxIndex = 0;
-    arma::vec pointProbs = testProbs.row(i).t();
-    pointProbs.max(maxIndex);
+    // Element (i, j) is the log-likelihood of point j under class i.
+    arma::mat testProbs(means.n_cols, end - begin + 1);
+    arma::mat diffs;
+    for (size_t i = 0; i < means.n_cols; i++)
+    {
+      diffs = data.cols(begin, end);
+      diffs.each_col() -= means.col(i);
+      testProbs.row(i) = logNormalizers[i] - 0.5 *
+          arma::trans(invVar.col(i)) * arma::square(diffs);
+    }
 
-    results[i] = maxIndex;
+    // Find the index of the class with maximum probability for each point.
+    arma::uword maxIndex = 0;
+    for (size_t j = 0; j < testProbs.n_cols; ++j)
+    {
+      testProbs.unsafe_col(j).max(maxIndex);
+      results[begin + j] = maxIndex;
+    }
   }
-
-  return;
 }
 
 template<typename MatType>
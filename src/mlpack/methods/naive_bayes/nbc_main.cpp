@@ -8,6 +8,7 @@
  * features are sampled from a Gaussian distribution.
  */
 #include <mlpack/core.hpp>
+#include <memory>
 
 #include "naive_bayes_classifier.hpp"
 
@@ -29,7 +30,14 @@ PROGRAM_INFO("Parametric Naive Bayes Classifier",
     "specified with the --test_file (-T) option, and the classifications will "
     "be saved to the file specified with the --output_file (-o) option.  If "
     "saving a trained model is desired, the --output_model_file (-M) option "
-    "should be given.");
+    "should be given."
+    "\n\n"
+    "Training sets too large to fit in memory can be streamed by specifying "
+    "--chunk_size (-C): then the training set (and labels) are read and trained"
+    " on that many points at a time, with the incremental algorithm, and the "
+    "training set may be '-' to read it from standard input.  Streamed data "
+    "must be numeric text or mappable binary (.mbin) data, and a labels file "
+    "must hold one label per line.");
 
 // Model loading/saving.
 PARAM_STRING("input_model_file", "File containing input Naive Bayes model.",
@@ -43,6 +51,8 @@ PARAM_STRING("labels_file", "A file containing labels for the training set.",
     "l", "");
 PARAM_FLAG("incremental_variance", "The variance of each class will be "
     "calculated incrementally.", "I");
+PARAM_INT("chunk_size", "If nonzero, stream the training set from disk (or "
+    "standard input) this many points at a time.", "C", 0);
 
 // Test parameters.
 PARAM_STRING("test_file", "A file containing the test set.", "T", "");
@@ -71,6 +81,9 @@ struct NBCModel
   }
 };
 
+// Train the model on the training set a chunk at a time.
+void StreamingTrain(NBCModel& model);
+
 int main(int argc, char* argv[])
 {
   CLI::ParseCommandLine(argc, argv);
@@ -91,6 +104,13 @@ int main(int argc, char* argv[])
     Log::Warn << "--incremental_variance (-I) ignored because --training_file "
         << "(-t) is not specified." << endl;
 
+  if (CLI::GetParam<int>("chunk_size") < 0)
+    Log::Fatal << "Invalid chunk size (" << CLI::GetParam<int>("chunk_size")
+        << "); must be nonnegative." << endl;
+  if (!CLI::HasParam("training_file") && CLI::HasParam("chunk_size"))
+    Log::Warn << "--chunk_size (-C) ignored because --training_file (-t) is "
+        << "not specified." << endl;
+
   if (!CLI::HasParam("output_file") && !CLI::HasParam("output_model_file"))
     Log::Warn << "Neither --output_file (-o) nor --output_model_file (-M) "
         << "specified; no output will be saved!" << endl;
@@ -105,7 +125,11 @@ int main(int argc, char* argv[])
 
   // Either we have to train a model, or load a model.
   NBCModel model;
-  if (CLI::HasParam("training_file"))
+  if (CLI::HasParam("training_file") && CLI::GetParam<int>("chunk_size") > 0)
+  {
+    StreamingTrain(model);
+  }
+  else if (CLI::HasParam("training_file"))
   {
     const string trainingFile = CLI::GetParam<string>("training_file");
     mat trainingData;
@@ -185,3 +209,90 @@ int main(int argc, char* argv[])
     data::Save(CLI::GetParam<string>("output_model_file"), "nbc_model", model,
         false);
 }
+
+void StreamingTrain(NBCModel& model)
+{
+  const string trainingFile = CLI::GetParam<string>("training_file");
+  const string labelsFile = CLI::GetParam<string>("labels_file");
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+
+  if (trainingFile == "-" && labelsFile == "-")
+    Log::Fatal << "The training set and labels can't both be read from "
+        << "standard input." << endl;
+  if (labelsFile.empty())
+    Log::Info << "Using last dimension of training data as training labels."
+        << endl;
+
+  size_t points = 0;
+  Timer::Start("nbc_training");
+  try
+  {
+    data::StreamingLoader trainingStream(trainingFile, chunkSize);
+    unique_ptr<data::StreamingLoader> labelsStream;
+    if (!labelsFile.empty())
+      labelsStream.reset(new data::StreamingLoader(labelsFile, chunkSize));
+
+    mat chunk;
+    mat labelsChunk;
+    rowvec rawLabels;
+    while (trainingStream.Next(chunk) > 0)
+    {
+      if (labelsStream)
+      {
+        if (labelsStream->Next(labelsChunk) != chunk.n_cols ||
+            labelsChunk.n_rows != 1)
+          throw runtime_error("the labels file must hold one label for each "
+              "point of the training set");
+        rawLabels = labelsChunk.row(0);
+      }
+      else
+      {
+        rawLabels = chunk.row(chunk.n_rows - 1);
+        chunk.shed_row(chunk.n_rows - 1);
+      }
+
+      // Start with no classes; they are added as their labels appear.
+      if (trainingStream.PointsRead() == chunk.n_cols)
+        model.nbc = NaiveBayesClassifier<>(chunk.n_rows, 0);
+
+      // Map the labels, in the same way as data::NormalizeLabels(), adding a
+      // class to the model whenever a new label appears.
+      Row<size_t> labels(rawLabels.n_elem);
+      for (size_t i = 0; i < rawLabels.n_elem; ++i)
+      {
+        const size_t rawLabel = (size_t) rawLabels[i];
+        size_t label = 0;
+        while (label < model.mappings.n_elem &&
+               model.mappings[label] != rawLabel)
+          ++label;
+
+        if (label == model.mappings.n_elem)
+        {
+          model.mappings.resize(label + 1);
+          model.mappings[label] = rawLabel;
+
+          // New elements are zero, as for a class with no points.
+          model.nbc.Means().resize(chunk.n_rows, label + 1);
+          model.nbc.Variances().resize(chunk.n_rows, label + 1);
+          model.nbc.Probabilities().resize(label + 1);
+        }
+
+        labels[i] = label;
+      }
+
+      model.nbc.Train(chunk, labels, true);
+    }
+
+    points = trainingStream.PointsRead();
+  }
+  catch (runtime_error& e)
+  {
+    Log::Fatal << "Streaming the training set failed: " << e.what() << "."
+        << endl;
+  }
+  Timer::Stop("nbc_training");
+
+  if (points == 0)
+    Log::Fatal << "The training set '" << trainingFile << "' is empty!" << endl;
+  Log::Info << "Trained on " << points << " points." << endl;
+}
@@ -78,6 +78,8 @@ PARAM_DOUBLE("percentage", "If specified, will do approximate furthest neighbor"
     " search. Must be in the range (0,1] (decimal form). Resultant neighbors "
     "will be at least (p*100) % of the distance as the true furthest neighbor.",
     "p", 1);
+PARAM_INT("threads", "Number of threads to use for tree-based search (0 uses "
+    "all available cores).  Requires OpenMP.", "T", 1);
 
 // Convenience typedef.
 typedef NSModel<FurthestNeighborSort> KFNModel;
@@ -162,6 +164,20 @@ int main(int argc, char *argv[])
   if (CLI::HasParam("percentage"))
     epsilon = 1 - percentage;
 
+  // Sanity check on the number of threads.
+  const int threads = CLI::GetParam<int>("threads");
+  if (threads < 0)
+    Log::Fatal << "Invalid number of threads: " << threads << ".  Must be "
+        << "non-negative." << endl;
+#ifdef _OPENMP
+  if (threads > 0)
+    omp_set_num_threads(threads);
+#else
+  if (threads != 1)
+    Log::Warn << "--threads (-T) ignored because mlpack was compiled without "
+        << "OpenMP support." << endl;
+#endif
+
   // We either have to load the reference data, or we have to load the model.
   NSModel<FurthestNeighborSort> kfn;
   const bool naive = CLI::HasParam("naive");
@@ -247,6 +263,9 @@ int main(int argc, char *argv[])
     if (singleMode && naive)
       Log::Warn << "--single_mode ignored because --naive is present." << endl;
 
+    // Split tree-based search across threads, if requested.
+    kfn.Parallel() = (threads != 1);
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
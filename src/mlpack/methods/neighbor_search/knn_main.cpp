@@ -76,10 +76,93 @@ PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
 PARAM_DOUBLE("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_INT("threads", "Number of threads to use for tree-based search (0 uses "
+    "all available cores).  Requires OpenMP.", "T", 1);
+PARAM_FLAG("float", "If set, the data is loaded and searched in single "
+    "precision, halving memory usage.  Only 'kd' and 'ball' trees are "
+    "supported, and models cannot be loaded or saved.", "f");
 
 // Convenience typedef.
 typedef NSModel<NearestNeighborSort> KNNModel;
 
+/**
+ * Perform single-precision search with the given tree type, so that the data
+ * is never converted to double.  The results are given in the original order
+ * of the reference and query points.
+ *
+ * @param referenceSet Reference data (taken).
+ * @param querySet Query data (taken); ignored if hasQuerySet is false.
+ * @param hasQuerySet If false, the reference set is used as the query set.
+ * @param k Number of nearest neighbors to find.
+ * @param leafSize Leaf size for tree building.
+ * @param naive If true, naive search is used.
+ * @param singleMode If true, single-tree search is used.
+ * @param epsilon Relative approximate error.
+ * @param parallel If true, search is split across threads.
+ * @param neighbors Matrix to store the resulting neighbors in.
+ * @param distances Matrix to store the resulting distances in.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FloatSearch(arma::fmat&& referenceSet,
+                 arma::fmat&& querySet,
+                 const bool hasQuerySet,
+                 const size_t k,
+                 const size_t leafSize,
+                 const bool naive,
+                 const bool singleMode,
+                 const double epsilon,
+                 const bool parallel,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& distances)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      TreeType> KNNType;
+
+  if (naive)
+  {
+    KNNType knn(std::move(referenceSet), true);
+    if (hasQuerySet)
+      knn.Search(querySet, k, neighbors, distances);
+    else
+      knn.Search(k, neighbors, distances);
+    return;
+  }
+
+  // Build the trees here so that the leaf size is respected; that means the
+  // results must be unmapped here too.
+  std::vector<size_t> oldFromNewReferences;
+  typename KNNType::Tree referenceTree(std::move(referenceSet),
+      oldFromNewReferences, leafSize);
+  KNNType knn(&referenceTree, singleMode, epsilon, EuclideanDistance(),
+      parallel);
+
+  arma::Mat<size_t> neighborsOut;
+  arma::mat distancesOut;
+  if (!hasQuerySet)
+  {
+    knn.Search(k, neighborsOut, distancesOut);
+    Unmap(neighborsOut, distancesOut, oldFromNewReferences,
+        oldFromNewReferences, neighbors, distances);
+  }
+  else if (singleMode)
+  {
+    knn.Search(querySet, k, neighborsOut, distancesOut);
+    Unmap(neighborsOut, distancesOut, oldFromNewReferences, neighbors,
+        distances);
+  }
+  else
+  {
+    std::vector<size_t> oldFromNewQueries;
+    typename KNNType::Tree queryTree(std::move(querySet), oldFromNewQueries,
+        leafSize);
+    knn.Search(&queryTree, k, neighborsOut, distancesOut);
+    Unmap(neighborsOut, distancesOut, oldFromNewReferences, oldFromNewQueries,
+        neighbors, distances);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   // Give CLI the command line parameters the user passed in.
@@ -148,10 +231,92 @@ int main(int argc, char *argv[])
     Log::Fatal << "Invalid epsilon: " << epsilon << ".  Must be non-negative. "
         << endl;
 
+  // Sanity check on the number of threads.
+  const int threads = CLI::GetParam<int>("threads");
+  if (threads < 0)
+    Log::Fatal << "Invalid number of threads: " << threads << ".  Must be "
+        << "non-negative." << endl;
+#ifdef _OPENMP
+  if (threads > 0)
+    omp_set_num_threads(threads);
+#else
+  if (threads != 1)
+    Log::Warn << "--threads (-T) ignored because mlpack was compiled without "
+        << "OpenMP support." << endl;
+#endif
+
   // We either have to load the reference data, or we have to load the model.
   NSModel<NearestNeighborSort> knn;
   const bool naive = CLI::HasParam("naive");
   const bool singleMode = CLI::HasParam("single_mode");
+
+  // Single-precision search doesn't go through the model at all.
+  if (CLI::HasParam("float"))
+  {
+    if (CLI::HasParam("input_model_file") ||
+        CLI::HasParam("output_model_file"))
+      Log::Fatal << "--float (-f) cannot be used with --input_model_file (-m) "
+          << "or --output_model_file (-M)!" << endl;
+    if (CLI::HasParam("random_basis"))
+      Log::Fatal << "--float (-f) cannot be used with --random_basis (-R)!"
+          << endl;
+
+    const string treeType = CLI::GetParam<string>("tree_type");
+    if (treeType != "kd" && treeType != "ball")
+      Log::Fatal << "Unsupported tree type '" << treeType << "' for --float "
+          << "(-f); valid choices are 'kd' and 'ball'." << endl;
+
+    if (!CLI::HasParam("k"))
+      return 0;
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+
+    const string referenceFile = CLI::GetParam<string>("reference_file");
+    arma::fmat referenceSet;
+    data::Load(referenceFile, referenceSet, true);
+    Log::Info << "Loaded reference data from '" << referenceFile << "' ("
+        << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
+        << endl;
+
+    // A negative k wraps around to a huge value, so it fails the upper bound.
+    if (k == 0 || k > referenceSet.n_cols)
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less ";
+      Log::Fatal << "than or equal to the number of reference points (";
+      Log::Fatal << referenceSet.n_cols << ")." << endl;
+    }
+
+    arma::fmat querySet;
+    const bool hasQuerySet = CLI::HasParam("query_file");
+    if (hasQuerySet)
+    {
+      const string queryFile = CLI::GetParam<string>("query_file");
+      data::Load(queryFile, querySet, true);
+      Log::Info << "Loaded query data from '" << queryFile << "' ("
+          << querySet.n_rows << "x" << querySet.n_cols << ")." << endl;
+    }
+
+    if (singleMode && naive)
+      Log::Warn << "--single_mode ignored because --naive is present." << endl;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    if (treeType == "kd")
+      FloatSearch<KDTree>(std::move(referenceSet), std::move(querySet),
+          hasQuerySet, k, size_t(lsInt), naive, singleMode, epsilon,
+          threads != 1, neighbors, distances);
+    else
+      FloatSearch<BallTree>(std::move(referenceSet), std::move(querySet),
+          hasQuerySet, k, size_t(lsInt), naive, singleMode, epsilon,
+          threads != 1, neighbors, distances);
+    Log::Info << "Search complete." << endl;
+
+    if (CLI::HasParam("neighbors_file"))
+      data::Save(CLI::GetParam<string>("neighbors_file"), neighbors);
+    if (CLI::HasParam("distances_file"))
+      data::Save(CLI::GetParam<string>("distances_file"), distances);
+
+    return 0;
+  }
   if (CLI::HasParam("reference_file"))
   {
     // Get all the parameters.
@@ -236,6 +401,9 @@ int main(int argc, char *argv[])
       Log::Warn << "--single_mode ignored because --naive is present." << endl;
     }
 
+    // Split tree-based search across threads, if requested.
+    knn.Parallel() = (threads != 1);
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
@@ -86,12 +86,15 @@ class NeighborSearch
    *      dual-tree search).
    * @param epsilon Relative approximate error (non-negative).
    * @param metric An optional instance of the MetricType class.
+   * @param parallel If true, tree-based search will be split across all
+   *      available OpenMP threads.
    */
   NeighborSearch(const MatType& referenceSet,
                  const bool naive = false,
                  const bool singleMode = false,
                  const double epsilon = 0,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const bool parallel = false);
 
   /**
    * Initialize the NeighborSearch object, taking ownership of the reference
@@ -112,12 +115,15 @@ class NeighborSearch
    *      dual-tree search).
    * @param epsilon Relative approximate error (non-negative).
    * @param metric An optional instance of the MetricType class.
+   * @param parallel If true, tree-based search will be split across all
+   *      available OpenMP threads.
    */
   NeighborSearch(MatType&& referenceSet,
                  const bool naive = false,
                  const bool singleMode = false,
                  const double epsilon = 0,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const bool parallel = false);
 
   /**
    * Initialize the NeighborSearch object with the given pre-constructed
@@ -144,11 +150,14 @@ class NeighborSearch
    *      opposed to dual-tree computation).
    * @param epsilon Relative approximate error (non-negative).
    * @param metric Instantiated distance metric.
+   * @param parallel If true, tree-based search will be split across all
+   *      available OpenMP threads.
    */
   NeighborSearch(Tree* referenceTree,
                  const bool singleMode = false,
                  const double epsilon = 0,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const bool parallel = false);
 
   /**
    * Create a NeighborSearch object without any reference data.  If Search() is
@@ -160,11 +169,14 @@ class NeighborSearch
    *      opposed to dual-tree computation).
    * @param epsilon Relative approximate error (non-negative).
    * @param metric Instantiated metric.
+   * @param parallel If true, tree-based search will be split across all
+   *      available OpenMP threads.
    */
   NeighborSearch(const bool naive = false,
                  const bool singleMode = false,
                  const double epsilon = 0,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const bool parallel = false);
 
 
   /**
@@ -278,6 +290,11 @@ class NeighborSearch
   //! Modify whether or not search is done in single-tree mode.
   bool& SingleMode() { return singleMode; }
 
+  //! Access whether or not tree-based search is split across threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not tree-based search is split across threads.
+  bool& Parallel() { return parallel; }
+
   //! Access the relative error to be considered in approximate search.
   double Epsilon() const { return epsilon; }
   //! Modify the relative error to be considered in approximate search.
@@ -307,6 +324,8 @@ class NeighborSearch
   bool naive;
   //! Indicates if single-tree search is being used (as opposed to dual-tree).
   bool singleMode;
+  //! Indicates if tree-based search is split across OpenMP threads.
+  bool parallel;
   //! Indicates the relative error to be considered in approximate search.
   double epsilon;
 
@@ -322,6 +341,45 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  /**
+   * Run a single-tree traversal for each point in the given query set, storing
+   * results in the given matrices (which must already be initialized).  If
+   * parallel search is enabled, the query points are split across threads, and
+   * each thread uses its own rules object and traverser.  The counts of base
+   * cases and scores are added to baseCases and scores.
+   *
+   * @param querySet Set of query points.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param sameSet Whether or not the query set is the reference set.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        arma::Mat<size_t>& neighbors,
+                        arma::mat& distances,
+                        const bool sameSet = false);
+
+  /**
+   * Run a dual-tree traversal of the given query tree against the reference
+   * tree, storing results in the given matrices (which must already be
+   * initialized).  If parallel search is enabled, the query tree is split into
+   * disjoint subtrees, and each subtree is traversed against the reference
+   * tree by its own rules object on a separate thread.  Because each query
+   * subtree only touches its own points and statistics, the traversals do not
+   * share any mutable state.  The counts of base cases and scores are added to
+   * baseCases and scores.
+   *
+   * @param queryTree Tree built on query points.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param sameSet Whether or not the query tree is the reference tree.
+   */
+  void DualTreeSearch(Tree& queryTree,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const bool sameSet = false);
+
   //! The NSModel class should have access to internal members.
   friend class TrainVisitor<SortPolicy>;
 }; // class NeighborSearch
@@ -76,7 +76,8 @@ NeighborSearch(const MatType& referenceSetIn,
                const bool naive,
                const bool singleMode,
                const double epsilon,
-               const MetricType metric) :
+               const MetricType metric,
+               const bool parallel) :
     referenceTree(naive ? NULL :
         BuildTree<MatType, Tree>(referenceSetIn, oldFromNewReferences)),
     referenceSet(naive ? &referenceSetIn : &referenceTree->Dataset()),
@@ -84,6 +85,7 @@ NeighborSearch(const MatType& referenceSetIn,
     setOwner(false),
     naive(naive),
     singleMode(!naive && singleMode), // No single mode if naive.
+    parallel(parallel),
     epsilon(epsilon),
     metric(metric),
     baseCases(0),
@@ -107,7 +109,8 @@ NeighborSearch(MatType&& referenceSetIn,
                const bool naive,
                const bool singleMode,
                const double epsilon,
-               const MetricType metric) :
+               const MetricType metric,
+               const bool parallel) :
     referenceTree(naive ? NULL :
         BuildTree<MatType, Tree>(std::move(referenceSetIn),
                                  oldFromNewReferences)),
@@ -117,6 +120,7 @@ NeighborSearch(MatType&& referenceSetIn,
     setOwner(naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    parallel(parallel),
     epsilon(epsilon),
     metric(metric),
     baseCases(0),
@@ -139,13 +143,15 @@ NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
 NeighborSearch(Tree* referenceTree,
                const bool singleMode,
                const double epsilon,
-               const MetricType metric) :
+               const MetricType metric,
+               const bool parallel) :
     referenceTree(referenceTree),
     referenceSet(&referenceTree->Dataset()),
     treeOwner(false),
     setOwner(false),
     naive(false),
     singleMode(singleMode),
+    parallel(parallel),
     epsilon(epsilon),
     metric(metric),
     baseCases(0),
@@ -168,13 +174,15 @@ NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
     NeighborSearch(const bool naive,
                    const bool singleMode,
                    const double epsilon,
-                   const MetricType metric) :
+                   const MetricType metric,
+                   const bool parallel) :
     referenceTree(NULL),
     referenceSet(new MatType()), // Empty matrix.
     treeOwner(false),
     setOwner(true),
     naive(naive),
     singleMode(singleMode),
+    parallel(parallel),
     epsilon(epsilon),
     metric(metric),
     baseCases(0),
@@ -389,22 +397,11 @@ Search(const MatType& querySet,
   }
   else if (singleMode)
   {
-    // Create the helper object for the tree traversal.
-    RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric,
-        epsilon);
+    // Run the traversal for each point (this may be split across threads).
+    SingleTreeSearch(querySet, *neighborPtr, *distancePtr);
 
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    scores += rules.Scores();
-    baseCases += rules.BaseCases();
-
-    Log::Info << rules.Scores() << " node combinations were scored.\n";
-    Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+    Log::Info << scores << " node combinations were scored.\n";
+    Log::Info << baseCases << " base cases were calculated.\n";
   }
   else // Dual-tree recursion.
   {
@@ -415,20 +412,11 @@ Search(const MatType& querySet,
     Timer::Stop("tree_building");
     Timer::Start("computing_neighbors");
 
-    // Create the helper object for the tree traversal.
-    RuleType rules(*referenceSet, queryTree->Dataset(), *neighborPtr,
-        *distancePtr, metric, epsilon);
+    // Run the traversal (this may be split across threads).
+    DualTreeSearch(*queryTree, *neighborPtr, *distancePtr);
 
-    // Create the traverser.
-    TraversalType<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    scores += rules.Scores();
-    baseCases += rules.BaseCases();
-
-    Log::Info << rules.Scores() << " node combinations were scored.\n";
-    Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+    Log::Info << scores << " node combinations were scored.\n";
+    Log::Info << baseCases << " base cases were calculated.\n";
 
     delete queryTree;
   }
@@ -540,17 +528,8 @@ Search(Tree* queryTree,
   distances.set_size(k, querySet.n_cols);
   distances.fill(SortPolicy::WorstDistance());
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, *neighborPtr, distances, metric,
-      epsilon);
-
-  // Create the traverser.
-  TraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
-
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
+  // Run the traversal (this may be split across threads).
+  DualTreeSearch(*queryTree, *neighborPtr, distances);
 
   Timer::Stop("computing_neighbors");
 
@@ -611,13 +590,14 @@ Search(const size_t k,
   distancePtr->set_size(k, referenceSet->n_cols);
   distancePtr->fill(SortPolicy::WorstDistance());
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, *neighborPtr, *distancePtr,
-      metric, epsilon, true /* don't return the same point as nearest neighbor */);
-
   if (naive)
   {
+    // Create the helper object for the traversal.
+    typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+    // Don't return the same point as its own nearest neighbor.
+    RuleType rules(*referenceSet, *referenceSet, *neighborPtr, *distancePtr,
+        metric, epsilon, true);
+
     // The naive brute-force solution.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
       for (size_t j = 0; j < referenceSet->n_cols; ++j)
@@ -627,18 +607,11 @@ Search(const size_t k,
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Run the traversal for each point (this may be split across threads).
+    SingleTreeSearch(*referenceSet, *neighborPtr, *distancePtr, true);
 
-    scores += rules.Scores();
-    baseCases += rules.BaseCases();
-
-    Log::Info << rules.Scores() << " node combinations were scored.\n";
-    Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+    Log::Info << scores << " node combinations were scored.\n";
+    Log::Info << baseCases << " base cases were calculated.\n";
   }
   else
   {
@@ -662,16 +635,11 @@ Search(const size_t k,
       }
     }
 
-    // Create the traverser.
-    TraversalType<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    // Run the traversal (this may be split across threads).
+    DualTreeSearch(*referenceTree, *neighborPtr, *distancePtr, true);
 
-    scores += rules.Scores();
-    baseCases += rules.BaseCases();
-
-    Log::Info << rules.Scores() << " node combinations were scored.\n";
-    Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+    Log::Info << scores << " node combinations were scored.\n";
+    Log::Info << baseCases << " base cases were calculated.\n";
 
     // Next time we perform this search, we'll need to reset the tree.
     treeNeedsReset = true;
@@ -702,6 +670,126 @@ Search(const size_t k,
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class TraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
+SingleTreeSearch(const MatType& querySet,
+                 arma::Mat<size_t>& neighbors,
+                 arma::mat& distances,
+                 const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Each thread gets its own rules object and traverser, and the rules only
+  // modify the results of the query point being searched for, so no
+  // synchronization is necessary.  Trees with self-children cache distances in
+  // the reference tree's statistics during single-tree search, so those must be
+  // searched serially.
+  size_t taskScores = 0;
+  size_t taskBaseCases = 0;
+  #pragma omp parallel if (parallel && \
+      !tree::TreeTraits<Tree>::HasSelfChildren) \
+      reduction(+:taskScores, taskBaseCases)
+  {
+    RuleType rules(*referenceSet, querySet, neighbors, distances, metric,
+        epsilon, sameSet);
+
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+    // Now have it traverse for each point.
+    #pragma omp for schedule(dynamic, 64)
+    for (intmax_t i = 0; i < (intmax_t) querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    taskScores += rules.Scores();
+    taskBaseCases += rules.BaseCases();
+  }
+
+  scores += taskScores;
+  baseCases += taskBaseCases;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class TraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
+DualTreeSearch(Tree& queryTree,
+               arma::Mat<size_t>& neighbors,
+               arma::mat& distances,
+               const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Split the query tree into disjoint subtrees.  We aim for several subtrees
+  // per thread so that OpenMP's dynamic scheduling can balance the load when
+  // some subtrees are much more expensive than others.  Nodes that hold points
+  // of their own cannot be split (we would lose those points), and trees with
+  // self-children (i.e. cover trees) share points between parent and child, so
+  // those are not split at all.
+  std::vector<Tree*> queryNodes(1, &queryTree);
+#ifdef _OPENMP
+  const size_t minTasks = (parallel &&
+      !tree::TreeTraits<Tree>::HasSelfChildren) ? 8 * omp_get_max_threads() :
+      1;
+#else
+  const size_t minTasks = 1;
+#endif
+
+  while (queryNodes.size() < minTasks)
+  {
+    std::vector<Tree*> children;
+    bool split = false;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      Tree* node = queryNodes[i];
+      if (node->NumChildren() == 0 || node->NumPoints() != 0)
+      {
+        children.push_back(node);
+        continue;
+      }
+
+      for (size_t j = 0; j < node->NumChildren(); ++j)
+        children.push_back(&node->Child(j));
+      split = true;
+    }
+
+    queryNodes.swap(children);
+    if (!split)
+      break; // Every node is a leaf.
+  }
+
+  // Each subtree gets its own rules object and traverser.  The rules only
+  // modify the results for points held in the query subtree and the statistics
+  // of nodes in the query subtree, so no synchronization is necessary.
+  size_t taskScores = 0;
+  size_t taskBaseCases = 0;
+  #pragma omp parallel for schedule(dynamic, 1) \
+      reduction(+:taskScores, taskBaseCases) if (queryNodes.size() > 1)
+  for (intmax_t i = 0; i < (intmax_t) queryNodes.size(); ++i)
+  {
+    RuleType rules(*referenceSet, queryTree.Dataset(), neighbors, distances,
+        metric, epsilon, sameSet);
+
+    TraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*queryNodes[i], *referenceTree);
+
+    taskScores += rules.Scores();
+    taskBaseCases += rules.BaseCases();
+  }
+
+  scores += taskScores;
+  baseCases += taskBaseCases;
+}
+
 //! Serialize the NeighborSearch model.
 template<typename SortPolicy,
          typename MetricType,
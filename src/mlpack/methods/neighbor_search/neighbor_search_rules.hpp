@@ -9,6 +9,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/euclidean_block.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -34,6 +35,23 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and each of
+   * the given contiguous reference points.  This gives the same results as
+   * calling BaseCase() on every pair.  But when MetricType is the Euclidean
+   * distance, all of the distances are first approximated at once with
+   * metric::EuclideanBlock, and only the pairs that might enter the results
+   * are evaluated exactly.  The dual-tree traverser calls this when both nodes
+   * are leaves.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BaseCaseBlock(const arma::uvec& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -140,6 +158,31 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! True if BaseCaseBlock() can approximate distances with EuclideanBlock.
+  static const bool UsesEuclideanBlock =
+      metric::IsEuclideanMetric<MetricType>::value &&
+      std::is_same<typename TreeType::Mat, arma::mat>::value;
+
+  //! Below this dimensionality, exact evaluation of each pair is cheaper than
+  //! approximating the block first.
+  static const size_t minBlockDimensionality = 16;
+
+  //! Evaluate a block of base cases with EuclideanBlock.
+  template<bool UseBlock = UsesEuclideanBlock>
+  void BaseCaseBlockImpl(const arma::uvec& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceCount,
+                         const typename boost::enable_if_c<UseBlock>::type*
+                             = 0);
+
+  //! Evaluate a block of base cases one pair at a time.
+  template<bool UseBlock = UsesEuclideanBlock>
+  void BaseCaseBlockImpl(const arma::uvec& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceCount,
+                         const typename boost::disable_if_c<UseBlock>::type*
+                             = 0);
+
   /**
    * Recalculate the bound for a given query node.
    */
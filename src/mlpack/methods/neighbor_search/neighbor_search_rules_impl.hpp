@@ -78,6 +78,81 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  BaseCaseBlockImpl(queryIndices, referenceBegin, referenceCount);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<bool UseBlock>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlockImpl(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename boost::enable_if_c<UseBlock>::type* /* junk */)
+{
+  if (querySet.n_rows < minBlockDimensionality)
+  {
+    BaseCaseBlockImpl<false>(queryIndices, referenceBegin, referenceCount);
+    return;
+  }
+
+  const arma::mat queries = querySet.cols(queryIndices);
+  const arma::mat references = referenceSet.cols(referenceBegin,
+      referenceBegin + referenceCount - 1);
+  arma::mat squaredDistances, errorBounds;
+  metric::EuclideanBlock::SquaredDistances(queries, references,
+      squaredDistances, errorBounds);
+
+  for (size_t i = 0; i < queryIndices.n_elem; ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Bound the true distance between the two points.
+      double lo = std::max(squaredDistances(i, j) - errorBounds(i, j), 0.0);
+      double hi = squaredDistances(i, j) + errorBounds(i, j);
+      if (MetricType::TakeRoot)
+      {
+        lo = std::sqrt(lo);
+        hi = std::sqrt(hi);
+      }
+
+      // Only evaluate the distance exactly if it could be inserted into the
+      // results.  The k'th best distance changes as we go, so check it every
+      // time.
+      const double bestDistance = distances(distances.n_rows - 1, queryIndex);
+      if (SortPolicy::IsBetter(lo, bestDistance) ||
+          SortPolicy::IsBetter(hi, bestDistance))
+        BaseCase(queryIndex, referenceIndex);
+      else
+        ++baseCases;
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<bool UseBlock>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlockImpl(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename boost::disable_if_c<UseBlock>::type* /* junk */)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = 0; i < queryIndices.n_elem; ++i)
+    for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+      BaseCase(queryIndices[i], ref);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
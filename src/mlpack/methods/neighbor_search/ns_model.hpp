@@ -171,6 +171,16 @@ class SingleModeVisitor : public boost::static_visitor<bool&>
   bool& operator()(NSType* ns) const;
 };
 
+/**
+ * ParallelVisitor exposes the Parallel method of the given NSType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  template<typename NSType>
+  bool& operator()(NSType* ns) const;
+};
+
 /**
  * NaiveVisitor exposes the Naive method of the given NSType.
  */
@@ -280,6 +290,10 @@ class NSModel
   bool Naive() const;
   bool& Naive();
 
+  //! Expose parallel.
+  bool Parallel() const;
+  bool& Parallel();
+
   //! Expose Epsilon.
   double Epsilon() const;
   double& Epsilon();
@@ -167,6 +167,15 @@ bool& SingleModeVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the Parallel method of the given NSType.
+template<typename NSType>
+bool& ParallelVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Parallel();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the Naive method of the given NSType.
 template<typename NSType>
 bool& NaiveVisitor::operator()(NSType* ns) const
@@ -293,6 +302,19 @@ bool& NSModel<SortPolicy>::Naive()
   return boost::apply_visitor(NaiveVisitor(), nSearch);
 }
 
+//! Expose parallel.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+bool& NSModel<SortPolicy>::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), nSearch);
+}
+
 template<typename SortPolicy>
 double NSModel<SortPolicy>::Epsilon() const
 {
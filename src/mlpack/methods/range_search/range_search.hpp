@@ -55,11 +55,14 @@ class RangeSearch
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
    * @param metric Instantiated distance metric.
+   * @param parallel If true, single-tree search will be split across all
+   *      available OpenMP threads.
    */
   RangeSearch(const MatType& referenceSet,
               const bool naive = false,
               const bool singleMode = false,
-              const MetricType metric = MetricType());
+              const MetricType metric = MetricType(),
+              const bool parallel = false);
 
   /**
    * Initialize the RangeSearch object with the given reference dataset (this is
@@ -79,11 +82,14 @@ class RangeSearch
    * @param singleMode If true, single-tree search will be used (as opposed to
    *      dual-tree search).
    * @param metric An optional instance of the MetricType class.
+   * @param parallel If true, single-tree search will be split across all
+   *      available OpenMP threads.
    */
   RangeSearch(MatType&& referenceSet,
               const bool naive = false,
               const bool singleMode = false,
-              const MetricType metric = MetricType());
+              const MetricType metric = MetricType(),
+              const bool parallel = false);
 
   /**
    * Initialize the RangeSearch object with the given pre-constructed reference
@@ -108,10 +114,13 @@ class RangeSearch
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
    * @param metric Instantiated distance metric.
+   * @param parallel If true, single-tree search will be split across all
+   *      available OpenMP threads.
    */
   RangeSearch(Tree* referenceTree,
               const bool singleMode = false,
-              const MetricType metric = MetricType());
+              const MetricType metric = MetricType(),
+              const bool parallel = false);
 
   /**
    * Initialize the RangeSearch object without any reference data.  If the
@@ -122,10 +131,13 @@ class RangeSearch
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
    * @param metric Instantiated metric.
+   * @param parallel If true, single-tree search will be split across all
+   *      available OpenMP threads.
    */
   RangeSearch(const bool naive = false,
               const bool singleMode = false,
-              const MetricType metric = MetricType());
+              const MetricType metric = MetricType(),
+              const bool parallel = false);
 
   /**
    * Destroy the RangeSearch object.  If trees were created, they will be
@@ -275,6 +287,11 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  //! Get whether single-tree search is split across threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether single-tree search is split across threads.
+  bool& Parallel() { return parallel; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -308,6 +325,8 @@ class RangeSearch
   bool naive;
   //! If true, single-tree computation is used.
   bool singleMode;
+  //! If true, single-tree computation is split across OpenMP threads.
+  bool parallel;
 
   //! Instantiated distance metric.
   MetricType metric;
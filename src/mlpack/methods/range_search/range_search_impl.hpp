@@ -70,7 +70,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     const MatType& referenceSetIn,
     const bool naive,
     const bool singleMode,
-    const MetricType metric) :
+    const MetricType metric,
+    const bool parallel) :
     referenceTree(naive ? NULL : BuildTree<Tree>(
         const_cast<MatType&>(referenceSetIn), oldFromNewReferences)),
     referenceSet(naive ? &referenceSetIn : &referenceTree->Dataset()),
@@ -78,6 +79,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(false),
     naive(naive),
     singleMode(!naive && singleMode), // Naive overrides single mode.
+    parallel(parallel),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -95,7 +97,8 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     MatType&& referenceSet,
     const bool naive,
     const bool singleMode,
-    const MetricType metric) :
+    const MetricType metric,
+    const bool parallel) :
     referenceTree(naive ? NULL : BuildTree<Tree>(std::move(referenceSet),
         oldFromNewReferences)),
     referenceSet(naive ? new MatType(std::move(referenceSet)) :
@@ -104,6 +107,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     setOwner(naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    parallel(parallel),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -119,13 +123,15 @@ template<typename MetricType,
 RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     Tree* referenceTree,
     const bool singleMode,
-    const MetricType metric) :
+    const MetricType metric,
+    const bool parallel) :
     referenceTree(referenceTree),
     referenceSet(&referenceTree->Dataset()),
     treeOwner(false),
     setOwner(false),
     naive(false),
     singleMode(singleMode),
+    parallel(parallel),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -141,13 +147,15 @@ template<typename MetricType,
 RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     const bool naive,
     const bool singleMode,
-    const MetricType metric) :
+    const MetricType metric,
+    const bool parallel) :
     referenceTree(NULL),
     referenceSet(new MatType()), // Empty matrix.
     treeOwner(false),
     setOwner(true),
     naive(naive),
     singleMode(singleMode),
+    parallel(parallel),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -348,17 +356,33 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // If requested, split the query points across threads.  Each thread gets
+    // its own rules object and traverser; the rules only modify the results
+    // of the query point being searched for, so no synchronization is
+    // necessary.  Trees whose first point is the centroid cache distances in
+    // the reference tree's statistics, so those must be searched serially.
+    size_t taskBaseCases = 0;
+    size_t taskScores = 0;
+    #pragma omp parallel if (parallel && \
+        !tree::TreeTraits<Tree>::FirstPointIsCentroid) \
+        reduction(+:taskBaseCases, taskScores)
+    {
+      // Create the traverser.
+      RuleType rules(*referenceSet, querySet, range, *neighborPtr,
+          *distancePtr, metric);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 64)
+      for (intmax_t i = 0; i < (intmax_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      taskBaseCases += rules.BaseCases();
+      taskScores += rules.Scores();
+    }
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    baseCases += taskBaseCases;
+    scores += taskScores;
   }
   else // Dual-tree recursion.
   {
@@ -551,11 +575,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
 
   if (naive)
   {
+    // Don't return the query in the results.
+    RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+        *distancePtr, metric, true);
+
     // The naive brute-force solution.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
       for (size_t j = 0; j < referenceSet->n_cols; ++j)
@@ -566,18 +592,42 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    baseCases = 0;
+    scores = 0;
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // If requested, split the query points across threads, with a separate
+    // rules object and traverser for each thread.
+    size_t taskBaseCases = 0;
+    size_t taskScores = 0;
+    #pragma omp parallel if (parallel && \
+        !tree::TreeTraits<Tree>::FirstPointIsCentroid) \
+        reduction(+:taskBaseCases, taskScores)
+    {
+      // Don't return the query in the results.
+      RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+      // Create the traverser.
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 64)
+      for (intmax_t i = 0; i < (intmax_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      taskBaseCases += rules.BaseCases();
+      taskScores += rules.Scores();
+    }
+
+    baseCases += taskBaseCases;
+    scores += taskScores;
   }
   else // Dual-tree recursion.
   {
+    // Don't return the query in the results.
+    RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+        *distancePtr, metric, true);
+
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -8,6 +8,7 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/euclidean_block.hpp>
 
 namespace mlpack {
 namespace range {
@@ -30,8 +31,8 @@ class RangeSearchRules
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
                    std::vector<std::vector<size_t> >& neighbors,
                    std::vector<std::vector<double> >& distances,
@@ -46,6 +47,22 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and each of
+   * the given contiguous reference points.  This gives the same results as
+   * calling BaseCase() on every pair.  But when MetricType is the Euclidean
+   * distance, all of the distances are first approximated at once with
+   * metric::EuclideanBlock, and only the pairs that might lie in the range are
+   * evaluated exactly.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BaseCaseBlock(const arma::uvec& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -108,10 +125,10 @@ class RangeSearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
@@ -133,6 +150,31 @@ class RangeSearchRules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! True if BaseCaseBlock() can approximate distances with EuclideanBlock.
+  static const bool UsesEuclideanBlock =
+      metric::IsEuclideanMetric<MetricType>::value &&
+      std::is_same<typename TreeType::Mat, arma::mat>::value;
+
+  //! Below this dimensionality, exact evaluation of each pair is cheaper than
+  //! approximating the block first.
+  static const size_t minBlockDimensionality = 16;
+
+  //! Evaluate a block of base cases with EuclideanBlock.
+  template<bool UseBlock = UsesEuclideanBlock>
+  void BaseCaseBlockImpl(const arma::uvec& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceCount,
+                         const typename boost::enable_if_c<UseBlock>::type*
+                             = 0);
+
+  //! Evaluate a block of base cases one pair at a time.
+  template<bool UseBlock = UsesEuclideanBlock>
+  void BaseCaseBlockImpl(const arma::uvec& queryIndices,
+                         const size_t referenceBegin,
+                         const size_t referenceCount,
+                         const typename boost::disable_if_c<UseBlock>::type*
+                             = 0);
+
   //! Add all the points in the given node to the results for the given query
   //! point.  If the base case has already been calculated, we make sure to not
   //! add that to the results twice.
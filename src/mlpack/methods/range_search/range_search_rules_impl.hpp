@@ -15,8 +15,8 @@ namespace range {
 
 template<typename MetricType, typename TreeType>
 RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t> >& neighbors,
     std::vector<std::vector<double> >& distances,
@@ -70,7 +70,78 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   return distance;
 }
 
-//! Single-tree scoring function.
+//! Base cases between a set of query points and a run of reference points.
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlock(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  BaseCaseBlockImpl(queryIndices, referenceBegin, referenceCount);
+}
+
+template<typename MetricType, typename TreeType>
+template<bool UseBlock>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlockImpl(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename boost::enable_if_c<UseBlock>::type* /* junk */)
+{
+  if (querySet.n_rows < minBlockDimensionality)
+  {
+    BaseCaseBlockImpl<false>(queryIndices, referenceBegin, referenceCount);
+    return;
+  }
+
+  const arma::mat queries = querySet.cols(queryIndices);
+  const arma::mat references = referenceSet.cols(referenceBegin,
+      referenceBegin + referenceCount - 1);
+  arma::mat squaredDistances, errorBounds;
+  metric::EuclideanBlock::SquaredDistances(queries, references,
+      squaredDistances, errorBounds);
+
+  for (size_t i = 0; i < queryIndices.n_elem; ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Bound the true distance between the two points.
+      double lo = std::max(squaredDistances(i, j) - errorBounds(i, j), 0.0);
+      double hi = squaredDistances(i, j) + errorBounds(i, j);
+      if (MetricType::TakeRoot)
+      {
+        lo = std::sqrt(lo);
+        hi = std::sqrt(hi);
+      }
+
+      // Only evaluate the distance exactly if it could be in the range.
+      if (hi < range.Lo() || lo > range.Hi())
+        ++baseCases;
+      else
+        BaseCase(queryIndex, referenceIndex);
+    }
+  }
+}
+
+template<typename MetricType, typename TreeType>
+template<bool UseBlock>
+void RangeSearchRules<MetricType, TreeType>::BaseCaseBlockImpl(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename boost::disable_if_c<UseBlock>::type* /* junk */)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = 0; i < queryIndices.n_elem; ++i)
+    for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+      BaseCase(queryIndices[i], ref);
+}
+
 template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                                      TreeType& referenceNode)
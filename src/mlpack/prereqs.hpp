@@ -25,6 +25,11 @@
 #include <stdexcept>
 #include <tuple>
 
+// If OpenMP is available, we need its runtime functions for thread control.
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 // Defining _USE_MATH_DEFINES should set M_PI.
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -0,0 +1,86 @@
+/**
+ * @file ann_test_tools.hpp
+ *
+ * Utility functions shared by the tests of the neural networks.
+ */
+#ifndef MLPACK_TESTS_ANN_TEST_TOOLS_HPP
+#define MLPACK_TESTS_ANN_TEST_TOOLS_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/inference_handle.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+namespace mlpack {
+
+//! Return the number of points of a set of predictors.
+inline size_t NumPoints(const arma::mat& predictors)
+{
+  return predictors.n_cols;
+}
+
+inline size_t NumPoints(const arma::cube& predictors)
+{
+  return predictors.n_slices;
+}
+
+//! Return a single point of a set of predictors.
+inline arma::mat Point(const arma::mat& predictors, const size_t i)
+{
+  return predictors.col(i);
+}
+
+inline arma::cube Point(const arma::cube& predictors, const size_t i)
+{
+  return predictors.slices(i, i);
+}
+
+/**
+ * Make sure that predictions computed through an InferenceHandle of the given
+ * trained network from several threads at once are the same as those of the
+ * network itself, and that the handle shares the parameters of the network.
+ * The parameters of the network are zeroed afterwards.
+ */
+template<typename NetworkType, typename PredictorsType>
+void CheckInferenceHandle(NetworkType& net, PredictorsType& predictors)
+{
+  arma::mat predictions;
+  net.Predict(predictors, predictions);
+
+  ann::InferenceHandle<NetworkType> handle(net, 3);
+  BOOST_REQUIRE_EQUAL(handle.Workspaces(), 3);
+
+  // Predict every point separately, in parallel, and the whole set at once.
+  const size_t points = NumPoints(predictors);
+  std::vector<arma::mat> pointPredictions(points);
+  #pragma omp parallel for
+  for (intmax_t i = 0; i < (intmax_t) points; ++i)
+    handle.Predict(Point(predictors, i), pointPredictions[i]);
+
+  arma::mat handlePredictions;
+  handle.Predict(predictors, handlePredictions);
+
+  BOOST_REQUIRE_EQUAL(handlePredictions.n_rows, predictions.n_rows);
+  BOOST_REQUIRE_EQUAL(handlePredictions.n_cols, predictions.n_cols);
+  for (size_t i = 0; i < points; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(pointPredictions[i].n_elem, predictions.n_rows);
+    for (size_t j = 0; j < predictions.n_rows; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(pointPredictions[i][j], predictions(j, i), 1e-5);
+      BOOST_REQUIRE_CLOSE(handlePredictions(j, i), predictions(j, i), 1e-5);
+    }
+  }
+
+  // The handle shares the parameters of the network.
+  net.Parameters().zeros();
+  handle.Predict(predictors, handlePredictions);
+  net.Predict(predictors, predictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(handlePredictions[i], predictions[i], 1e-5);
+}
+
+} // namespace mlpack
+
+#endif
@@ -11,6 +11,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/layer/conv_layer.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -144,6 +146,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -181,6 +187,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -226,6 +236,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -275,6 +289,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -317,6 +335,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -363,6 +385,107 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix multiplication.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/**
+ * Make sure that the im2col path of the ConvLayer computes the same forward
+ * pass, backward pass and gradient as the per-map naive convolution, with
+ * several input and output maps.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvLayerTest)
+{
+  ConvLayer<> naiveLayer(3, 4, 3, 2);
+  ConvLayer<Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<FullConvolution>,
+            Im2ColConvolution<ValidConvolution> > im2colLayer(3, 4, 3, 2);
+
+  naiveLayer.Weights().randn();
+  im2colLayer.Weights() = naiveLayer.Weights();
+
+  arma::cube input(7, 6, 3);
+  input.randn();
+  naiveLayer.InputParameter() = input;
+  im2colLayer.InputParameter() = input;
+
+  arma::cube naiveOutput, im2colOutput;
+  naiveLayer.Forward(input, naiveOutput);
+  im2colLayer.Forward(input, im2colOutput);
+
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_slices, 4);
+  for (size_t i = 0; i < naiveOutput.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(naiveOutput[i], im2colOutput[i], 1e-3);
+
+  arma::cube error(naiveOutput.n_rows, naiveOutput.n_cols,
+      naiveOutput.n_slices);
+  error.randn();
+
+  arma::cube naiveDelta, im2colDelta;
+  naiveLayer.Backward(naiveOutput, error, naiveDelta);
+  im2colLayer.Backward(im2colOutput, error, im2colDelta);
+
+  BOOST_REQUIRE_EQUAL(im2colDelta.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(im2colDelta.n_cols, input.n_cols);
+  BOOST_REQUIRE_EQUAL(im2colDelta.n_slices, input.n_slices);
+  for (size_t i = 0; i < naiveDelta.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(naiveDelta[i], im2colDelta[i], 1e-3);
+
+  arma::cube naiveGradient, im2colGradient;
+  naiveLayer.Gradient(input, error, naiveGradient);
+  im2colLayer.Gradient(input, error, im2colGradient);
+
+  BOOST_REQUIRE_EQUAL(im2colGradient.n_elem, naiveGradient.n_elem);
+  for (size_t i = 0; i < naiveGradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(naiveGradient[i], im2colGradient[i], 1e-3);
+}
+
+/**
+ * Check the im2col path of the ConvLayer with a stride and padding against a
+ * direct computation of the strided, zero-padded convolution.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvLayerStridePaddingTest)
+{
+  ConvLayer<Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<FullConvolution>,
+            Im2ColConvolution<ValidConvolution> > layer(2, 3, 3, 3, 2, 2, 1, 1);
+  layer.Weights().randn();
+
+  arma::cube input(6, 5, 2);
+  input.randn();
+
+  arma::cube output;
+  layer.Forward(input, output);
+
+  // (6 + 2 - 3) / 2 + 1 = 3 and (5 + 2 - 3) / 2 + 1 = 3.
+  BOOST_REQUIRE_EQUAL(output.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(output.n_slices, 3);
+
+  arma::cube padded = arma::zeros<arma::cube>(8, 7, 2);
+  padded.subcube(1, 1, 0, 6, 5, 1) = input;
+
+  for (size_t o = 0; o < 3; ++o)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      for (size_t i = 0; i < 3; ++i)
+      {
+        double value = 0;
+        for (size_t s = 0; s < 2; ++s)
+        {
+          value += arma::accu(padded.slice(s).submat(2 * i, 2 * j, 2 * i + 2,
+              2 * j + 2) % layer.Weights().slice(s * 3 + o));
+        }
+
+        BOOST_REQUIRE_CLOSE(output(i, j, o), value, 1e-3);
+      }
+    }
+  }
 }
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -24,6 +24,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -140,4 +141,38 @@ BOOST_AUTO_TEST_CASE(VanillaNetworkTest)
   BuildVanillaNetwork<LogisticFunction>();
 }
 
+/**
+ * Make sure that predictions computed through an InferenceHandle from several
+ * threads at once are the same as those of the network itself.
+ */
+BOOST_AUTO_TEST_CASE(InferenceHandleTest)
+{
+  arma::cube input = arma::randu<arma::cube>(10, 10, 30);
+  arma::mat Y = arma::zeros<arma::mat>(3, input.n_slices);
+  for (size_t i = 0; i < input.n_slices; ++i)
+    Y(i % 3, i) = 1;
+
+  ConvLayer<> convLayer0(1, 4, 5, 5);
+  BiasLayer2D<> biasLayer0(4);
+  BaseLayer2D<> baseLayer0;
+  PoolingLayer<> poolingLayer0(2);
+
+  LinearMappingLayer<> linearLayer0(36, 3);
+  BiasLayer<> biasLayer1(3);
+  SoftmaxLayer<> softmaxLayer0;
+
+  OneHotLayer outputLayer;
+
+  auto modules = std::tie(convLayer0, biasLayer0, baseLayer0, poolingLayer0,
+                          linearLayer0, biasLayer1, softmaxLayer0);
+
+  CNN<decltype(modules), decltype(outputLayer),
+      RandomInitialization, MeanSquaredErrorFunction> net(modules, outputLayer);
+
+  RMSprop<decltype(net)> opt(net, 0.01, 0.88, 1e-8, 2 * input.n_slices, 0);
+  net.Train(input, Y, opt);
+
+  CheckInferenceHandle(net, input);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -373,4 +373,75 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionTrainTest)
       BOOST_REQUIRE_SMALL(d.Covariance()(i, j) - actualCov(i, j), 1e-5);
 }
 
+/**
+ * Make sure a DiagonalGaussianDistribution gives the same probabilities as a
+ * GaussianDistribution with the same (diagonal) covariance, for single points
+ * and for batches.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionProbabilityTest)
+{
+  arma::vec mean("5 6 3 3 2");
+  arma::vec variances("6 7 4 0.5 2");
+
+  DiagonalGaussianDistribution d(mean, variances);
+  GaussianDistribution g(mean, arma::diagmat(variances));
+
+  BOOST_REQUIRE_EQUAL(d.Dimensionality(), 5);
+
+  arma::mat points(5, 20);
+  points.randn();
+  points *= 3.0;
+
+  arma::vec logProbabilities, expectedLogProbabilities;
+  d.LogProbability(points, logProbabilities);
+  g.LogProbability(points, expectedLogProbabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 20);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], expectedLogProbabilities[i],
+        1e-5);
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.col(i)),
+        expectedLogProbabilities[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Probability(points.col(i)),
+        g.Probability(points.col(i)), 1e-5);
+  }
+}
+
+/**
+ * Make sure that a DiagonalGaussianDistribution can be estimated from given
+ * observations, with and without probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionTrainTest)
+{
+  arma::vec mean("1.0 3.0 0.0 2.5");
+  arma::vec variances("3.0 2.4 6.3 9.1");
+
+  arma::mat observations = arma::randn<arma::mat>(4, 10000);
+  observations.each_col() %= arma::sqrt(variances);
+  observations.each_col() += mean;
+
+  DiagonalGaussianDistribution d;
+  d.Train(observations);
+
+  const arma::vec actualMean = arma::mean(observations, 1);
+  const arma::mat actualCov = ccov(observations);
+  for (size_t i = 0; i < 4; i++)
+  {
+    BOOST_REQUIRE_SMALL(d.Mean()[i] - actualMean[i], 1e-5);
+    BOOST_REQUIRE_SMALL(d.Covariance()[i] - actualCov(i, i), 1e-5);
+  }
+
+  // With probabilities, the estimates should match those of a full Gaussian.
+  const arma::vec probabilities = arma::randu<arma::vec>(10000);
+  GaussianDistribution g;
+  d.Train(observations, probabilities);
+  g.Train(observations, probabilities);
+  for (size_t i = 0; i < 4; i++)
+  {
+    BOOST_REQUIRE_CLOSE(d.Mean()[i], g.Mean()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Covariance()[i], g.Covariance()(i, i), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -55,6 +55,47 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Compare parallel single-tree search and naive search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeVsNaive)
+{
+  arma::mat data;
+  data.randn(5, 1000);
+  arma::mat queryData;
+  queryData.randn(5, 300);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(data, lk, false, true);
+  FastMKS<LinearKernel> single(data, lk, true, false, true);
+
+  arma::Mat<size_t> naiveIndices, singleIndices;
+  arma::mat naiveProducts, singleProducts;
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    if (trial == 0)
+    {
+      naive.Search(10, naiveIndices, naiveProducts);
+      single.Search(10, singleIndices, singleProducts);
+    }
+    else
+    {
+      naive.Search(queryData, 10, naiveIndices, naiveProducts);
+      single.Search(queryData, 10, singleIndices, singleProducts);
+    }
+
+    for (size_t q = 0; q < singleIndices.n_cols; ++q)
+    {
+      for (size_t r = 0; r < singleIndices.n_rows; ++r)
+      {
+        BOOST_REQUIRE_EQUAL(singleIndices(r, q), naiveIndices(r, q));
+        BOOST_REQUIRE_CLOSE(singleProducts(r, q), naiveProducts(r, q), 1e-5);
+      }
+    }
+  }
+}
+
 /**
  * Compare dual-tree and naive.
  */
@@ -18,13 +18,16 @@
 #include <mlpack/methods/ann/layer/dropout_layer.hpp>
 #include <mlpack/methods/ann/layer/binary_classification_layer.hpp>
 #include <mlpack/methods/ann/layer/dropconnect_layer.hpp>
+#include <mlpack/methods/ann/layer/multiclass_classification_layer.hpp>
 
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/performance_functions/mse_function.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -501,4 +504,239 @@ BOOST_AUTO_TEST_CASE(DropConnectNetworkTest)
       (dataset, labels, dataset, labels, 8, 30, 0.4);
 }
 
+/**
+ * Build a small network for random data, set the data without taking any
+ * training steps, and run the given check with the network, its layers and the
+ * data.
+ */
+template<typename PerformanceFunctionType, typename CheckType>
+void CheckBatchNetwork(const CheckType& check)
+{
+  arma::mat trainData = arma::randu<arma::mat>(5, 40);
+  arma::mat trainLabels = arma::zeros<arma::mat>(2, 40);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    trainLabels(i % 2, i) = 1;
+
+  LinearLayer<> inputLayer(trainData.n_rows, 4);
+  BiasLayer<> inputBiasLayer(4);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+
+  LinearLayer<> hiddenLayer1(4, trainLabels.n_rows);
+  BiasLayer<> hiddenBiasLayer1(trainLabels.n_rows);
+  BaseLayer<LogisticFunction> outputLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+                          hiddenLayer1, hiddenBiasLayer1, outputLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      PerformanceFunctionType> net(modules, classOutputLayer);
+
+  // This sets the training data without taking any steps.
+  MiniBatchSGD<decltype(net)> opt(net, 10, 0.01, 1);
+  net.Train(trainData, trainLabels, opt);
+
+  check(net, modules, trainData);
+}
+
+/**
+ * Propagating a batch of points through the network at once should give the
+ * same objective and gradient as the sum over each of the points on their own.
+ */
+struct BatchGradientCheck
+{
+  template<typename NetworkType, typename LayerTypes>
+  void operator()(NetworkType& net,
+                  LayerTypes& /* layers */,
+                  arma::mat& trainData) const
+  {
+    const size_t begin = 10;
+    const size_t batchSize = 17;
+
+    double objective = 0;
+    arma::mat gradient = arma::zeros<arma::mat>(net.Parameters().n_rows,
+        net.Parameters().n_cols);
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      objective += net.Evaluate(net.Parameters(), i);
+
+      arma::mat pointGradient;
+      net.Gradient(net.Parameters(), i, pointGradient);
+      gradient += pointGradient;
+    }
+
+    const double batchObjective = net.Evaluate(net.Parameters(), begin,
+        batchSize, true);
+    arma::mat batchGradient;
+    net.Gradient(net.Parameters(), begin, batchGradient, batchSize);
+
+    BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+    BOOST_REQUIRE_EQUAL(batchGradient.n_elem, gradient.n_elem);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      if (std::abs(gradient[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(batchGradient[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+    }
+
+    // Batch prediction should match the prediction of each point.
+    arma::mat predictions;
+    net.Predict(trainData, predictions);
+    BOOST_REQUIRE_EQUAL(predictions.n_cols, trainData.n_cols);
+    for (size_t i = 0; i < trainData.n_cols; ++i)
+    {
+      arma::mat point = trainData.col(i);
+      arma::mat prediction;
+      net.Predict(point, prediction);
+      for (size_t j = 0; j < prediction.n_elem; ++j)
+        BOOST_REQUIRE_EQUAL(predictions(j, i), prediction[j]);
+    }
+  }
+};
+
+/**
+ * Check the batch objective and gradient for a performance function that sums
+ * over the points (cross-entropy) and for one that takes their mean (mean
+ * squared error).
+ */
+BOOST_AUTO_TEST_CASE(BatchGradientTest)
+{
+  CheckBatchNetwork<CrossEntropyErrorFunction<> >(BatchGradientCheck());
+  CheckBatchNetwork<MeanSquaredErrorFunction>(BatchGradientCheck());
+}
+
+/**
+ * Passes through the activation arena, with batches of different sizes and
+ * mixed with predictions, should give the same results as the passes that
+ * allocate the activations, and the activations and deltas of a pass should
+ * stay in the same place as in the last pass of the same kind and shape.
+ */
+struct ActivationArenaCheck
+{
+  template<typename NetworkType, typename LayerTypes>
+  void operator()(NetworkType& net,
+                  LayerTypes& layers,
+                  arma::mat& trainData) const
+  {
+    // The first pass with each batch size allocates the activations, and
+    // shows the arena their shapes.
+    const size_t batchSizes[] = { 1, 7, 40, 3 };
+    std::vector<arma::mat> gradients(4);
+    std::vector<double> objectives(4);
+    for (size_t b = 0; b < 4; ++b)
+    {
+      net.Gradient(net.Parameters(), 0, gradients[b], batchSizes[b]);
+      objectives[b] = net.Evaluate(net.Parameters(), 0, batchSizes[b], false);
+    }
+
+    arma::mat predictions;
+    net.Predict(trainData, predictions);
+
+    // Every later pass uses the arena.
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      for (size_t b = 0; b < 4; ++b)
+      {
+        arma::mat batchGradient;
+        net.Gradient(net.Parameters(), 0, batchGradient, batchSizes[b]);
+        const double* outputMemory =
+            std::get<0>(layers).OutputParameter().memptr();
+        const double* hiddenDeltaMemory = std::get<3>(layers).Delta().memptr();
+        const double* outputDeltaMemory = std::get<5>(layers).Delta().memptr();
+        BOOST_REQUIRE_EQUAL(std::get<3>(layers).Delta().n_cols, batchSizes[b]);
+
+        // A prediction in between, even for an input of the same shape,
+        // doesn't move the buffers of the training pass.
+        arma::mat point = trainData.col(b);
+        arma::mat prediction;
+        net.Predict(point, prediction);
+        for (size_t j = 0; j < prediction.n_elem; ++j)
+          BOOST_REQUIRE_CLOSE(prediction[j], predictions(j, b), 1e-5);
+
+        net.Gradient(net.Parameters(), 0, batchGradient, batchSizes[b]);
+        BOOST_REQUIRE_EQUAL(std::get<0>(layers).OutputParameter().memptr(),
+            outputMemory);
+        BOOST_REQUIRE_EQUAL(std::get<3>(layers).Delta().memptr(),
+            hiddenDeltaMemory);
+        BOOST_REQUIRE_EQUAL(std::get<5>(layers).Delta().memptr(),
+            outputDeltaMemory);
+
+        BOOST_REQUIRE_CLOSE(net.Evaluate(net.Parameters(), 0, batchSizes[b],
+            false), objectives[b], 1e-5);
+
+        // The gradient of a batch is the sum of the gradients of its points.
+        arma::mat pointGradients = arma::zeros<arma::mat>(
+            gradients[b].n_rows, gradients[b].n_cols);
+        for (size_t i = 0; i < batchSizes[b]; ++i)
+        {
+          arma::mat pointGradient;
+          net.Gradient(net.Parameters(), i, pointGradient, 1);
+          pointGradients += pointGradient;
+        }
+
+        for (size_t i = 0; i < gradients[b].n_elem; ++i)
+        {
+          if (std::abs(gradients[b][i]) < 1e-8)
+          {
+            BOOST_REQUIRE_SMALL(batchGradient[i], 1e-8);
+            BOOST_REQUIRE_SMALL(pointGradients[i], 1e-8);
+          }
+          else
+          {
+            BOOST_REQUIRE_CLOSE(batchGradient[i], gradients[b][i], 1e-5);
+            BOOST_REQUIRE_CLOSE(pointGradients[i], gradients[b][i], 1e-5);
+          }
+        }
+
+        arma::mat arenaPredictions;
+        net.Predict(trainData, arenaPredictions);
+        for (size_t i = 0; i < predictions.n_elem; ++i)
+          BOOST_REQUIRE_CLOSE(arenaPredictions[i], predictions[i], 1e-5);
+      }
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(ActivationArenaTest)
+{
+  CheckBatchNetwork<CrossEntropyErrorFunction<> >(ActivationArenaCheck());
+}
+
+/**
+ * Make sure that predictions computed through an InferenceHandle from several
+ * threads at once are the same as those of the network itself.
+ */
+BOOST_AUTO_TEST_CASE(InferenceHandleTest)
+{
+  arma::mat trainData = arma::randu<arma::mat>(5, 60);
+  arma::mat trainLabels = arma::zeros<arma::mat>(3, 60);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    trainLabels(i % 3, i) = 1;
+
+  LinearLayer<> inputLayer(trainData.n_rows, 6);
+  BiasLayer<> inputBiasLayer(6);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+  DropoutLayer<> dropoutLayer;
+
+  LinearLayer<> hiddenLayer1(6, trainLabels.n_rows);
+  BiasLayer<> hiddenBiasLayer1(trainLabels.n_rows);
+  BaseLayer<LogisticFunction> outputLayer;
+
+  MulticlassClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+                          dropoutLayer, hiddenLayer1, hiddenBiasLayer1,
+                          outputLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  MiniBatchSGD<decltype(net)> opt(net, 10, 0.1, 200);
+  net.Train(trainData, trainLabels, opt);
+
+  CheckInferenceHandle(net, trainData);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
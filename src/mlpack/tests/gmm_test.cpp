@@ -8,6 +8,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -782,4 +783,97 @@ BOOST_AUTO_TEST_CASE(UseExistingModelTest)
 }
 
 
+/**
+ * Make sure that EM still assigns points whose likelihood under every
+ * component underflows to zero.  The E-step is done in log-space, so those
+ * points should go to the closest component, and the model should converge
+ * onto the data.  The dataset is large enough to be split into several blocks.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainUnderflowTest)
+{
+  arma::mat data(2, 5000);
+  data.cols(0, 2499) = arma::randn<arma::mat>(2, 2500);
+  data.cols(0, 2499) -= 200.0;
+  data.cols(2500, 4999) = arma::randn<arma::mat>(2, 2500);
+  data.cols(2500, 4999) += 200.0;
+
+  // Start far away from the data.  Every point has a likelihood of about
+  // exp(-40000) under each component.
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("-1 -1", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("1 1", "1 0; 0 1");
+  gmm.Weights() = "0.5 0.5";
+
+  const double likelihood = gmm.Train(data, 1, true);
+  BOOST_REQUIRE(std::isfinite(likelihood));
+
+  const arma::vec mean0 = arma::mean(data.cols(0, 2499), 1);
+  const arma::vec mean1 = arma::mean(data.cols(2500, 4999), 1);
+  const arma::mat cov0 = ccov(data.cols(0, 2499), 1 /* biased */);
+  const arma::mat cov1 = ccov(data.cols(2500, 4999), 1 /* biased */);
+
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[0], 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[1], 0.5, 1e-5);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Mean()[i], mean0[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(gmm.Component(1).Mean()[i], mean1[i], 1e-5);
+  }
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gmm.Component(0).Covariance()[i], cov0[i], 1e-3);
+    BOOST_REQUIRE_CLOSE(gmm.Component(1).Covariance()[i], cov1[i], 1e-3);
+  }
+}
+
+/**
+ * A DiagonalGMM should be trained to the same model as a GMM with the
+ * DiagonalConstraint, when both start from the same initial clustering.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
+{
+  const size_t dims = 10;
+  const size_t gaussians = 3;
+
+  arma::mat data = arma::randn<arma::mat>(dims, 3000);
+  data.cols(1000, 1999) *= 2.0;
+  data.cols(1000, 1999) += 8.0;
+  data.cols(2000, 2999) -= 8.0;
+
+  typedef EMFit<kmeans::KMeans<>, DiagonalConstraint> FullFit;
+  typedef EMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> DiagonalFit;
+
+  // Seed identically so that both start from the same clustering.
+  const size_t seed = std::time(NULL);
+  math::RandomSeed(seed);
+  GMM gmm(gaussians, dims);
+  const double likelihood = gmm.Train(data, 1, false, FullFit(50));
+
+  math::RandomSeed(seed);
+  DiagonalGMM diagGMM(gaussians, dims);
+  const double diagLikelihood = diagGMM.Train(data, 1, false,
+      DiagonalFit(50));
+
+  BOOST_REQUIRE_CLOSE(diagLikelihood, likelihood, 1e-5);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(diagGMM.Weights()[i], gmm.Weights()[i], 1e-5);
+    for (size_t d = 0; d < dims; ++d)
+    {
+      BOOST_REQUIRE_CLOSE(diagGMM.Component(i).Mean()[d],
+          gmm.Component(i).Mean()[d], 1e-5);
+      BOOST_REQUIRE_CLOSE(diagGMM.Component(i).Covariance()[d],
+          gmm.Component(i).Covariance()(d, d), 1e-5);
+    }
+  }
+
+  // The classifications should also be the same.
+  arma::Row<size_t> labels, diagLabels;
+  gmm.Classify(data, labels);
+  diagGMM.Classify(data, diagLabels);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(diagLabels[i], labels[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -5,6 +5,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/sparse_hmm.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -1164,5 +1165,200 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
+/**
+ * Make sure that an observation that is extremely unlikely under every state
+ * doesn't make the log-likelihood or the state probabilities degenerate; the
+ * Forward-Backward and Viterbi computations are done in log-space.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUnderflowTest)
+{
+  HMM<GaussianDistribution> hmm(2, GaussianDistribution(1));
+  hmm.Transition() = arma::mat("0.9 0.2; 0.1 0.8");
+  hmm.Emission()[0] = GaussianDistribution("0", "1");
+  hmm.Emission()[1] = GaussianDistribution("1", "1");
+
+  // The probability of 100 under either emission is about exp(-5000).
+  arma::mat obs("0.1 -0.2 100 0.9 1.1");
+
+  const double loglik = hmm.LogLikelihood(obs);
+  BOOST_REQUIRE(std::isfinite(loglik));
+
+  arma::mat stateLogProb, forwardLogProb, backwardLogProb;
+  arma::vec logScales;
+  const double estimateLoglik = hmm.LogEstimate(obs, stateLogProb,
+      forwardLogProb, backwardLogProb, logScales);
+  BOOST_REQUIRE_CLOSE(estimateLoglik, loglik, 1e-5);
+  BOOST_REQUIRE_CLOSE(arma::accu(logScales), loglik, 1e-5);
+
+  // The state probabilities at each time step should sum to 1.
+  for (size_t t = 0; t < obs.n_cols; ++t)
+    BOOST_REQUIRE_CLOSE(arma::accu(arma::exp(stateLogProb.col(t))), 1.0,
+        1e-5);
+
+  // The outlier is closer to the second state.
+  arma::Row<size_t> states;
+  const double viterbiLoglik = hmm.Predict(obs, states);
+  BOOST_REQUIRE(std::isfinite(viterbiLoglik));
+  BOOST_REQUIRE_LE(viterbiLoglik, loglik);
+  BOOST_REQUIRE_EQUAL(states[2], 1);
+}
+
+/**
+ * Make sure that decoding a batch of sequences gives the same results as
+ * decoding each sequence on its own.
+ */
+BOOST_AUTO_TEST_CASE(BatchPredictTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.2; 0.1 0.7 0.1; 0.1 0.2 0.7");
+  hmm.Emission()[0] = GaussianDistribution("0 0", "1 0; 0 1");
+  hmm.Emission()[1] = GaussianDistribution("3 0", "1 0.5; 0.5 1");
+  hmm.Emission()[2] = GaussianDistribution("0 3", "2 0; 0 1");
+
+  std::vector<arma::mat> sequences(20);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> trueStates;
+    hmm.Generate(10 + 7 * i, sequences[i], trueStates);
+  }
+
+  std::vector<arma::Row<size_t> > batchStates;
+  arma::vec logLikelihoods;
+  hmm.Predict(sequences, batchStates, logLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(batchStates.size(), sequences.size());
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    const double loglik = hmm.Predict(sequences[i], states);
+
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], loglik, 1e-5);
+    BOOST_REQUIRE_EQUAL(batchStates[i].n_elem, states.n_elem);
+    for (size_t t = 0; t < states.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(batchStates[i][t], states[t]);
+  }
+}
+
+/**
+ * Baum-Welch training accumulates the estimates of each sequence separately
+ * (and in parallel, if OpenMP is available), so the order of the sequences
+ * shouldn't change the trained model.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMTrainSequenceOrderTest)
+{
+  arma::vec initial("0.6 0.4");
+  arma::mat transition("0.8 0.3; 0.2 0.7");
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0] = DiscreteDistribution("0.7 0.2 0.1");
+  emission[1] = DiscreteDistribution("0.1 0.3 0.6");
+  HMM<DiscreteDistribution> generator(initial, transition, emission);
+
+  std::vector<arma::mat> sequences(200);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    generator.Generate(5 + (i % 23), sequences[i], states,
+        (size_t) math::RandInt(2));
+  }
+  std::vector<arma::mat> reversed(sequences.rbegin(), sequences.rend());
+
+  // Start both models from the same guess.
+  std::vector<DiscreteDistribution> guess(2);
+  guess[0] = DiscreteDistribution("0.5 0.3 0.2");
+  guess[1] = DiscreteDistribution("0.2 0.3 0.5");
+  HMM<DiscreteDistribution> hmm(arma::vec("0.5 0.5"),
+      arma::mat("0.6 0.4; 0.4 0.6"), guess);
+  HMM<DiscreteDistribution> hmmReversed(hmm);
+
+  hmm.Train(sequences);
+  hmmReversed.Train(reversed);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(hmm.Initial()[i], hmmReversed.Initial()[i], 1e-3);
+    for (size_t j = 0; j < 2; ++j)
+      BOOST_REQUIRE_CLOSE(hmm.Transition()(i, j),
+          hmmReversed.Transition()(i, j), 1e-3);
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_CLOSE(hmm.Emission()[i].Probabilities()[j],
+          hmmReversed.Emission()[i].Probabilities()[j], 1e-3);
+  }
+}
+
+/**
+ * A SparseHMM should give the same results as an HMM with the same dense
+ * transition matrix.  Use a left-to-right model, where every state can only go
+ * to itself or the next state.
+ */
+BOOST_AUTO_TEST_CASE(SparseHMMMatchesDenseHMMTest)
+{
+  const size_t states = 6;
+  arma::mat transition(states, states, arma::fill::zeros);
+  for (size_t i = 0; i < states - 1; ++i)
+  {
+    transition(i, i) = 0.7;
+    transition(i + 1, i) = 0.3;
+  }
+  transition(states - 1, states - 1) = 1.0;
+
+  arma::vec initial(states, arma::fill::zeros);
+  initial[0] = 1.0;
+
+  std::vector<GaussianDistribution> emission(states);
+  for (size_t i = 0; i < states; ++i)
+    emission[i] = GaussianDistribution(arma::vec(1).fill(2.0 * i),
+        arma::mat(1, 1).fill(1.0));
+
+  HMM<GaussianDistribution> dense(initial, transition, emission);
+  SparseHMM<GaussianDistribution> sparse(initial, arma::sp_mat(transition),
+      emission);
+
+  std::vector<arma::mat> sequences(30);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> trueStates;
+    dense.Generate(20 + i, sequences[i], trueStates);
+  }
+
+  // The sparse and dense models should agree on the same sequences.
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(sparse.LogLikelihood(sequences[i]),
+        dense.LogLikelihood(sequences[i]), 1e-5);
+
+    arma::Row<size_t> denseStates, sparseStates;
+    const double denseLoglik = dense.Predict(sequences[i], denseStates);
+    const double sparseLoglik = sparse.Predict(sequences[i], sparseStates);
+    BOOST_REQUIRE_CLOSE(sparseLoglik, denseLoglik, 1e-5);
+    BOOST_REQUIRE_EQUAL(sparseStates.n_elem, denseStates.n_elem);
+    for (size_t t = 0; t < denseStates.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(sparseStates[t], denseStates[t]);
+  }
+
+  // Now train both models from the same starting point.  The zero transitions
+  // must stay zero, and the rest should be the same as the dense estimates.
+  dense.Train(sequences);
+  sparse.Train(sequences);
+
+  BOOST_REQUIRE_LE(sparse.Transition().n_nonzero, 2 * states - 1);
+  const arma::mat sparseTransition(sparse.Transition());
+  for (size_t i = 0; i < states; ++i)
+  {
+    BOOST_REQUIRE_SMALL(std::abs(sparse.Initial()[i] - dense.Initial()[i]),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(sparse.Emission()[i].Mean()[0],
+        dense.Emission()[i].Mean()[0], 1e-3);
+    for (size_t j = 0; j < states; ++j)
+    {
+      if (transition(i, j) == 0.0)
+        BOOST_REQUIRE_EQUAL(sparseTransition(i, j), 0.0);
+      else
+        BOOST_REQUIRE_SMALL(sparseTransition(i, j) - dense.Transition()(i, j),
+            1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
@@ -9,9 +9,12 @@
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus.hpp>
+#include <mlpack/methods/kmeans/scalable_kmeans_plus_plus.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
@@ -568,6 +571,121 @@ BOOST_AUTO_TEST_CASE(HamerlyTest)
   }
 }
 
+/**
+ * Make sure that the blocked assignment of points used by NaiveKMeans in high
+ * dimensions gives exactly the same clusters as evaluating every distance, even
+ * when the points are far from the origin and the centroids are close to each
+ * other, where the blocked distances are least accurate.
+ */
+BOOST_AUTO_TEST_CASE(NaiveKMeansBlockAssignmentTest)
+{
+  arma::mat dataset(40, 3000);
+  dataset.randu();
+  dataset += 1000.0;
+
+  arma::mat centroids = dataset.cols(0, 19);
+  centroids.col(1) = centroids.col(0) + 1e-6;
+
+  arma::mat expectedCentroids(centroids.n_rows, centroids.n_cols,
+      arma::fill::zeros);
+  arma::Col<size_t> expectedCounts(centroids.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t closestCluster = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    expectedCentroids.col(closestCluster) += dataset.col(i);
+    ++expectedCounts[closestCluster];
+  }
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  naive.Iterate(centroids, newCentroids, counts);
+
+  BOOST_REQUIRE_EQUAL(counts.n_elem, centroids.n_cols);
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(counts[j], expectedCounts[j]);
+    if (expectedCounts[j] == 0)
+      continue;
+
+    for (size_t d = 0; d < centroids.n_rows; ++d)
+      BOOST_REQUIRE_CLOSE(newCentroids(d, j),
+          expectedCentroids(d, j) / expectedCounts[j], 1e-8);
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means finds the three well-separated clusters of
+ * the simple dataset, and that the centroids are close to the means of the
+ * clusters.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  const arma::mat data = trans(kMeansData);
+
+  // Start with one point of each class, so the result doesn't depend on the
+  // initialization.
+  arma::mat centroids(2, 3);
+  centroids.col(0) = data.col(2);
+  centroids.col(1) = data.col(15);
+  centroids.col(2) = data.col(25);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(300);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 13; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 0);
+  for (size_t i = 13; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 1);
+  for (size_t i = 20; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 2);
+
+  // Each centroid is the mean of many samples of its cluster, so it should be
+  // near the true mean.
+  const size_t begins[] = { 0, 13, 20 };
+  const size_t ends[] = { 12, 19, 29 };
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const arma::vec mean = arma::mean(data.cols(begins[c], ends[c]), 1);
+    BOOST_REQUIRE_LT(EuclideanDistance::Evaluate(mean, centroids.col(c)), 0.1);
+  }
+
+  // Each iteration only evaluates the distances of the batch.
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> miniBatch(data, metric, 10);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  miniBatch.Iterate(centroids, newCentroids, counts);
+  BOOST_REQUIRE_EQUAL(miniBatch.DistanceCalculations(), 10 * 3 + 3);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), 10);
+  miniBatch.Iterate(newCentroids, centroids, counts);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), 20);
+
+  // Killing a cluster must not reset the counts of the other clusters.
+  const arma::Col<size_t> oldCounts = counts;
+  centroids.col(2).fill(DBL_MAX);
+  miniBatch.Iterate(centroids, newCentroids, counts);
+  BOOST_REQUIRE_EQUAL(counts[2], 0);
+  BOOST_REQUIRE_GE(counts[0], oldCounts[0]);
+  BOOST_REQUIRE_GE(counts[1], oldCounts[1]);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), oldCounts[0] + oldCounts[1] + 10);
+}
+
 BOOST_AUTO_TEST_CASE(PellegMooreTest)
 {
   const size_t trials = 5;
@@ -666,6 +784,49 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Make sure that the dual-tree algorithm, which refits its centroid tree
+ * instead of rebuilding it, matches the naive algorithm in every iteration, and
+ * that it records the base cases, scores, and pruned points of each iteration.
+ */
+BOOST_AUTO_TEST_CASE(DTNNRefitIterationTest)
+{
+  arma::mat dataset(5, 2000);
+  dataset.randu();
+  arma::mat centroids = dataset.cols(0, 29);
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, metric);
+  DefaultDualTreeKMeans<EuclideanDistance, arma::mat> dtnn(dataset, metric);
+
+  arma::mat naiveCentroids(centroids), dtnnCentroids(centroids);
+  arma::mat newNaiveCentroids, newDtnnCentroids;
+  arma::Col<size_t> naiveCounts, dtnnCounts;
+  const size_t iterations = 8;
+  for (size_t it = 0; it < iterations; ++it)
+  {
+    naive.Iterate(naiveCentroids, newNaiveCentroids, naiveCounts);
+    dtnn.Iterate(dtnnCentroids, newDtnnCentroids, dtnnCounts);
+
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+      BOOST_REQUIRE_EQUAL(naiveCounts[c], dtnnCounts[c]);
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(newNaiveCentroids[i], newDtnnCentroids[i], 1e-5);
+
+    naiveCentroids = newNaiveCentroids;
+    dtnnCentroids = newDtnnCentroids;
+  }
+
+  BOOST_REQUIRE_EQUAL(dtnn.IterationBaseCases().size(), iterations);
+  BOOST_REQUIRE_EQUAL(dtnn.IterationScores().size(), iterations);
+  BOOST_REQUIRE_EQUAL(dtnn.IterationPrunedPoints().size(), iterations);
+  for (size_t it = 0; it < iterations; ++it)
+  {
+    BOOST_REQUIRE_GT(dtnn.IterationBaseCases()[it], 0);
+    BOOST_REQUIRE_LE(dtnn.IterationPrunedPoints()[it], dataset.n_cols);
+  }
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -700,4 +861,123 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that k-means++ chooses distinct points of the dataset, never
+ * chooses points with zero weight, and can be used to cluster the simple
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 200);
+  arma::mat centroids;
+  KMeansPlusPlus::Cluster(dataset, 20, centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 20);
+
+  // Each centroid is a point of the dataset, and no point is chosen twice.
+  std::vector<bool> chosen(dataset.n_cols, false);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    size_t j;
+    for (j = 0; j < dataset.n_cols; ++j)
+      if (EuclideanDistance::Evaluate(centroids.col(c), dataset.col(j)) == 0.0)
+        break;
+
+    BOOST_REQUIRE_LT(j, dataset.n_cols);
+    BOOST_REQUIRE(!chosen[j]);
+    chosen[j] = true;
+  }
+
+  // Points with zero weight are never chosen.
+  arma::vec weights(dataset.n_cols, arma::fill::zeros);
+  weights.subvec(0, 9).fill(1.0);
+  KMeansPlusPlus::Cluster(dataset, weights, 10, centroids);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    bool found = false;
+    for (size_t j = 0; j < 10; ++j)
+      if (EuclideanDistance::Evaluate(centroids.col(c), dataset.col(j)) == 0.0)
+        found = true;
+
+    BOOST_REQUIRE(found);
+  }
+
+  // Now cluster the simple dataset.
+  KMeans<EuclideanDistance, KMeansPlusPlus> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster((arma::mat) trans(kMeansData), 3, assignments);
+
+  for (size_t i = 1; i < 13; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[0]);
+  for (size_t i = 14; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[13]);
+  for (size_t i = 21; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[20]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[13]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[20]);
+  BOOST_REQUIRE_NE(assignments[13], assignments[20]);
+}
+
+/**
+ * Make sure that k-means|| chooses distinct points of the dataset, even when
+ * the dataset has exactly as many distinct points as clusters.
+ */
+BOOST_AUTO_TEST_CASE(ScalableKMeansPlusPlusTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat centroids;
+  ScalableKMeansPlusPlus kmpp(2.0, 3);
+  kmpp.Cluster(dataset, 25, centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 25);
+
+  std::vector<bool> chosen(dataset.n_cols, false);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    size_t j;
+    for (j = 0; j < dataset.n_cols; ++j)
+      if (EuclideanDistance::Evaluate(centroids.col(c), dataset.col(j)) == 0.0)
+        break;
+
+    BOOST_REQUIRE_LT(j, dataset.n_cols);
+    BOOST_REQUIRE(!chosen[j]);
+    chosen[j] = true;
+  }
+
+  // Four distinct points, each repeated many times.
+  arma::mat repeated = arma::repmat(arma::randu<arma::mat>(3, 4), 1, 50);
+  kmpp.Cluster(repeated, 4, centroids);
+
+  std::vector<bool> found(4, false);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    for (size_t j = 0; j < 4; ++j)
+      if (EuclideanDistance::Evaluate(centroids.col(c), repeated.col(j)) == 0.0)
+        found[j] = true;
+  }
+  for (size_t j = 0; j < 4; ++j)
+    BOOST_REQUIRE(found[j]);
+
+  // With a single sparse round, the candidates are often copies of fewer than
+  // four distinct points; k-means|| must then still find all four.
+  ScalableKMeansPlusPlus sparse(0.5, 1);
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    sparse.Cluster(repeated, 4, centroids);
+
+    std::vector<bool> sparseFound(4, false);
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      for (size_t j = 0; j < 4; ++j)
+        if (EuclideanDistance::Evaluate(centroids.col(c), repeated.col(j)) ==
+            0.0)
+          sparseFound[j] = true;
+    }
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_REQUIRE(sparseFound[j]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1148,4 +1148,178 @@ BOOST_AUTO_TEST_CASE(NeighborPtrDeleteTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * Make sure that parallel dual-tree search gives the same results as naive
+ * search, for both the bichromatic and monochromatic cases.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  arma::mat queryset = arma::randu<arma::mat>(5, 1000);
+
+  KNN knn(dataset, false, false, 0, EuclideanDistance(), true);
+  KNN naive(dataset, true);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(queryset, 10, neighborsTree, distancesTree);
+  naive.Search(queryset, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that parallel single-tree search gives the same results as naive
+ * search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  KNN knn(dataset, false, true, 0, EuclideanDistance(), true);
+  KNN naive(dataset, true);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that compacting the reference tree does not change search results.
+ */
+BOOST_AUTO_TEST_CASE(CompactTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  std::vector<size_t> oldFromNewReferences;
+  KNN::Tree tree(dataset, oldFromNewReferences);
+  KNN knn(&tree);
+
+  arma::Mat<size_t> neighbors, compactNeighbors;
+  arma::mat distances, compactDistances;
+
+  knn.Search(10, neighbors, distances);
+
+  // The root stays in place, so the KNN object can still use the tree.
+  tree.Compact();
+  BOOST_REQUIRE(tree.IsCompact());
+  knn.Search(10, compactNeighbors, compactDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], compactNeighbors[i]);
+    BOOST_REQUIRE_EQUAL(distances[i], compactDistances[i]);
+  }
+}
+
+/**
+ * Make sure that the blocked base cases used for high-dimensional data give
+ * the same results as naive search, for both nearest and furthest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(BlockedBaseCaseTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(30, 1000);
+  arma::mat queryset = arma::randu<arma::mat>(30, 500);
+
+  KNN knn(dataset);
+  KNN naiveKnn(dataset, true);
+  KFN kfn(dataset);
+  KFN naiveKfn(dataset, true);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    if (trial == 0)
+    {
+      knn.Search(queryset, 5, neighborsTree, distancesTree);
+      naiveKnn.Search(queryset, 5, neighborsNaive, distancesNaive);
+    }
+    else if (trial == 1)
+    {
+      knn.Search(5, neighborsTree, distancesTree);
+      naiveKnn.Search(5, neighborsNaive, distancesNaive);
+    }
+    else if (trial == 2)
+    {
+      kfn.Search(queryset, 5, neighborsTree, distancesTree);
+      naiveKfn.Search(queryset, 5, neighborsNaive, distancesNaive);
+    }
+    else
+    {
+      kfn.Search(5, neighborsTree, distancesTree);
+      naiveKfn.Search(5, neighborsNaive, distancesNaive);
+    }
+
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+      BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that search on float data gives the same results as naive search,
+ * with both kd-trees and ball trees.
+ */
+BOOST_AUTO_TEST_CASE(FloatSearchTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(5, 1000);
+  arma::fmat queryset = arma::randu<arma::fmat>(5, 500);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat>
+      FloatKNN;
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      BallTree> FloatBallKNN;
+
+  FloatKNN naive(dataset, true);
+  FloatKNN dualTree(dataset);
+  FloatKNN singleTree(dataset, false, true);
+  FloatBallKNN ballTree(dataset);
+
+  arma::Mat<size_t> neighborsNaive, neighborsTree;
+  arma::mat distancesNaive, distancesTree;
+  naive.Search(queryset, 5, neighborsNaive, distancesNaive);
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    if (trial == 0)
+      dualTree.Search(queryset, 5, neighborsTree, distancesTree);
+    else if (trial == 1)
+      singleTree.Search(queryset, 5, neighborsTree, distancesTree);
+    else
+      ballTree.Search(queryset, 5, neighborsTree, distancesTree);
+
+    for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+      BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-3);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
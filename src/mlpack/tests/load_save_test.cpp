@@ -437,6 +437,176 @@ BOOST_AUTO_TEST_CASE(SaveArmaBinaryTest)
   remove("test_file.bin");
 }
 
+/**
+ * Make sure mappable binary data is saved and loaded without transposing.
+ */
+BOOST_AUTO_TEST_CASE(SaveMappedBinaryTest)
+{
+  arma::mat test = "1 5;"
+                   "2 6;"
+                   "3 7;"
+                   "4 8;";
+
+  BOOST_REQUIRE(data::Save("test_file.mbin", test) == true);
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test_file.mbin", loaded) == true);
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 2);
+
+  for (int i = 0; i < 8; i++)
+    BOOST_REQUIRE_CLOSE(loaded[i], (double) (i + 1), 1e-5);
+
+  // Remove the file.
+  remove("test_file.mbin");
+}
+
+/**
+ * Make sure a MappedMatrix maps the data correctly, and that modifying it does
+ * not modify the file.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixTest)
+{
+  arma::mat test = arma::randu<arma::mat>(10, 1000);
+  BOOST_REQUIRE(data::Save("test_file.mbin", test) == true);
+
+  MappedMatrix<double> mapped;
+  BOOST_REQUIRE(data::Load("test_file.mbin", mapped) == true);
+  BOOST_REQUIRE(mapped.IsMapped());
+
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 10);
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 1000);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(mapped.Matrix()[i], test[i]);
+
+  mapped.Matrix().zeros();
+
+  MappedMatrix<double> other("test_file.mbin");
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(other.Matrix()[i], test[i]);
+
+  // Moving the mapping should keep the matrix.
+  MappedMatrix<double> moved(std::move(other));
+  BOOST_REQUIRE(!other.IsMapped());
+  BOOST_REQUIRE_EQUAL(other.Matrix().n_elem, 0);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(moved.Matrix()[i], test[i]);
+
+  moved.Unmap();
+  BOOST_REQUIRE(!moved.IsMapped());
+  BOOST_REQUIRE_EQUAL(moved.Matrix().n_elem, 0);
+
+  // Remove the file.
+  remove("test_file.mbin");
+}
+
+/**
+ * Make sure mappable binary data can't be loaded with the wrong element type,
+ * and that other formats can't be mapped.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixFailureTest)
+{
+  arma::mat test = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE(data::Save("test_file.mbin", test) == true);
+  BOOST_REQUIRE(data::Save("test_file.bin", test) == true);
+
+  Log::Warn.ignoreInput = true;
+
+  MappedMatrix<float> wrongType;
+  BOOST_REQUIRE(data::Load("test_file.mbin", wrongType) == false);
+  BOOST_REQUIRE(!wrongType.IsMapped());
+
+  arma::fmat wrongTypeMat;
+  BOOST_REQUIRE(data::Load("test_file.mbin", wrongTypeMat) == false);
+
+  MappedMatrix<double> wrongFormat;
+  BOOST_REQUIRE(data::Load("test_file.bin", wrongFormat) == false);
+  BOOST_REQUIRE(!wrongFormat.IsMapped());
+
+  BOOST_REQUIRE_THROW(MappedMatrix<double>("nonexistent.mbin"),
+      std::runtime_error);
+
+  Log::Warn.ignoreInput = false;
+
+  // Remove the files.
+  remove("test_file.mbin");
+  remove("test_file.bin");
+}
+
+/**
+ * Stream a CSV in chunks, and make sure the chunks make up the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(StreamingLoaderTest)
+{
+  arma::mat test = arma::randu<arma::mat>(4, 1003);
+  BOOST_REQUIRE(data::Save("test_file.csv", test) == true);
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test_file.csv", loaded) == true);
+
+  StreamingLoader loader("test_file.csv", 100);
+  arma::mat chunk;
+  size_t points = 0;
+  size_t chunks = 0;
+  while (loader.Next(chunk) > 0)
+  {
+    BOOST_REQUIRE_EQUAL(chunk.n_rows, 4);
+    BOOST_REQUIRE_LE(chunk.n_cols, 100);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      for (size_t d = 0; d < 4; ++d)
+        BOOST_REQUIRE_EQUAL(chunk(d, i), loaded(d, points + i));
+
+    points += chunk.n_cols;
+    ++chunks;
+  }
+
+  BOOST_REQUIRE_EQUAL(points, 1003);
+  BOOST_REQUIRE_EQUAL(chunks, 11);
+  BOOST_REQUIRE_EQUAL(loader.PointsRead(), 1003);
+  BOOST_REQUIRE_EQUAL(loader.Dimensionality(), 4);
+
+  // Once the stream is exhausted, it stays that way.
+  BOOST_REQUIRE_EQUAL(loader.Next(chunk), 0);
+  BOOST_REQUIRE_EQUAL(chunk.n_cols, 0);
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
+/**
+ * Stream mappable binary data in chunks.
+ */
+BOOST_AUTO_TEST_CASE(StreamingLoaderMappedTest)
+{
+  arma::mat test = arma::randu<arma::mat>(3, 250);
+  BOOST_REQUIRE(data::Save("test_file.mbin", test) == true);
+
+  StreamingLoader loader("test_file.mbin", 100);
+  BOOST_REQUIRE_EQUAL(loader.Dimensionality(), 3);
+
+  arma::mat chunk;
+  size_t points = 0;
+  while (loader.Next(chunk) > 0)
+  {
+    for (size_t i = 0; i < chunk.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(chunk[i], test[3 * points + i]);
+    points += chunk.n_cols;
+  }
+  BOOST_REQUIRE_EQUAL(points, 250);
+
+  // The element type must match.
+  StreamingLoader floatLoader("test_file.mbin", 100);
+  arma::fmat floatChunk;
+  BOOST_REQUIRE_THROW(floatLoader.Next(floatChunk), std::runtime_error);
+
+  BOOST_REQUIRE_THROW(StreamingLoader("test_file.bin", 100),
+      std::runtime_error);
+
+  // Remove the file.
+  remove("test_file.mbin");
+}
+
 /**
  * Make sure raw_binary is loaded correctly.
  */
@@ -1403,6 +1573,151 @@ BOOST_AUTO_TEST_CASE(HarderKeonTest)
   BOOST_REQUIRE_EQUAL(ntInfo.NumMappings(3), 3);
 }
 
+/**
+ * Make sure LoadCSV::ParseNumber() gives exactly the same result as strtod(),
+ * for numbers that take both the fast path and the slow path.
+ */
+BOOST_AUTO_TEST_CASE(ParseNumberTest)
+{
+  char buffer[128];
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    const double x = math::RandNormal() *
+        std::pow(10.0, math::RandInt(-40, 40));
+    const int precision = math::RandInt(1, 18);
+    if (i % 2 == 0)
+      snprintf(buffer, 128, "%.*g", precision, x);
+    else
+      snprintf(buffer, 128, "%.*f", precision, x);
+
+    double value;
+    BOOST_REQUIRE(LoadCSV::ParseNumber(buffer, buffer + strlen(buffer),
+        value));
+    BOOST_REQUIRE_EQUAL(value, std::strtod(buffer, NULL));
+  }
+
+  const std::string bad[] = { "", "-", ".", "e5", "1e", "1.5abc", "--1" };
+  for (size_t i = 0; i < 7; ++i)
+  {
+    double value;
+    BOOST_REQUIRE(!LoadCSV::ParseNumber(bad[i].data(),
+        bad[i].data() + bad[i].size(), value));
+  }
+}
+
+/**
+ * Blank lines, quoted fields, carriage returns and short lines should all be
+ * handled.
+ */
+BOOST_AUTO_TEST_CASE(IrregularCSVLoadTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, \"2\", 3\r\n";
+  f << "\n";
+  f << "   \n";
+  f << "4, 5" << endl;
+  f << "\"6\",, 1e1" << endl;
+  f.close();
+
+  arma::mat dataset;
+  BOOST_REQUIRE(data::Load("test.csv", dataset) == true);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 3);
+
+  BOOST_REQUIRE_CLOSE(dataset(0, 0), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(1, 0), 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(2, 0), 3.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(0, 1), 4.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(1, 1), 5.0, 1e-5);
+  BOOST_REQUIRE_SMALL(dataset(2, 1), 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(0, 2), 6.0, 1e-5);
+  BOOST_REQUIRE_SMALL(dataset(1, 2), 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(2, 2), 10.0, 1e-5);
+
+  // With a DatasetInfo, a quoted string holding a comma is one field.
+  f.open("test.csv", fstream::out);
+  f << "1, \"hello, world\"" << endl;
+  f << "2, goodbye" << endl;
+  f.close();
+
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info) == true);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 2);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 1), "hello, world");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1, 1), "goodbye");
+
+  remove("test.csv");
+}
+
+/**
+ * A non-numeric field in a file loaded without a DatasetInfo should make the
+ * load fail.
+ */
+BOOST_AUTO_TEST_CASE(NonNumericCSVLoadTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, hello, 6" << endl;
+  f.close();
+
+  arma::mat dataset;
+  Log::Warn.ignoreInput = true;
+  BOOST_REQUIRE(data::Load("test.csv", dataset) == false);
+  Log::Warn.ignoreInput = false;
+
+  remove("test.csv");
+}
+
+/**
+ * Load a CSV large enough to be split between threads, and make sure every
+ * number is read exactly and that the categorical mappings are made in the
+ * order the strings appear in the file.
+ */
+BOOST_AUTO_TEST_CASE(LargeCSVLoadTest)
+{
+  arma::mat points(5, 20000, arma::fill::randn);
+  points *= 1000.0;
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f.precision(17);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    for (size_t d = 0; d < points.n_rows; ++d)
+      f << points(d, i) << ", ";
+    f << "class" << ((points.n_cols - i) % 7) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info) == true);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    for (size_t d = 0; d < points.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(dataset(d, i), points(d, i));
+
+    // The labels cycle, so each is mapped to the line it first appears on.
+    BOOST_REQUIRE_EQUAL(dataset(5, i), (double) (i % 7));
+  }
+
+  BOOST_REQUIRE_EQUAL(info.NumMappings(5), 7);
+  for (size_t d = 0; d < 5; ++d)
+    BOOST_REQUIRE(info.Type(d) == Datatype::numeric);
+
+  remove("test.csv");
+}
+
 /**
  * A simple ARFF load test.  Two attributes, both numeric.
  */
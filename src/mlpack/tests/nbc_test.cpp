@@ -285,4 +285,102 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Training incrementally on chunks of the dataset should give the same model as
+ * training on the whole dataset at once.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedIncrementalTrainTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes, false);
+  NaiveBayesClassifier<> nbcTrain(trainData.n_rows, classes);
+  for (size_t i = 0; i < trainData.n_cols; i += 7)
+  {
+    const size_t end = std::min((size_t) trainData.n_cols, i + 7) - 1;
+    nbcTrain.Train(trainData.cols(i, end), labels.subvec(i, end), true);
+  }
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    if (std::abs(nbc.Means()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Means()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcTrain.Means()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+  {
+    if (std::abs(nbc.Variances()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Variances()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcTrain.Variances()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    if (std::abs(nbc.Probabilities()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Probabilities()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcTrain.Probabilities()[i],
+          1e-5);
+  }
+}
+
+/**
+ * Classify() works on blocks of points in parallel; make sure that the labels
+ * of a dataset spanning several blocks match the labels found one point at a
+ * time.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierBatchClassifyTest)
+{
+  const size_t classes = 4;
+  arma::mat trainData(10, 2000);
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    labels[i] = i % classes;
+    trainData.col(i) = arma::randn<arma::vec>(10) + 1.5 * labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes, false);
+
+  arma::mat testData(10, 3500);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    testData.col(i) = arma::randn<arma::vec>(10) + 1.5 * (i % classes);
+
+  arma::Row<size_t> results;
+  nbc.Classify(testData, results);
+  BOOST_REQUIRE_EQUAL(results.n_elem, testData.n_cols);
+
+  for (size_t j = 0; j < testData.n_cols; ++j)
+  {
+    arma::vec logLikelihoods(classes);
+    for (size_t i = 0; i < classes; ++i)
+    {
+      logLikelihoods[i] = std::log(nbc.Probabilities()[i]);
+      for (size_t k = 0; k < testData.n_rows; ++k)
+      {
+        const double diff = testData(k, j) - nbc.Means()(k, i);
+        logLikelihoods[i] -= 0.5 * (std::log(2 * M_PI *
+            nbc.Variances()(k, i)) + diff * diff / nbc.Variances()(k, i));
+      }
+    }
+
+    arma::uword label;
+    logLikelihoods.max(label);
+    BOOST_REQUIRE_EQUAL(results[j], label);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -591,6 +591,134 @@ BOOST_AUTO_TEST_CASE(SingleTreeVsNaive)
   }
 }
 
+/**
+ * Test parallel single-tree range search against naive search, for both the
+ * bichromatic and monochromatic cases.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryset = arma::randu<arma::mat>(3, 500);
+
+  RangeSearch<> single(dataset, false, true, EuclideanDistance(), true);
+  RangeSearch<> naive(dataset, true);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    vector<vector<size_t>> neighborsSingle, neighborsNaive;
+    vector<vector<double>> distancesSingle, distancesNaive;
+    if (trial == 0)
+    {
+      single.Search(queryset, Range(0.1, 0.3), neighborsSingle,
+          distancesSingle);
+      naive.Search(queryset, Range(0.1, 0.3), neighborsNaive, distancesNaive);
+    }
+    else
+    {
+      single.Search(Range(0.1, 0.3), neighborsSingle, distancesSingle);
+      naive.Search(Range(0.1, 0.3), neighborsNaive, distancesNaive);
+    }
+
+    vector<vector<pair<double, size_t>>> sortedTree, sortedNaive;
+    SortResults(neighborsSingle, distancesSingle, sortedTree);
+    SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+    BOOST_REQUIRE_EQUAL(sortedTree.size(), sortedNaive.size());
+    for (size_t i = 0; i < sortedTree.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+      for (size_t j = 0; j < sortedTree[i].size(); j++)
+      {
+        BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+        BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+            1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the blocked base cases used for high-dimensional data give
+ * the same results as naive search.
+ */
+BOOST_AUTO_TEST_CASE(BlockedBaseCaseTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(30, 1000);
+  arma::mat queryset = arma::randu<arma::mat>(30, 500);
+
+  RangeSearch<> rs(dataset);
+  RangeSearch<> naive(dataset, true);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    vector<vector<size_t>> neighborsTree, neighborsNaive;
+    vector<vector<double>> distancesTree, distancesNaive;
+    if (trial == 0)
+    {
+      rs.Search(queryset, Range(1.5, 2.0), neighborsTree, distancesTree);
+      naive.Search(queryset, Range(1.5, 2.0), neighborsNaive, distancesNaive);
+    }
+    else
+    {
+      rs.Search(Range(1.5, 2.0), neighborsTree, distancesTree);
+      naive.Search(Range(1.5, 2.0), neighborsNaive, distancesNaive);
+    }
+
+    vector<vector<pair<double, size_t>>> sortedTree, sortedNaive;
+    SortResults(neighborsTree, distancesTree, sortedTree);
+    SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+    BOOST_REQUIRE_EQUAL(sortedTree.size(), sortedNaive.size());
+    for (size_t i = 0; i < sortedTree.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+      for (size_t j = 0; j < sortedTree[i].size(); j++)
+      {
+        BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+        BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+            1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that range search on float data gives the same results as naive
+ * search.
+ */
+BOOST_AUTO_TEST_CASE(FloatRangeSearchTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(3, 1000);
+  arma::fmat queryset = arma::randu<arma::fmat>(3, 500);
+
+  RangeSearch<EuclideanDistance, arma::fmat> rs(dataset);
+  RangeSearch<EuclideanDistance, arma::fmat> naive(dataset, true);
+
+  vector<vector<size_t>> neighborsTree, neighborsNaive;
+  vector<vector<double>> distancesTree, distancesNaive;
+  rs.Search(queryset, Range(0.1, 0.3), neighborsTree, distancesTree);
+  naive.Search(queryset, Range(0.1, 0.3), neighborsNaive, distancesNaive);
+
+  vector<vector<pair<double, size_t>>> sortedTree, sortedNaive;
+  SortResults(neighborsTree, distancesTree, sortedTree);
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  BOOST_REQUIRE_EQUAL(sortedTree.size(), sortedNaive.size());
+  for (size_t i = 0; i < sortedTree.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+    for (size_t j = 0; j < sortedTree[i].size(); j++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+      BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+          1e-3);
+    }
+  }
+}
+
 /**
  * Ensure that dual tree range search with cover trees works by comparing
  * with the kd-tree implementation.
@@ -814,6 +814,133 @@ BOOST_AUTO_TEST_CASE(RStarTreeSplitTest)
       0.9, 1e-15);
 }
 
+/**
+ * Check that a bulk-loaded tree with the given packing strategy is valid and
+ * gives the same nearest neighbors as naive search.
+ */
+template<typename TreeType>
+void CheckBulkLoadedTree(const BulkLoadType bulkLoad)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1003); // 1003 points in 8 dimensions.
+
+  TreeType tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1003);
+
+  CheckSync(tree);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  // The tree should be fully packed: 51 leaves, then 11 and 3 non-leaf nodes,
+  // and the root.
+  BOOST_REQUIRE_EQUAL(tree.TreeSize(), 1 + 3 + 11 + 51);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      RTree> knn1(&tree, true);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, true, true);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Make sure STR bulk-loading builds a valid, fully packed tree.
+BOOST_AUTO_TEST_CASE(STRBulkLoadTest)
+{
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  CheckBulkLoadedTree<TreeType>(STR_PACKING);
+}
+
+/**
+ * Collect the leaves of the given tree.
+ */
+template<typename TreeType>
+void GetLeaves(const TreeType& tree, std::vector<const TreeType*>& leaves)
+{
+  if (tree.IsLeaf())
+    leaves.push_back(&tree);
+
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    GetLeaves(tree.Child(i), leaves);
+}
+
+// The leaves of an STR bulk-loaded tree should be tiles that don't overlap,
+// which only holds if the leaves are cut at the slab boundaries.
+BOOST_AUTO_TEST_CASE(STRBulkLoadTilingTest)
+{
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  arma::mat dataset;
+  dataset.randu(2, 1003); // 1003 points in 2 dimensions.
+
+  TreeType tree(dataset, STR_PACKING, 20, 6, 5, 2);
+
+  std::vector<const TreeType*> leaves;
+  GetLeaves(tree, leaves);
+  BOOST_REQUIRE_EQUAL(leaves.size(), 51);
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    for (size_t j = i + 1; j < leaves.size(); ++j)
+    {
+      bool disjoint = false;
+      for (size_t d = 0; d < 2; ++d)
+      {
+        if (std::min(leaves[i]->Bound()[d].Hi(), leaves[j]->Bound()[d].Hi()) <=
+            std::max(leaves[i]->Bound()[d].Lo(), leaves[j]->Bound()[d].Lo()))
+          disjoint = true;
+      }
+
+      BOOST_REQUIRE(disjoint);
+    }
+  }
+}
+
+// Make sure Hilbert bulk-loading builds a valid, fully packed tree.
+BOOST_AUTO_TEST_CASE(HilbertBulkLoadTest)
+{
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  CheckBulkLoadedTree<TreeType>(HILBERT_PACKING);
+}
+
+// A bulk-loaded tree should still support point deletion.
+BOOST_AUTO_TEST_CASE(BulkLoadPointDeletionTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, STR_PACKING, 20, 6, 5, 2);
+
+  for (size_t i = 0; i < 50; i++)
+    BOOST_REQUIRE(tree.DeletePoint(999 - i));
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 950);
+  CheckContainment(tree);
+  CheckSync(tree);
+  CheckHierarchy(tree);
+}
+
 BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
 {
   arma::mat dataset = arma::randu<arma::mat>(3, 1000);
@@ -122,6 +122,183 @@ BOOST_AUTO_TEST_CASE(SequenceClassificationTest)
   BOOST_REQUIRE_LE(classificationError, 0.2);
 }
 
+/**
+ * Pad each sequence (column) of the given input with zeros after its length.
+ */
+void PadSequences(arma::mat& input, const arma::Row<size_t>& lengths)
+{
+  for (size_t i = 0; i < input.n_cols; i++)
+  {
+    if (lengths[i] < input.n_rows)
+      input.submat(lengths[i], i, input.n_rows - 1, i).zeros();
+  }
+}
+
+/**
+ * Compute the objective and gradient of the given network for a batch of
+ * padded sequences, and the sums of the objectives and gradients of the single
+ * sequences without their padding, with the given window of backpropagation
+ * through time.
+ */
+template<typename NetworkType, typename OptimizerType>
+void SequenceGradients(NetworkType& net,
+                       OptimizerType& opt,
+                       const arma::mat& input,
+                       const arma::mat& labels,
+                       const arma::Row<size_t>& lengths,
+                       const size_t bpttSteps,
+                       double& batchObjective,
+                       arma::mat& batchGradient,
+                       double& objective,
+                       arma::mat& gradient)
+{
+  net.BPTTSteps() = bpttSteps;
+
+  net.SequenceLengths() = lengths;
+  net.Train(input, labels, opt);
+
+  batchGradient.reset();
+  net.Gradient(net.Parameters(), 0, batchGradient, input.n_cols);
+  batchObjective = net.Evaluate(net.Parameters(), 0, input.n_cols, true);
+
+  objective = 0;
+  gradient = arma::zeros<arma::mat>(batchGradient.n_rows,
+      batchGradient.n_cols);
+  arma::mat sequenceGradient;
+
+  net.SequenceLengths().reset();
+  for (size_t i = 0; i < input.n_cols; i++)
+  {
+    net.Train(arma::mat(input.submat(0, i, lengths[i] - 1, i)),
+        arma::mat(labels.col(i)), opt);
+
+    net.Gradient(net.Parameters(), 0, sequenceGradient);
+    gradient += sequenceGradient;
+    objective += net.Evaluate(net.Parameters(), 0);
+  }
+}
+
+/**
+ * Make sure that the given gradients are the same.
+ */
+void CheckGradients(const arma::mat& gradient, const arma::mat& reference)
+{
+  BOOST_REQUIRE_EQUAL(gradient.n_elem, reference.n_elem);
+  for (size_t i = 0; i < reference.n_elem; i++)
+  {
+    if (std::abs(reference[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(gradient[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(gradient[i], reference[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the objective and gradient of a batch of padded sequences are
+ * the sums over the single sequences, and that truncating backpropagation
+ * through time doesn't change the objective.
+ */
+BOOST_AUTO_TEST_CASE(BatchSequenceGradientTest)
+{
+  // Generate 4 (2 * 2) noisy sines with 10 points; the second and third sine
+  // are shorter and padded with zeros.
+  arma::mat input, labels;
+  GenerateNoisySines(input, labels, 10, 2);
+
+  arma::Row<size_t> lengths;
+  lengths << 10 << 6 << 8 << 10;
+  PadSequences(input, lengths);
+
+  LinearLayer<> linearLayer0(1, 4);
+  RecurrentLayer<> recurrentLayer0(4);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+
+  LinearLayer<> hiddenLayer(4, 2);
+  BaseLayer<LogisticFunction> hiddenBaseLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(linearLayer0, recurrentLayer0, inputBaseLayer,
+                          hiddenLayer, hiddenBaseLayer);
+
+  RNN<decltype(modules), BinaryClassificationLayer, RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  // With a step size of zero, training only sets the sequences.
+  SGD<decltype(net)> opt(net, 0, 1, -100);
+
+  double batchObjective, objective;
+  arma::mat batchGradient, gradient;
+  SequenceGradients(net, opt, input, labels, lengths, 0, batchObjective,
+      batchGradient, objective, gradient);
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  CheckGradients(batchGradient, gradient);
+
+  double truncatedBatchObjective, truncatedObjective;
+  SequenceGradients(net, opt, input, labels, lengths, 3,
+      truncatedBatchObjective, batchGradient, truncatedObjective, gradient);
+  BOOST_REQUIRE_CLOSE(truncatedBatchObjective, batchObjective, 1e-5);
+  BOOST_REQUIRE_CLOSE(truncatedObjective, objective, 1e-5);
+}
+
+/**
+ * Make sure that the gradient of an LSTM network for a batch of padded
+ * sequences is the sum of the gradients of the single sequences, with full
+ * and with truncated backpropagation through time, and that a window as long
+ * as the sequences gives the gradient of full backpropagation through time.
+ */
+BOOST_AUTO_TEST_CASE(LSTMBatchSequenceGradientTest)
+{
+  // Generate 6 (2 * 3) noisy sines with 10 points; some of them are shorter
+  // and padded with zeros.
+  arma::mat input, labels;
+  GenerateNoisySines(input, labels, 10, 3);
+
+  arma::Row<size_t> lengths;
+  lengths << 10 << 4 << 7 << 10 << 9 << 5;
+  PadSequences(input, lengths);
+
+  const size_t lstmSize = 4 * 5;
+  LinearLayer<> linearLayer0(1, lstmSize);
+  RecurrentLayer<> recurrentLayer0(5, lstmSize);
+  LSTMLayer<> lstmLayer0(5);
+
+  LinearLayer<> hiddenLayer(5, 2);
+  BaseLayer<LogisticFunction> hiddenBaseLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(linearLayer0, recurrentLayer0, lstmLayer0,
+                          hiddenLayer, hiddenBaseLayer);
+
+  RNN<decltype(modules), BinaryClassificationLayer, RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  // With a step size of zero, training only sets the sequences.
+  SGD<decltype(net)> opt(net, 0, 1, -100);
+
+  // Full backpropagation through time.
+  double batchObjective, objective;
+  arma::mat fullBatchGradient, gradient;
+  SequenceGradients(net, opt, input, labels, lengths, 0, batchObjective,
+      fullBatchGradient, objective, gradient);
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  CheckGradients(fullBatchGradient, gradient);
+
+  // Truncated backpropagation through time; the windows of each sequence
+  // start at the same steps on their own as in the batch.
+  arma::mat batchGradient;
+  SequenceGradients(net, opt, input, labels, lengths, 3, batchObjective,
+      batchGradient, objective, gradient);
+  CheckGradients(batchGradient, gradient);
+
+  // A window of the length of the sequences doesn't truncate anything.
+  SequenceGradients(net, opt, input, labels, lengths, input.n_rows,
+      batchObjective, batchGradient, objective, gradient);
+  CheckGradients(batchGradient, gradient);
+  CheckGradients(batchGradient, fullBatchGradient);
+}
+
 /**
  * Generate a random Reber grammar.
  *
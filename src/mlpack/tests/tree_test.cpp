@@ -1430,6 +1430,40 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that kd-trees and ball trees built on float data hold float bounds,
+ * and that the trees are still valid.
+ */
+BOOST_AUTO_TEST_CASE(FloatTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::fmat> KDTreeType;
+  typedef BallTree<EuclideanDistance, EmptyStatistic, arma::fmat>
+      BallTreeType;
+
+  BOOST_REQUIRE((std::is_same<KDTreeType::TreeBoundType,
+      HRectBound<EuclideanDistance, float>>::value));
+  BOOST_REQUIRE((std::is_same<BallTreeType::TreeBoundType,
+      BallBound<EuclideanDistance, arma::fvec>>::value));
+
+  arma::fmat dataset(5, 2000);
+  dataset.randu();
+
+  std::vector<size_t> oldFromNew;
+  KDTreeType kdTree(dataset, oldFromNew);
+  BOOST_REQUIRE_EQUAL(kdTree.NumDescendants(), dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      BOOST_REQUIRE_EQUAL(kdTree.Dataset()(j, i), dataset(j, oldFromNew[i]));
+  BOOST_REQUIRE(CheckPointBounds(kdTree));
+
+  BallTreeType ballTree(dataset, oldFromNew);
+  BOOST_REQUIRE_EQUAL(ballTree.NumDescendants(), dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      BOOST_REQUIRE_EQUAL(ballTree.Dataset()(j, i), dataset(j, oldFromNew[i]));
+  CheckPointBounds(ballTree);
+}
+
 template<typename MetricType>
 bool DoBoundsIntersect(HRectBound<MetricType>& a,
                        HRectBound<MetricType>& b)
@@ -1567,6 +1601,112 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.ParentDistance(), b.ParentDistance());
+  BOOST_REQUIRE_EQUAL(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance());
+
+  for (size_t i = 0; i < a.Bound().Dim(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(a.Bound()[i].Lo(), b.Bound()[i].Lo());
+    BOOST_REQUIRE_EQUAL(a.Bound()[i].Hi(), b.Bound()[i].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a tree built with many threads is exactly the same as a tree
+ * built with one thread.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeParallelBuildTest)
+{
+  arma::mat dataset(4, 100000);
+  dataset.randu();
+
+  typedef BinarySpaceTree<EuclideanDistance> TreeType;
+
+  #ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialTree(dataset, serialOldFromNew);
+
+  #ifdef _OPENMP
+  omp_set_num_threads(std::max(threads, 4));
+  #endif
+
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew);
+
+  #ifdef _OPENMP
+  omp_set_num_threads(threads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(serialOldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < serialOldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(serialOldFromNew[i], parallelOldFromNew[i]);
+
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(serialTree.Dataset()[i], parallelTree.Dataset()[i]);
+
+  CheckSameTree(serialTree, parallelTree);
+}
+
+/**
+ * Make sure that compacting a tree keeps its structure, and that siblings end up
+ * next to each other in memory.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactTest)
+{
+  arma::mat dataset(4, 1000);
+  dataset.randu();
+
+  typedef BinarySpaceTree<EuclideanDistance> TreeType;
+
+  TreeType tree(dataset);
+  TreeType compactTree(tree);
+  compactTree.Compact();
+
+  BOOST_REQUIRE(!tree.IsCompact());
+  BOOST_REQUIRE(compactTree.IsCompact());
+  CheckSameTree(tree, compactTree);
+
+  std::queue<TreeType*> nodeQueue;
+  nodeQueue.push(&compactTree);
+  while (!nodeQueue.empty())
+  {
+    TreeType* node = nodeQueue.front();
+    nodeQueue.pop();
+
+    if (node->IsLeaf())
+      continue;
+
+    BOOST_REQUIRE_EQUAL(node->Left() + 1, node->Right());
+    BOOST_REQUIRE_EQUAL(node->Left()->Parent(), node);
+    BOOST_REQUIRE_EQUAL(node->Right()->Parent(), node);
+    nodeQueue.push(node->Left());
+    nodeQueue.push(node->Right());
+  }
+
+  // Compacting again and moving the tree should be safe.
+  compactTree.Compact();
+  CheckSameTree(tree, compactTree);
+
+  TreeType movedTree(std::move(compactTree));
+  BOOST_REQUIRE(movedTree.IsCompact());
+  BOOST_REQUIRE(!compactTree.IsCompact());
+  BOOST_REQUIRE_EQUAL(movedTree.NumChildren(), 2);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {